@@ -5,4 +5,9 @@ endif()
 
 if(NOT TARGET ez::meta)
 	find_dependency(ez-meta CONFIG)
+endif()
+
+# Only ez::math-threads links it, so it is not required
+if(NOT TARGET Threads::Threads)
+	find_package(Threads QUIET)
 endif()
\ No newline at end of file
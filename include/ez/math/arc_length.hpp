@@ -0,0 +1,200 @@
+#pragma once
+#include <cstddef>
+#include <cassert>
+#include <cmath>
+#include <vector>
+#include <algorithm>
+#include <type_traits>
+#include <glm/geometric.hpp>
+#include "poly.hpp"
+
+namespace ez {
+	namespace intern {
+		// The speed along a curve, from its derivative. Scalar curves, like poly::Polynomial, move along a line.
+		template<typename V>
+		auto speedOf(const V& derivative) noexcept {
+			if constexpr (std::is_arithmetic_v<V>) {
+				return std::abs(derivative);
+			}
+			else {
+				return glm::length(derivative);
+			}
+		}
+
+		// Five point gauss legendre quadrature on [-1, 1], exact for polynomials up to degree 9
+		static constexpr double gaussNodes[] = { -0.9061798459386640, -0.5384693101056831, 0.0, 0.5384693101056831, 0.9061798459386640 };
+		static constexpr double gaussWeights[] = { 0.2369268850561891, 0.4786286704993665, 0.5688888888888889, 0.4786286704993665, 0.2369268850561891 };
+	};
+
+	/*
+		Table of arc length along a curve, or a spline of several curves, for moving a given distance along it.
+
+		Each segment is split into equal steps of its parameter, with the length of every step found by gauss legendre quadrature
+		over the segment's derivativeAt, so any curve type providing derivativeAt(t) works, such as bezier::Curve and poly::Polynomial.
+		The speed is stored at every step as well. A distance is found by binary search, over the segments and then over the steps
+		within one, and the parameter between two steps is a cubic hermite interpolation using the speed at each end as the slope.
+
+		The interpolation error falls with the fourth power of the step, doubling the samples cuts it about sixteen fold.
+
+		Changing one segment of a spline only integrates that segment again.
+	*/
+	template<typename T>
+	class ArcLengthTable {
+	public:
+		static_assert(std::is_floating_point_v<T>, "ez::ArcLengthTable requires floating point types!");
+
+		// A position along the spline, the index of a segment and the parameter within it
+		struct Location {
+			std::size_t segment;
+			T t;
+		};
+
+		// samples is the number of steps each segment is split into
+		explicit ArcLengthTable(std::size_t samples = 16)
+			: samples_(std::max(samples, std::size_t(1)))
+			, offsets_(1, T(0))
+		{}
+
+		template<typename Curve>
+		ArcLengthTable(const Curve* curves, std::size_t count, std::size_t samples = 16)
+			: ArcLengthTable(samples)
+		{
+			build(curves, count);
+		}
+
+		// Integrate count segments, replacing the contents of the table
+		template<typename Curve>
+		void build(const Curve* curves, std::size_t count) {
+			lengths_.resize(count * (samples_ + 1));
+			speeds_.resize(lengths_.size());
+			offsets_.resize(count + 1);
+
+			for (std::size_t i = 0; i < count; ++i) {
+				integrate(i, curves[i]);
+			}
+			accumulate(0);
+		}
+		template<typename Curve>
+		void build(const Curve& curve) {
+			build(&curve, 1);
+		}
+
+		// Integrate one segment again after it changed, the others are kept
+		template<typename Curve>
+		void update(std::size_t segment, const Curve& curve) {
+			assert(segment < segments());
+			integrate(segment, curve);
+			accumulate(segment);
+		}
+
+		std::size_t segments() const noexcept {
+			return offsets_.size() - 1;
+		}
+		std::size_t samples() const noexcept {
+			return samples_;
+		}
+
+		// The length of the whole spline
+		T length() const noexcept {
+			return offsets_.back();
+		}
+		// The length of one segment
+		T length(std::size_t segment) const noexcept {
+			return offsets_[segment + 1] - offsets_[segment];
+		}
+
+		// The distance from the start of the spline to t on the given segment
+		T distance(std::size_t segment, T t) const noexcept {
+			const T* lengths = lengths_.data() + segment * (samples_ + 1);
+			const T* speeds = speeds_.data() + segment * (samples_ + 1);
+
+			T x = std::min(std::max(t, T(0)), T(1)) * T(samples_);
+			std::size_t i = std::min(std::size_t(x), samples_ - 1);
+			T u = x - T(i);
+			T step = T(1) / T(samples_);
+
+			// Hermite interpolation of distance over the parameter, the speeds are the slopes
+			T u2 = u * u, u3 = u2 * u;
+			T local = lengths[i]
+				+ (u3 - T(2) * u2 + u) * speeds[i] * step
+				+ (T(3) * u2 - T(2) * u3) * (lengths[i + 1] - lengths[i])
+				+ (u3 - u2) * speeds[i + 1] * step;
+			return offsets_[segment] + local;
+		}
+
+		// The position at a distance from the start of the spline, clamped to its ends. O(log n) in the size of the table.
+		Location locate(T distance) const noexcept {
+			std::size_t count = segments();
+			if (count == 0) {
+				return Location{ 0, T(0) };
+			}
+
+			// The last segment that starts at or before the distance
+			std::size_t segment = std::size_t(std::upper_bound(offsets_.begin() + 1, offsets_.end() - 1, distance) - (offsets_.begin() + 1));
+			T local = std::min(std::max(distance - offsets_[segment], T(0)), length(segment));
+
+			const T* lengths = lengths_.data() + segment * (samples_ + 1);
+			const T* speeds = speeds_.data() + segment * (samples_ + 1);
+			std::size_t i = std::size_t(std::upper_bound(lengths + 1, lengths + samples_, local) - (lengths + 1));
+
+			T step = T(1) / T(samples_);
+			T t0 = T(i) * step;
+			T span = lengths[i + 1] - lengths[i];
+			if (!(span > T(0))) {
+				return Location{ segment, t0 };
+			}
+
+			// Hermite interpolation of the parameter over distance. The slopes are the inverse of the speeds,
+			// limited to three times the secant, which keeps the result increasing even where the speed drops to zero at a cusp.
+			T u = (local - lengths[i]) / span;
+			T m0 = std::min(span / speeds[i], T(3) * step);
+			T m1 = std::min(span / speeds[i + 1], T(3) * step);
+
+			T u2 = u * u, u3 = u2 * u;
+			T t = t0
+				+ (u3 - T(2) * u2 + u) * m0
+				+ (T(3) * u2 - T(2) * u3) * step
+				+ (u3 - u2) * m1;
+			return Location{ segment, std::min(std::max(t, t0), t0 + step) };
+		}
+
+	private:
+		template<typename Curve>
+		void integrate(std::size_t segment, const Curve& curve) {
+			T* lengths = lengths_.data() + segment * (samples_ + 1);
+			T* speeds = speeds_.data() + segment * (samples_ + 1);
+			T step = T(1) / T(samples_);
+			T half = step / T(2);
+
+			lengths[0] = T(0);
+			speeds[0] = T(intern::speedOf(curve.derivativeAt(T(0))));
+
+			T sum = T(0);
+			for (std::size_t i = 0; i < samples_; ++i) {
+				T mid = (T(i) + T(0.5)) * step;
+				T part = T(0);
+				for (int j = 0; j < 5; ++j) {
+					part += T(intern::gaussWeights[j]) * T(intern::speedOf(curve.derivativeAt(mid + half * T(intern::gaussNodes[j]))));
+				}
+				sum += part * half;
+
+				lengths[i + 1] = sum;
+				speeds[i + 1] = T(intern::speedOf(curve.derivativeAt(T(i + 1) * step)));
+			}
+		}
+
+		// Recompute the start of every segment after the first changed one
+		void accumulate(std::size_t first) noexcept {
+			for (std::size_t i = first; i + 1 < offsets_.size(); ++i) {
+				offsets_[i + 1] = offsets_[i] + lengths_[i * (samples_ + 1) + samples_];
+			}
+		}
+
+		std::size_t samples_;
+		// Per segment, samples_ + 1 entries each, the distance from the start of the segment and the speed at every step
+		std::vector<T> lengths_;
+		std::vector<T> speeds_;
+		// The distance to the start of each segment, and the total length at the end
+		std::vector<T> offsets_;
+	};
+};
\ No newline at end of file
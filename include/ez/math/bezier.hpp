@@ -0,0 +1,552 @@
+#pragma once
+#include <cinttypes>
+#include <cstddef>
+#include <cmath>
+#include <array>
+#include <vector>
+#include <limits>
+#include <utility>
+#include <algorithm>
+#include <type_traits>
+#include <glm/vec2.hpp>
+#include <glm/vec3.hpp>
+#include <glm/common.hpp>
+#include <glm/geometric.hpp>
+#include "poly.hpp"
+
+/*
+	Bezier curves of any degree in 2D or 3D, on glm vectors, with conversion to the power basis used by ez::poly.
+	The quadratic and cubic curves that paths are made of take the closed form paths through the poly solvers,
+	higher degrees fall back to Polynomial.
+*/
+
+namespace ez::bezier {
+	// Axis aligned bounding box
+	template<glm::length_t L, typename T>
+	struct Bounds {
+		using vec_t = glm::vec<L, T>;
+
+		vec_t min;
+		vec_t max;
+
+		void expand(const vec_t& point) noexcept {
+			min = glm::min(min, point);
+			max = glm::max(max, point);
+		}
+		void expand(const Bounds& other) noexcept {
+			min = glm::min(min, other.min);
+			max = glm::max(max, other.max);
+		}
+
+		bool overlaps(const Bounds& other) const noexcept {
+			for (glm::length_t i = 0; i < L; ++i) {
+				if (max[i] < other.min[i] || other.max[i] < min[i]) {
+					return false;
+				}
+			}
+			return true;
+		}
+
+		// The largest side
+		T extent() const noexcept {
+			T largest = T(0);
+			for (glm::length_t i = 0; i < L; ++i) {
+				largest = std::max(largest, max[i] - min[i]);
+			}
+			return largest;
+		}
+	};
+
+	namespace intern {
+		constexpr std::size_t binomial(std::size_t n, std::size_t k) noexcept {
+			std::size_t result = 1;
+			for (std::size_t i = 1; i <= k; ++i) {
+				result = result * (n - k + i) / i;
+			}
+			return result;
+		}
+
+		// The matrix taking the control points to the power basis, c[k] = sum of basis[k][i] * p[i]
+		template<typename T, std::size_t N>
+		constexpr std::array<std::array<T, N + 1>, N + 1> powerBasisMatrix() noexcept {
+			std::array<std::array<T, N + 1>, N + 1> result{};
+			for (std::size_t k = 0; k <= N; ++k) {
+				for (std::size_t i = 0; i <= k; ++i) {
+					T factor = T(binomial(N, k) * binomial(k, i));
+					result[k][i] = (k - i) % 2 == 0 ? factor : -factor;
+				}
+			}
+			return result;
+		}
+
+		// Its inverse, p[i] = sum of basis[i][k] * c[k]
+		template<typename T, std::size_t N>
+		constexpr std::array<std::array<T, N + 1>, N + 1> controlPointMatrix() noexcept {
+			std::array<std::array<T, N + 1>, N + 1> result{};
+			for (std::size_t i = 0; i <= N; ++i) {
+				for (std::size_t k = 0; k <= i; ++k) {
+					result[i][k] = T(binomial(i, k)) / T(binomial(N, k));
+				}
+			}
+			return result;
+		}
+
+		// Curves are never split into more line segments than this when flattening
+		static constexpr std::uint32_t maxSegments = 1 << 16;
+	};
+
+	/*
+		Bezier curve of degree N, with N + 1 control points. The curve starts at the first point and ends at the last.
+
+		Points are evaluated with de casteljau's algorithm, so the ends are exact. Flattening evaluates the power basis
+		instead, which is cheaper for the many points along a single curve.
+	*/
+	template<glm::length_t L, typename T, std::size_t N>
+	struct Curve {
+		static_assert(std::is_floating_point_v<T>, "ez::bezier::Curve requires floating point types!");
+		static_assert(L == 2 || L == 3, "ez::bezier::Curve requires 2 or 3 dimensions!");
+
+		using vec_t = glm::vec<L, T>;
+		using value_type = T;
+		static constexpr std::size_t degree = N;
+
+		std::array<vec_t, N + 1> points;
+
+		vec_t& operator[](std::size_t index) noexcept {
+			return points[index];
+		}
+		const vec_t& operator[](std::size_t index) const noexcept {
+			return points[index];
+		}
+
+		// The point at t, de casteljau's algorithm
+		vec_t operator()(T t) const noexcept {
+			std::array<vec_t, N + 1> work = points;
+			for (std::size_t k = N; k > 0; --k) {
+				for (std::size_t i = 0; i < k; ++i) {
+					work[i] = glm::mix(work[i], work[i + 1], t);
+				}
+			}
+			return work[0];
+		}
+
+		// The hodograph, the curve of the first derivative
+		Curve<L, T, (N > 0 ? N - 1 : 0)> derivative() const noexcept {
+			Curve<L, T, (N > 0 ? N - 1 : 0)> result;
+			if constexpr (N == 0) {
+				result.points[0] = vec_t(T(0));
+			}
+			else {
+				for (std::size_t i = 0; i < N; ++i) {
+					result.points[i] = T(N) * (points[i + 1] - points[i]);
+				}
+			}
+			return result;
+		}
+
+		// The first derivative at t, the direction of travel scaled by the speed
+		vec_t derivativeAt(T t) const noexcept {
+			return derivative()(t);
+		}
+
+		// The same curve as degree N + 1
+		Curve<L, T, N + 1> elevate() const noexcept {
+			Curve<L, T, N + 1> result;
+			result.points[0] = points[0];
+			result.points[N + 1] = points[N];
+			for (std::size_t i = 1; i <= N; ++i) {
+				T f = T(i) / T(N + 1);
+				result.points[i] = f * points[i - 1] + (T(1) - f) * points[i];
+			}
+			return result;
+		}
+
+		// The coefficients of the power basis, c[0] + c[1] * t + ... + c[N] * t^N, lowest power first like ez::poly::Polynomial
+		std::array<vec_t, N + 1> powerBasis() const noexcept {
+			constexpr std::array<std::array<T, N + 1>, N + 1> basis = intern::powerBasisMatrix<T, N>();
+
+			std::array<vec_t, N + 1> result;
+			for (std::size_t k = 0; k <= N; ++k) {
+				result[k] = basis[k][0] * points[0];
+				for (std::size_t i = 1; i <= k; ++i) {
+					result[k] += basis[k][i] * points[i];
+				}
+			}
+			return result;
+		}
+
+		// The inverse of powerBasis
+		static Curve fromPowerBasis(const std::array<vec_t, N + 1>& coefficients) noexcept {
+			constexpr std::array<std::array<T, N + 1>, N + 1> basis = intern::controlPointMatrix<T, N>();
+
+			Curve result;
+			for (std::size_t i = 0; i <= N; ++i) {
+				result.points[i] = basis[i][0] * coefficients[0];
+				for (std::size_t k = 1; k <= i; ++k) {
+					result.points[i] += basis[i][k] * coefficients[k];
+				}
+			}
+			return result;
+		}
+
+		// One coordinate of the curve as a polynomial in t
+		poly::Polynomial<T, N> polynomial(glm::length_t axis) const noexcept {
+			std::array<vec_t, N + 1> basis = powerBasis();
+			poly::Polynomial<T, N> result;
+			for (std::size_t k = 0; k <= N; ++k) {
+				result.coefficients[k] = basis[k][axis];
+			}
+			return result;
+		}
+
+		// Split at t with de casteljau's algorithm, the first curve covering [0, t] and the second [t, 1]
+		std::pair<Curve, Curve> split(T t) const noexcept {
+			std::pair<Curve, Curve> result;
+			std::array<vec_t, N + 1> work = points;
+			result.first.points[0] = work[0];
+			result.second.points[N] = work[N];
+
+			for (std::size_t k = 1; k <= N; ++k) {
+				for (std::size_t i = 0; i <= N - k; ++i) {
+					work[i] = glm::mix(work[i], work[i + 1], t);
+				}
+				result.first.points[k] = work[0];
+				result.second.points[N - k] = work[N - k];
+			}
+			return result;
+		}
+
+		// The part of the curve between t0 and t1, reparameterized to [0, 1]
+		Curve segment(T t0, T t1) const noexcept {
+			if (!(t1 > T(0))) {
+				Curve result;
+				result.points.fill(points[0]);
+				return result;
+			}
+			Curve head = split(t1).first;
+			return head.split(t0 / t1).second;
+		}
+
+		// The bounds of the control points, which always contain the curve
+		Bounds<L, T> hull() const noexcept {
+			Bounds<L, T> result{ points[0], points[0] };
+			for (std::size_t i = 1; i <= N; ++i) {
+				result.expand(points[i]);
+			}
+			return result;
+		}
+
+		// The smallest box containing the curve, from the ends and the points where the derivative of a coordinate is zero
+		Bounds<L, T> bounds() const noexcept {
+			Bounds<L, T> result{ glm::min(points[0], points[N]), glm::max(points[0], points[N]) };
+			if constexpr (N >= 2) {
+				std::array<vec_t, N + 1> c = powerBasis();
+
+				for (glm::length_t axis = 0; axis < L; ++axis) {
+					// When the control points are within the ends, so is the curve
+					bool inside = true;
+					for (std::size_t i = 1; i < N; ++i) {
+						inside = inside && points[i][axis] >= result.min[axis] && points[i][axis] <= result.max[axis];
+					}
+					if (inside) {
+						continue;
+					}
+
+					std::array<T, N - 1> roots;
+					int count = 0;
+					if constexpr (N == 2) {
+						// 2 * c2 * t + c1 = 0
+						T t = -c[1][axis] / (T(2) * c[2][axis]);
+						if (t > T(0) && t < T(1)) {
+							roots[count++] = t;
+						}
+					}
+					else if constexpr (N == 3) {
+						count = poly::solveQuadraticInRange(T(3) * c[3][axis], T(2) * c[2][axis], c[1][axis], T(0), T(1), roots.begin());
+					}
+					else {
+						count = polynomial(axis).derivative().solveInRange(T(0), T(1), roots.begin());
+					}
+
+					for (int i = 0; i < count; ++i) {
+						T value = c[N][axis];
+						for (std::size_t k = N; k-- > 0;) {
+							value = value * roots[i] + c[k][axis];
+						}
+						result.min[axis] = std::min(result.min[axis], value);
+						result.max[axis] = std::max(result.max[axis], value);
+					}
+				}
+			}
+			return result;
+		}
+
+		// The number of equal steps in t that keeps every line segment within tolerance of the curve, by wang's formula.
+		// The count adapts to how sharply the curve bends, a straight curve needs a single segment.
+		std::uint32_t segments(T tolerance) const noexcept {
+			if constexpr (N < 2) {
+				return 1;
+			}
+			else {
+				// The largest second difference bounds the second derivative
+				T largest = T(0);
+				for (std::size_t i = 0; i + 2 <= N; ++i) {
+					largest = std::max(largest, glm::length(points[i] - T(2) * points[i + 1] + points[i + 2]));
+				}
+				T count = std::ceil(std::sqrt(T(N * (N - 1)) * largest / (T(8) * tolerance)));
+				if (!(count < T(intern::maxSegments))) {
+					// Also catches a zero or nan tolerance
+					return count >= T(1) ? intern::maxSegments : 1;
+				}
+				return std::max(std::uint32_t(count), std::uint32_t(1));
+			}
+		}
+
+		// Write the end points of the line segments approximating the curve to within tolerance, returning the number written.
+		// The start point is not written, so the curves of a path chain together without repeated points.
+		template<typename output_iter>
+		std::uint32_t flatten(T tolerance, output_iter output) const {
+			static_assert(is_output_iterator_v<output_iter>, "ez::bezier::Curve::flatten requires the iterator passed in to be an output iterator.");
+			static_assert(is_iterator_writable_v<output_iter, vec_t>, "ez::bezier::Curve::flatten cannot convert type to iterator value_type!");
+
+			std::uint32_t count = segments(tolerance);
+			std::array<vec_t, N + 1> c = powerBasis();
+			T step = T(1) / T(count);
+
+			for (std::uint32_t i = 1; i < count; ++i) {
+				T t = T(i) * step;
+				vec_t point = c[N];
+				for (std::size_t k = N; k-- > 0;) {
+					point = point * t + c[k];
+				}
+				*output++ = point;
+			}
+			*output++ = points[N];
+			return count;
+		}
+	};
+
+	template<glm::length_t L, typename T>
+	using Linear = Curve<L, T, 1>;
+	template<glm::length_t L, typename T>
+	using Quadratic = Curve<L, T, 2>;
+	template<glm::length_t L, typename T>
+	using Cubic = Curve<L, T, 3>;
+
+	using Quadratic2 = Quadratic<2, float>;
+	using Quadratic3 = Quadratic<3, float>;
+	using Cubic2 = Cubic<2, float>;
+	using Cubic3 = Cubic<3, float>;
+
+	// Write the values of t where the curve crosses the infinite line through a and b, in ascending order, returning the number written.
+	// A curve lying along the line has no crossings.
+	template<typename T, std::size_t N, typename output_iter>
+	int intersect(const Curve<2, T, N>& curve, const glm::vec<2, T>& a, const glm::vec<2, T>& b, output_iter output) {
+		static_assert(is_output_iterator_v<output_iter>, "ez::bezier::intersect requires the iterator passed in to be an output iterator.");
+		static_assert(is_iterator_writable_v<output_iter, T>, "ez::bezier::intersect cannot convert type to iterator value_type!");
+
+		// The signed distance from the line, scaled by its length, as a polynomial in t
+		glm::vec<2, T> normal{ a.y - b.y, b.x - a.x };
+		std::array<glm::vec<2, T>, N + 1> c = curve.powerBasis();
+		poly::Polynomial<T, N> distance;
+		for (std::size_t k = 0; k <= N; ++k) {
+			distance.coefficients[k] = glm::dot(normal, c[k]);
+		}
+		distance.coefficients[0] -= glm::dot(normal, a);
+
+		if constexpr (N == 1) {
+			if (distance[1] == T(0)) {
+				return 0;
+			}
+			T t = -distance[0] / distance[1];
+			if (t >= T(0) && t <= T(1)) {
+				*output++ = t;
+				return 1;
+			}
+			return 0;
+		}
+		else if constexpr (N == 2) {
+			return poly::solveQuadraticInRange(distance[2], distance[1], distance[0], T(0), T(1), output);
+		}
+		else if constexpr (N == 3) {
+			return poly::solveCubicInRange(distance[3], distance[2], distance[1], distance[0], T(0), T(1), output);
+		}
+		else {
+			return distance.solveInRange(T(0), T(1), output);
+		}
+	}
+
+	namespace intern {
+		// A candidate intersection, the ranges of the two curves that are still within the leaf size of each other
+		template<typename T>
+		struct Crossing {
+			T s0, s1, t0, t1;
+		};
+
+		// Newton's method on a(s) - b(t) = 0, keeping the estimate when it does not converge inside the range
+		template<typename T, std::size_t N, std::size_t M>
+		glm::vec<2, T> refineCrossing(const Curve<2, T, N>& a, const Curve<2, T, M>& b, const Crossing<T>& range) noexcept {
+			using vec_t = glm::vec<2, T>;
+			auto da = a.derivative();
+			auto db = b.derivative();
+
+			T s = (range.s0 + range.s1) / T(2);
+			T t = (range.t0 + range.t1) / T(2);
+			vec_t f = a(s) - b(t);
+			vec_t estimate{ s, t };
+			T error = glm::dot(f, f);
+
+			for (int i = 0; i < 8 && error > T(0); ++i) {
+				vec_t ds = da(s), dt = db(t);
+				T det = dt.x * ds.y - ds.x * dt.y;
+				if (det == T(0)) {
+					break;
+				}
+				s -= (dt.x * f.y - dt.y * f.x) / det;
+				t -= (ds.x * f.y - ds.y * f.x) / det;
+				if (!(s >= T(0) && s <= T(1) && t >= T(0) && t <= T(1))) {
+					break;
+				}
+
+				f = a(s) - b(t);
+				T next = glm::dot(f, f);
+				if (next < error) {
+					error = next;
+					estimate = vec_t{ s, t };
+				}
+			}
+			return estimate;
+		}
+	};
+
+	/*
+		Write the pairs (s, t) where a(s) == b(t), with x the parameter on the first curve and y on the second,
+		ordered by s, returning the number written. At most N * M pairs are written.
+
+		Both curves are subdivided until the bounds of their control points stop overlapping,
+		or the pieces are smaller than sqrt(epsilon) of the size of the curves. Touching pieces are merged,
+		so a tangent crossing is found once, and each is then refined with newton's method.
+		Curves that overlap along a stretch report points from the overlap rather than all of it.
+	*/
+	template<typename T, std::size_t N, std::size_t M, typename output_iter>
+	int intersect(const Curve<2, T, N>& a, const Curve<2, T, M>& b, output_iter output) {
+		static_assert(is_output_iterator_v<output_iter>, "ez::bezier::intersect requires the iterator passed in to be an output iterator.");
+		static_assert(is_iterator_writable_v<output_iter, glm::vec<2, T>>, "ez::bezier::intersect cannot convert type to iterator value_type!");
+
+		struct Piece {
+			Curve<2, T, N> a;
+			Curve<2, T, M> b;
+			intern::Crossing<T> range;
+		};
+
+		constexpr std::size_t capacity = std::max(N * M, std::size_t(1));
+		constexpr int maxTests = 1 << 14;
+
+		Bounds<2, T> hullA = a.hull(), hullB = b.hull();
+		if (!hullA.overlaps(hullB)) {
+			return 0;
+		}
+		Bounds<2, T> both = hullA;
+		both.expand(hullB);
+		T leaf = std::max(both.extent(), std::numeric_limits<T>::min()) * std::sqrt(std::numeric_limits<T>::epsilon());
+
+		std::array<intern::Crossing<T>, capacity> found;
+		std::size_t numFound = 0;
+
+		// Depth first, each step replaces one piece by two, so the stack only grows by one per level
+		std::array<Piece, 128> stack;
+		std::size_t size = 0;
+		stack[size++] = Piece{ a, b, { T(0), T(1), T(0), T(1) } };
+
+		for (int tests = 0; size > 0 && tests < maxTests; ++tests) {
+			Piece piece = stack[--size];
+			Bounds<2, T> boxA = piece.a.hull(), boxB = piece.b.hull();
+			if (!boxA.overlaps(boxB)) {
+				continue;
+			}
+
+			T extentA = boxA.extent(), extentB = boxB.extent();
+			if ((extentA <= leaf && extentB <= leaf) || size + 2 > stack.size()) {
+				// Merge into a crossing found already when the ranges touch
+				const intern::Crossing<T>& r = piece.range;
+				T padS = r.s1 - r.s0, padT = r.t1 - r.t0;
+				bool merged = false;
+				for (std::size_t i = 0; i < numFound && !merged; ++i) {
+					intern::Crossing<T>& other = found[i];
+					if (r.s0 - padS <= other.s1 && other.s0 <= r.s1 + padS && r.t0 - padT <= other.t1 && other.t0 <= r.t1 + padT) {
+						other.s0 = std::min(other.s0, r.s0);
+						other.s1 = std::max(other.s1, r.s1);
+						other.t0 = std::min(other.t0, r.t0);
+						other.t1 = std::max(other.t1, r.t1);
+						merged = true;
+					}
+				}
+				if (!merged && numFound < capacity) {
+					found[numFound++] = r;
+				}
+				continue;
+			}
+
+			// Split the larger of the two, the second half is pushed first so the search runs in order along it
+			const intern::Crossing<T>& r = piece.range;
+			if (extentA >= extentB) {
+				auto halves = piece.a.split(T(0.5));
+				T mid = (r.s0 + r.s1) / T(2);
+				stack[size++] = Piece{ halves.second, piece.b, { mid, r.s1, r.t0, r.t1 } };
+				stack[size++] = Piece{ halves.first, piece.b, { r.s0, mid, r.t0, r.t1 } };
+			}
+			else {
+				auto halves = piece.b.split(T(0.5));
+				T mid = (r.t0 + r.t1) / T(2);
+				stack[size++] = Piece{ piece.a, halves.second, { r.s0, r.s1, mid, r.t1 } };
+				stack[size++] = Piece{ piece.a, halves.first, { r.s0, r.s1, r.t0, mid } };
+			}
+		}
+
+		std::array<glm::vec<2, T>, capacity> results;
+		for (std::size_t i = 0; i < numFound; ++i) {
+			results[i] = intern::refineCrossing(a, b, found[i]);
+		}
+		std::sort(results.begin(), results.begin() + numFound, [](const glm::vec<2, T>& lh, const glm::vec<2, T>& rh) {
+			return lh.x < rh.x;
+		});
+		for (std::size_t i = 0; i < numFound; ++i) {
+			*output++ = results[i];
+		}
+		return int(numFound);
+	}
+
+	// The tight bounds of count curves
+	template<glm::length_t L, typename T, std::size_t N>
+	void bounds(const Curve<L, T, N>* curves, std::size_t count, Bounds<L, T>* output) noexcept {
+		for (std::size_t i = 0; i < count; ++i) {
+			output[i] = curves[i].bounds();
+		}
+	}
+
+	/*
+		Flatten a path of count curves, each starting where the previous one ends, to a polyline within tolerance of it.
+		The points are appended to the vector, the start of the first curve followed by the end of every line segment,
+		and the number appended is returned. The vector grows once, by the total found with wang's formula in a first pass.
+	*/
+	template<glm::length_t L, typename T, std::size_t N>
+	std::size_t flatten(const Curve<L, T, N>* curves, std::size_t count, T tolerance, std::vector<glm::vec<L, T>>& points) {
+		if (count == 0) {
+			return 0;
+		}
+
+		std::size_t total = 1;
+		for (std::size_t i = 0; i < count; ++i) {
+			total += curves[i].segments(tolerance);
+		}
+
+		std::size_t start = points.size();
+		points.resize(start + total);
+		glm::vec<L, T>* output = points.data() + start;
+		*output++ = curves[0].points[0];
+		for (std::size_t i = 0; i < count; ++i) {
+			output += curves[i].flatten(tolerance, output);
+		}
+		return total;
+	}
+};
\ No newline at end of file
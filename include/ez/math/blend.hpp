@@ -0,0 +1,241 @@
+#pragma once
+#include <cinttypes>
+#include <cstddef>
+#include <array>
+#include <algorithm>
+#include "color.hpp"
+#include "simd.hpp"
+
+/*
+	Compositing for arrays of premultiplied colors.
+	Works on both ColorU, using exact integer arithmetic, and floating point colors.
+*/
+
+namespace ez::color {
+	enum class BlendMode {
+		// Porter-Duff operators
+		Clear,
+		Source,
+		Destination,
+		Over,
+		DestinationOver,
+		In,
+		DestinationIn,
+		Out,
+		DestinationOut,
+		Atop,
+		DestinationAtop,
+		Xor,
+
+		// Separable blend modes, composited with source over
+		Multiply,
+		Screen,
+		Overlay,
+		// Sum of the source and destination, clamped to the maximum value
+		Add,
+	};
+
+	namespace intern {
+		// The blend equations are written as sums of products of two channels, and then scaled back into range once.
+		// For integers that means a single exactly rounded division by 255, so the result is always within half a step.
+		template<typename T, bool = std::is_floating_point_v<T>>
+		struct BlendMath {
+			using value_type = T;
+			static constexpr T one = T(1);
+
+			static T unit(T product) noexcept {
+				return product;
+			}
+		};
+
+		template<typename T>
+		struct BlendMath<T, false> {
+			static_assert(std::is_same_v<T, uint8_t>, "ez::color blending only supports 8 bit integer colors!");
+
+			using value_type = int;
+			static constexpr int one = 255;
+
+			// round(product / 255), clamped to the range of the channel
+			static int unit(int product) noexcept {
+				return std::min((std::max(product, 0) + 127) / 255, 255);
+			}
+		};
+
+		// Blend a single channel, cs and cb are the premultiplied source and destination values.
+		// Passing the alpha values as the channel gives the resulting alpha.
+		template<BlendMode Mode, typename Math, typename V>
+		V blendChannel(V cs, V as, V cb, V ab) noexcept {
+			constexpr V one = Math::one;
+
+			if constexpr (Mode == BlendMode::Clear) {
+				return V(0);
+			}
+			else if constexpr (Mode == BlendMode::Source) {
+				return cs;
+			}
+			else if constexpr (Mode == BlendMode::Destination) {
+				return cb;
+			}
+			else if constexpr (Mode == BlendMode::Over) {
+				return Math::unit(cs * one + cb * (one - as));
+			}
+			else if constexpr (Mode == BlendMode::DestinationOver) {
+				return Math::unit(cs * (one - ab) + cb * one);
+			}
+			else if constexpr (Mode == BlendMode::In) {
+				return Math::unit(cs * ab);
+			}
+			else if constexpr (Mode == BlendMode::DestinationIn) {
+				return Math::unit(cb * as);
+			}
+			else if constexpr (Mode == BlendMode::Out) {
+				return Math::unit(cs * (one - ab));
+			}
+			else if constexpr (Mode == BlendMode::DestinationOut) {
+				return Math::unit(cb * (one - as));
+			}
+			else if constexpr (Mode == BlendMode::Atop) {
+				return Math::unit(cs * ab + cb * (one - as));
+			}
+			else if constexpr (Mode == BlendMode::DestinationAtop) {
+				return Math::unit(cs * (one - ab) + cb * as);
+			}
+			else if constexpr (Mode == BlendMode::Xor) {
+				return Math::unit(cs * (one - ab) + cb * (one - as));
+			}
+			else if constexpr (Mode == BlendMode::Multiply) {
+				return Math::unit(cs * (one - ab) + cb * (one - as) + cs * cb);
+			}
+			else if constexpr (Mode == BlendMode::Screen) {
+				return Math::unit((cs + cb) * one - cs * cb);
+			}
+			else if constexpr (Mode == BlendMode::Overlay) {
+				V low = V(2) * cs * cb;
+				V high = as * ab - V(2) * (ab - cb) * (as - cs);
+				return Math::unit(cs * (one - ab) + cb * (one - as) + (V(2) * cb <= ab ? low : high));
+			}
+			else {
+				static_assert(Mode == BlendMode::Add, "Unhandled ez::color::BlendMode!");
+				return std::min(cs + cb, one);
+			}
+		}
+
+		template<BlendMode Mode, typename T>
+		void blendColors(const Color<T>* src, Color<T>* dst, std::size_t count) noexcept {
+			using Math = BlendMath<T>;
+			using V = typename Math::value_type;
+
+			EZ_MATH_VECTORIZE
+			for (std::size_t i = 0; i < count; ++i) {
+				V as = src[i].a;
+				V ab = dst[i].a;
+
+				dst[i].r = T(blendChannel<Mode, Math, V>(src[i].r, as, dst[i].r, ab));
+				dst[i].g = T(blendChannel<Mode, Math, V>(src[i].g, as, dst[i].g, ab));
+				dst[i].b = T(blendChannel<Mode, Math, V>(src[i].b, as, dst[i].b, ab));
+				dst[i].a = T(blendChannel<Mode, Math, V>(as, as, ab, ab));
+			}
+		}
+
+		// Reciprocals used to estimate the quotient for unpremultiplying, the estimate is corrected afterwards.
+		inline const std::array<float, 256>& reciprocalTable() noexcept {
+			static const std::array<float, 256> table = [] {
+				std::array<float, 256> result{};
+				for (int i = 1; i < 256; ++i) {
+					result[i] = 1.f / float(i);
+				}
+				return result;
+			}();
+			return table;
+		}
+	};
+
+	// Composites src onto dst, storing the result in dst. Both arrays hold premultiplied colors.
+	// For ColorU the result is the exactly rounded value of the blend equation.
+	template<typename T>
+	void blend(const Color<T>* src, Color<T>* dst, std::size_t count, BlendMode mode = BlendMode::Over) noexcept {
+		switch (mode) {
+		case BlendMode::Clear: intern::blendColors<BlendMode::Clear>(src, dst, count); break;
+		case BlendMode::Source: intern::blendColors<BlendMode::Source>(src, dst, count); break;
+		case BlendMode::Destination: break;
+		case BlendMode::Over: intern::blendColors<BlendMode::Over>(src, dst, count); break;
+		case BlendMode::DestinationOver: intern::blendColors<BlendMode::DestinationOver>(src, dst, count); break;
+		case BlendMode::In: intern::blendColors<BlendMode::In>(src, dst, count); break;
+		case BlendMode::DestinationIn: intern::blendColors<BlendMode::DestinationIn>(src, dst, count); break;
+		case BlendMode::Out: intern::blendColors<BlendMode::Out>(src, dst, count); break;
+		case BlendMode::DestinationOut: intern::blendColors<BlendMode::DestinationOut>(src, dst, count); break;
+		case BlendMode::Atop: intern::blendColors<BlendMode::Atop>(src, dst, count); break;
+		case BlendMode::DestinationAtop: intern::blendColors<BlendMode::DestinationAtop>(src, dst, count); break;
+		case BlendMode::Xor: intern::blendColors<BlendMode::Xor>(src, dst, count); break;
+		case BlendMode::Multiply: intern::blendColors<BlendMode::Multiply>(src, dst, count); break;
+		case BlendMode::Screen: intern::blendColors<BlendMode::Screen>(src, dst, count); break;
+		case BlendMode::Overlay: intern::blendColors<BlendMode::Overlay>(src, dst, count); break;
+		case BlendMode::Add: intern::blendColors<BlendMode::Add>(src, dst, count); break;
+		}
+	}
+
+	// Multiplies the color channels by alpha. src and dst may be the same array.
+	template<typename T>
+	void premultiply(const Color<T>* src, Color<T>* dst, std::size_t count) noexcept {
+		using Math = intern::BlendMath<T>;
+
+		EZ_MATH_VECTORIZE
+		for (std::size_t i = 0; i < count; ++i) {
+			T a = src[i].a;
+			dst[i].r = T(Math::unit(src[i].r * a));
+			dst[i].g = T(Math::unit(src[i].g * a));
+			dst[i].b = T(Math::unit(src[i].b * a));
+			dst[i].a = a;
+		}
+	}
+
+	// Divides the color channels by alpha, fully transparent colors become transparent black. src and dst may be the same array.
+	// For ColorU the result is exactly round(c * 255 / a), clamped to 255.
+	template<typename T>
+	void unpremultiply(const Color<T>* src, Color<T>* dst, std::size_t count) noexcept {
+		if constexpr (std::is_floating_point_v<T>) {
+			EZ_MATH_VECTORIZE
+			for (std::size_t i = 0; i < count; ++i) {
+				T a = src[i].a;
+				T inv = a > T(0) ? T(1) / a : T(0);
+				dst[i].r = src[i].r * inv;
+				dst[i].g = src[i].g * inv;
+				dst[i].b = src[i].b * inv;
+				dst[i].a = a;
+			}
+		}
+		else {
+			static_assert(std::is_same_v<T, uint8_t>, "ez::color::unpremultiply only supports 8 bit integer colors!");
+			const float* recip = intern::reciprocalTable().data();
+
+			// Estimate the quotient in floating point, then correct it by at most one in either direction.
+			auto divide = [](int c, int a, float inv) {
+				int n = c * 255 + (a >> 1);
+				int q = int(float(n) * inv);
+				q += (q + 1) * a <= n ? 1 : 0;
+				q -= q * a > n ? 1 : 0;
+				return uint8_t(std::min(a == 0 ? 0 : q, 255));
+			};
+
+			EZ_MATH_VECTORIZE
+			for (std::size_t i = 0; i < count; ++i) {
+				int a = src[i].a;
+				float inv = recip[a];
+				dst[i].r = divide(src[i].r, a, inv);
+				dst[i].g = divide(src[i].g, a, inv);
+				dst[i].b = divide(src[i].b, a, inv);
+				dst[i].a = uint8_t(a);
+			}
+		}
+	}
+
+	template<typename T>
+	void premultiply(Color<T>* colors, std::size_t count) noexcept {
+		premultiply(colors, colors, count);
+	}
+
+	template<typename T>
+	void unpremultiply(Color<T>* colors, std::size_t count) noexcept {
+		unpremultiply(colors, colors, count);
+	}
+};
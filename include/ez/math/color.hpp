@@ -5,6 +5,8 @@
 #include <cmath>
 #include <string_view>
 #include <cassert>
+#include <cstring>
+#include <functional>
 #include <ostream>
 #include <glm/vec3.hpp>
 #include <glm/vec4.hpp>
@@ -35,7 +37,7 @@ namespace ez {
 		static constexpr T maxval = intern::ColorMax<T>::value;
 
 		template<typename From, typename To>
-		static To convert(From val) noexcept {
+		static constexpr To convert(From val) noexcept {
 			if constexpr (std::is_floating_point_v<From>) {
 				if constexpr (std::is_floating_point_v<To>) {
 					return static_cast<To>(val);
@@ -54,10 +56,10 @@ namespace ez {
 			}
 		}
 
-		static uint8_t toU8(const T& val) noexcept {
+		static constexpr uint8_t toU8(const T& val) noexcept {
 			return convert<T, uint8_t>(val);
 		}
-		static T fromU8(int val) noexcept {
+		static constexpr T fromU8(int val) noexcept {
 			return convert<int, T>(val);
 		}
 		
@@ -84,13 +86,13 @@ namespace ez {
 				tmp |= toU8(value.a) << 24;
 				return tmp;
 		}
-		// ARGB
-		static Color fromHex(std::string_view text) noexcept {
+		// ARGB, usable in constant expressions
+		static constexpr Color fromHex(std::string_view text) noexcept {
 			if (text.length() >= 2 && (text[0] == '0' && (text[1] == 'x' || text[1] == 'X'))) {
 				text.remove_prefix(2);
 			}
 
-			int read[8];
+			int read[8]{};
 			int count = 0;
 			for (char val : text) {
 				int hex = 0;
@@ -177,7 +179,7 @@ namespace ez {
 		template<typename U = T, typename = std::enable_if_t<std::is_floating_point_v<U>>>
 		static Color fromHSVA(const glm::tvec4<T> & value) noexcept {
 			return Color{
-				glm::rgbColor(glm::tvec3<T>{ value.data }),
+				glm::rgbColor(glm::tvec3<T>{ value }),
 				value.a
 			};
 		}
@@ -251,13 +253,13 @@ namespace ez {
 		Color& operator=(const Color&) noexcept = default;
 		~Color() = default;
 
-		Color() noexcept
+		constexpr Color() noexcept
 			: Color(0, 0, 0)
 		{}
-		Color(const T& v) noexcept
+		constexpr Color(const T& v) noexcept
 			: Color(v, v, v)
 		{}
-		Color(const T& _r, const T& _g, const T& _b, const T& _a = maxval) noexcept
+		constexpr Color(const T& _r, const T& _g, const T& _b, const T& _a = maxval) noexcept
 			: r(_r)
 			, g(_g)
 			, b(_b)
@@ -307,13 +309,11 @@ namespace ez {
 			return glm::luminosity(glm::tvec3<T>{ data });
 		}
 
+		// Exact equality, use isNear to compare with a tolerance.
+		// ColorU compares the packed 32 bit word.
 		bool operator==(const Color& other) const noexcept {
-			if constexpr (std::is_floating_point_v<T>) {
-				return
-					std::abs(r - other.r) <= ez::epsilon<T>() &&
-					std::abs(g - other.g) <= ez::epsilon<T>() &&
-					std::abs(b - other.b) <= ez::epsilon<T>() &&
-					std::abs(a - other.a) <= ez::epsilon<T>();
+			if constexpr (std::is_same_v<T, uint8_t>) {
+				return word() == other.word();
 			}
 			else {
 				return
@@ -324,50 +324,62 @@ namespace ez {
 			}
 		}
 		bool operator!=(const Color& other) const noexcept {
-			if constexpr (std::is_floating_point_v<T>) {
-				return
-					std::abs(r - other.r) > ez::epsilon<T>() ||
-					std::abs(g - other.g) > ez::epsilon<T>() ||
-					std::abs(b - other.b) > ez::epsilon<T>() ||
-					std::abs(a - other.a) > ez::epsilon<T>();
-			}
-			else {
-				return
-					r != other.r ||
-					g != other.g ||
-					b != other.b ||
-					a != other.a;
-			}
+			return !(*this == other);
 		}
 
-		// Lexicographical compairison r->g->b->a
+		// Every channel is within epsilon of the other color
+		bool isNear(const Color& other, T epsilon = ez::epsilon<T>()) const noexcept {
+			auto near = [epsilon](T lh, T rh) {
+				return (lh < rh ? rh - lh : lh - rh) <= epsilon;
+			};
+			return
+				near(r, other.r) &&
+				near(g, other.g) &&
+				near(b, other.b) &&
+				near(a, other.a);
+		}
+
+		// Lexicographical comparison r->g->b->a
+		// ColorU compares a single 32 bit key, with red in the most significant byte.
 		bool operator<(const Color& other) const noexcept {
-			return 
-				r < other.r || 
-				g < other.g || 
-				b < other.b || 
-				a < other.a;
+			if constexpr (std::is_same_v<T, uint8_t>) {
+				return key() < other.key();
+			}
+			else {
+				if (r != other.r) {
+					return r < other.r;
+				}
+				if (g != other.g) {
+					return g < other.g;
+				}
+				if (b != other.b) {
+					return b < other.b;
+				}
+				return a < other.a;
+			}
 		}
 		bool operator>(const Color& other) const noexcept {
-			return
-				r > other.r ||
-				g > other.g ||
-				b > other.b ||
-				a > other.a;
+			return other < *this;
 		}
 		bool operator<=(const Color& other) const noexcept {
-			return
-				r <= other.r ||
-				g <= other.g ||
-				b <= other.b ||
-				a <= other.a;
+			return !(other < *this);
 		}
 		bool operator>=(const Color& other) const noexcept {
-			return
-				r >= other.r ||
-				g >= other.g ||
-				b >= other.b ||
-				a >= other.a;
+			return !(*this < other);
+		}
+
+		// The four channels as a single word, in memory order. Only for ColorU.
+		template<typename U = T, typename = std::enable_if_t<std::is_same_v<U, uint8_t>>>
+		uint32_t word() const noexcept {
+			uint32_t result;
+			std::memcpy(&result, this, sizeof(result));
+			return result;
+		}
+
+		// The four channels as a single word that sorts in r->g->b->a order. Only for ColorU.
+		template<typename U = T, typename = std::enable_if_t<std::is_same_v<U, uint8_t>>>
+		uint32_t key() const noexcept {
+			return (uint32_t(r) << 24) | (uint32_t(g) << 16) | (uint32_t(b) << 8) | uint32_t(a);
 		}
 
 		union {
@@ -391,4 +403,25 @@ namespace ez {
 	}
 }
 
+namespace std {
+	template<typename T>
+	struct hash<ez::Color<T>> {
+		std::size_t operator()(const ez::Color<T>& color) const noexcept {
+			if constexpr (std::is_same_v<T, uint8_t>) {
+				// Spread the packed word over the full hash with a single multiply
+				uint64_t h = uint64_t(color.word()) * 0x9E3779B97F4A7C15ull;
+				return std::size_t(h ^ (h >> 32));
+			}
+			else {
+				// Adding zero turns -0 into +0, since they compare equal
+				std::size_t h = 0;
+				for (int i = 0; i < 4; ++i) {
+					h ^= std::hash<T>{}(color[i] + T(0)) + 0x9E3779B9u + (h << 6) + (h >> 2);
+				}
+				return h;
+			}
+		}
+	};
+}
+
 using ez::operator<<;
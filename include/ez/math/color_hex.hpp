@@ -0,0 +1,196 @@
+#pragma once
+#include <cinttypes>
+#include <cstddef>
+#include <string_view>
+#include "color.hpp"
+#include "simd.hpp"
+
+/*
+	Strict hex color parsing, for reading large numbers of colors at once.
+	Accepts the same digit counts as Color::fromHex (1, 2, 3, 4, 6 or 8 digits, ARGB order), with an optional '#' or '0x' prefix
+	and ' digit separators. Unlike Color::fromHex, any other character is reported as an error instead of being skipped.
+*/
+
+namespace ez::color {
+	enum class HexError : uint8_t {
+		None,
+		// The token contains a character that is not a hex digit.
+		InvalidCharacter,
+		// The token does not have 1, 2, 3, 4, 6 or 8 digits.
+		InvalidLength,
+	};
+
+	namespace intern {
+		static constexpr uint64_t swarOnes = 0x0101010101010101ull;
+		static constexpr uint64_t swarHigh = 0x8080808080808080ull;
+
+		// High bit of each byte set where the byte is >= lo, bytes must be below 0x80
+		constexpr uint64_t swarGreaterEqual(uint64_t x, uint8_t lo) noexcept {
+			return (x + swarOnes * uint64_t(0x80 - lo)) & swarHigh;
+		}
+		// High bit of each byte set where the byte is <= hi, bytes must be below 0x80
+		constexpr uint64_t swarLessEqual(uint64_t x, uint8_t hi) noexcept {
+			return ~(x + swarOnes * uint64_t(0x7F - hi)) & swarHigh;
+		}
+
+		// Decodes exactly 8 hex characters packed into a word, first character in the lowest byte.
+		// All 8 digits are validated and decoded at once, within a single register.
+		constexpr bool decodeHex8(uint64_t chars, uint32_t& value) noexcept {
+			uint64_t ascii = chars & ~swarHigh;
+			uint64_t lower = ascii | (swarOnes * 0x20);
+
+			uint64_t digit = swarGreaterEqual(ascii, '0') & swarLessEqual(ascii, '9');
+			uint64_t alpha = swarGreaterEqual(lower, 'a') & swarLessEqual(lower, 'f');
+			if (((digit | alpha) & ~(chars & swarHigh)) != swarHigh) {
+				return false;
+			}
+
+			// Letters have the low nibble 1 through 6, add 9 to get the value
+			uint64_t nibbles = (chars & (swarOnes * 0x0F)) + (alpha >> 7) * 9;
+
+			// Merge pairs of nibbles, then pairs of bytes, then pairs of shorts. The first character is the most significant.
+			uint64_t bytes = ((nibbles & 0x000F000F000F000Full) << 4) | ((nibbles & 0x0F000F000F000F00ull) >> 8);
+			uint64_t shorts = ((bytes & 0x000000FF000000FFull) << 8) | ((bytes & 0x00FF000000FF0000ull) >> 16);
+			value = uint32_t(((shorts & 0xFFFF) << 16) | ((shorts >> 32) & 0xFFFF));
+			return true;
+		}
+
+		// Expands the decoded digits into a color, with the same rules as Color::fromHex
+		constexpr ColorU colorFromDigits(uint32_t value, int count) noexcept {
+			auto nibble = [value](int i) { return uint8_t(((value >> (i * 4)) & 0xF) * 17); };
+			auto byte = [value](int i) { return uint8_t(value >> (i * 8)); };
+
+			switch (count) {
+			case 1:
+				return ColorU{ nibble(0) };
+			case 2:
+				return ColorU{ byte(0) };
+			case 3:
+				return ColorU{ nibble(2), nibble(1), nibble(0) };
+			case 4:
+				return ColorU{ nibble(2), nibble(1), nibble(0), nibble(3) };
+			case 6:
+				return ColorU{ byte(2), byte(1), byte(0) };
+			default:
+				return ColorU{ byte(2), byte(1), byte(0), byte(3) };
+			}
+		}
+
+		constexpr bool isHexDelimiter(char c) noexcept {
+			return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == ',' || c == ';' || c == '"';
+		}
+
+		// Finds the first character at or after i for which isHexDelimiter(c) == delimiter
+		inline std::size_t findHexBoundary(std::string_view text, std::size_t i, bool delimiter) noexcept {
+#if defined(EZ_MATH_SSSE3)
+			const __m128i space = _mm_set1_epi8(' ');
+			const __m128i tab = _mm_set1_epi8('\t');
+			const __m128i newline = _mm_set1_epi8('\n');
+			const __m128i carriage = _mm_set1_epi8('\r');
+			const __m128i comma = _mm_set1_epi8(',');
+			const __m128i semicolon = _mm_set1_epi8(';');
+			const __m128i quote = _mm_set1_epi8('"');
+
+			for (; i + 16 <= text.size(); i += 16) {
+				__m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(text.data() + i));
+				__m128i hit = _mm_or_si128(
+					_mm_or_si128(
+						_mm_or_si128(_mm_cmpeq_epi8(block, space), _mm_cmpeq_epi8(block, tab)),
+						_mm_or_si128(_mm_cmpeq_epi8(block, newline), _mm_cmpeq_epi8(block, carriage))),
+					_mm_or_si128(
+						_mm_or_si128(_mm_cmpeq_epi8(block, comma), _mm_cmpeq_epi8(block, semicolon)),
+						_mm_cmpeq_epi8(block, quote)));
+
+				uint32_t mask = uint32_t(_mm_movemask_epi8(hit));
+				if (!delimiter) {
+					mask = ~mask & 0xFFFFu;
+				}
+				if (mask != 0) {
+					int offset = 0;
+					while (!(mask & 1u)) {
+						mask >>= 1;
+						++offset;
+					}
+					return i + offset;
+				}
+			}
+#endif
+			for (; i < text.size(); ++i) {
+				if (isHexDelimiter(text[i]) == delimiter) {
+					break;
+				}
+			}
+			return i;
+		}
+	};
+
+	// Parses a single token, with no surrounding whitespace. On failure color is set to opaque black.
+	constexpr HexError parseHex(std::string_view token, ColorU& color) noexcept {
+		color = ColorU{};
+
+		if (!token.empty() && token[0] == '#') {
+			token.remove_prefix(1);
+		}
+		else if (token.size() >= 2 && token[0] == '0' && (token[1] == 'x' || token[1] == 'X')) {
+			token.remove_prefix(2);
+		}
+
+		char digits[8]{};
+		int count = 0;
+		for (char c : token) {
+			if (c == '\'') {
+				continue;
+			}
+			if (count == 8) {
+				return HexError::InvalidLength;
+			}
+			digits[count++] = c;
+		}
+
+		// Right align the digits and pad with zeros, the first character goes in the lowest byte.
+		uint64_t chars = 0;
+		for (int i = 0; i < 8; ++i) {
+			char c = i < 8 - count ? '0' : digits[i - (8 - count)];
+			chars |= uint64_t(uint8_t(c)) << (i * 8);
+		}
+
+		uint32_t value = 0;
+		if (!intern::decodeHex8(chars, value)) {
+			return HexError::InvalidCharacter;
+		}
+
+		switch (count) {
+		case 1: case 2: case 3: case 4: case 6: case 8:
+			color = intern::colorFromDigits(value, count);
+			return HexError::None;
+		default:
+			return HexError::InvalidLength;
+		}
+	}
+
+	// Parses hex colors separated by whitespace, commas, semicolons or double quotes.
+	// At most capacity colors are written, and the number of tokens read is returned.
+	// The error for each token is written to errors, if it is not null. Tokens that fail to parse produce opaque black.
+	inline std::size_t parseHex(std::string_view text, ColorU* colors, HexError* errors, std::size_t capacity) noexcept {
+		std::size_t count = 0;
+		std::size_t i = 0;
+
+		while (count < capacity) {
+			std::size_t first = intern::findHexBoundary(text, i, false);
+			if (first == text.size()) {
+				break;
+			}
+			std::size_t last = intern::findHexBoundary(text, first, true);
+
+			HexError error = parseHex(text.substr(first, last - first), colors[count]);
+			if (errors) {
+				errors[count] = error;
+			}
+
+			++count;
+			i = last;
+		}
+
+		return count;
+	}
+};
@@ -0,0 +1,388 @@
+#pragma once
+#include <cinttypes>
+#include <cstddef>
+#include <cstring>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <algorithm>
+#include <glm/vec4.hpp>
+#include "color.hpp"
+#include "simd.hpp"
+
+/*
+	Bulk color space conversions for arrays of colors.
+	The single color conversions in ez::Color go through glm, and are better suited for one off values.
+*/
+
+namespace ez::color {
+	// What to do with the alpha channel during a bulk conversion.
+	enum class AlphaMode {
+		// Alpha is copied over, rescaled to the destination range. It is never gamma corrected.
+		Copy,
+		// The alpha channel of the destination is left untouched.
+		Ignore,
+	};
+
+	namespace intern {
+		// x^(1/5) for x in [0, 1], usable in constant expressions.
+		constexpr double fifthRoot(double x) noexcept {
+			double y = 1.0;
+			for (int i = 0; i < 64; ++i) {
+				double y2 = y * y;
+				y = y - (y2 * y2 * y - x) / (5.0 * y2 * y2);
+			}
+			return y;
+		}
+
+		constexpr std::array<float, 256> makeSRGBDecodeTable() noexcept {
+			std::array<float, 256> table{};
+			for (int i = 0; i < 256; ++i) {
+				double c = double(i) / 255.0;
+				if (c <= 0.04045) {
+					table[i] = static_cast<float>(c / 12.92);
+				}
+				else {
+					// v^2.4 == v^2 * (v^2)^(1/5)
+					double v = (c + 0.055) / 1.055;
+					double v2 = v * v;
+					table[i] = static_cast<float>(v2 * fifthRoot(v2));
+				}
+			}
+			return table;
+		}
+
+		// Linear value of every 8 bit sRGB value.
+		inline constexpr std::array<float, 256> srgbDecodeTable = makeSRGBDecodeTable();
+
+		// The encoding table is indexed by the top bits of the float, 8 mantissa bits for each octave in [2^-13, 1).
+		// Below 2^-13 every value encodes to zero anyways.
+		static constexpr uint32_t srgbEncodeMinBits = (127u - 13u) << 23;
+		static constexpr uint32_t srgbEncodeMaxBits = 0x3F7FFFFFu;
+		static constexpr int srgbEncodeShift = 23 - 8;
+		static constexpr std::size_t srgbEncodeSize = ((srgbEncodeMaxBits - srgbEncodeMinBits) >> srgbEncodeShift) + 1;
+
+		// Padded with three bytes, so that the vector path can gather a 32 bit word at every index
+		inline const std::array<uint8_t, srgbEncodeSize + 3>& srgbEncodeTable() noexcept {
+			static const std::array<uint8_t, srgbEncodeSize + 3> table = [] {
+				std::array<uint8_t, srgbEncodeSize + 3> result{};
+				for (std::size_t i = 0; i < srgbEncodeSize; ++i) {
+					// Sample the middle of the bucket
+					uint32_t bits = srgbEncodeMinBits + uint32_t(i << srgbEncodeShift) + (1u << (srgbEncodeShift - 1));
+					float fmid;
+					std::memcpy(&fmid, &bits, sizeof(float));
+
+					double mid = fmid;
+					double encoded = mid < 0.0031308 ? mid * 12.92 : 1.055 * std::pow(mid, 1.0 / 2.4) - 0.055;
+					result[i] = static_cast<uint8_t>(encoded * 255.0 + 0.5);
+				}
+				return result;
+			}();
+			return table;
+		}
+
+		// Clamped on the bits, which order the same as the values do for positive floats. Negative values are negative integers,
+		// and NaN is moved to the low end explicitly, so this holds under -ffinite-math-only as well.
+		inline uint32_t srgbEncodeIndex(float x) noexcept {
+			int32_t bits;
+			std::memcpy(&bits, &x, sizeof(float));
+			bits = bits > int32_t(0x7F800000) ? int32_t(srgbEncodeMinBits) : bits;
+			bits = std::max(bits, int32_t(srgbEncodeMinBits));
+			bits = std::min(bits, int32_t(srgbEncodeMaxBits));
+			return uint32_t(bits - int32_t(srgbEncodeMinBits)) >> srgbEncodeShift;
+		}
+
+#if defined(EZ_MATH_AVX2)
+		// srgbEncodeIndex for eight values
+		inline __m256i srgbEncodeIndex8(__m256 x) noexcept {
+			const __m256i lo = _mm256_set1_epi32(int32_t(srgbEncodeMinBits));
+			__m256i bits = _mm256_castps_si256(x);
+			bits = _mm256_blendv_epi8(bits, lo, _mm256_cmpgt_epi32(bits, _mm256_set1_epi32(0x7F800000)));
+			bits = _mm256_max_epi32(bits, lo);
+			bits = _mm256_min_epi32(bits, _mm256_set1_epi32(int32_t(srgbEncodeMaxBits)));
+			return _mm256_srli_epi32(_mm256_sub_epi32(bits, lo), srgbEncodeShift);
+		}
+
+		// unorm8 for eight values, as 32 bit integers
+		inline __m256i unorm8x8(__m256 x) noexcept {
+			x = _mm256_min_ps(_mm256_max_ps(x, _mm256_setzero_ps()), _mm256_set1_ps(1.f));
+			return _mm256_cvttps_epi32(_mm256_add_ps(_mm256_mul_ps(x, _mm256_set1_ps(255.f)), _mm256_set1_ps(0.5f)));
+		}
+#endif
+
+		inline uint8_t unorm8(float x) noexcept {
+			x = x > 0.f ? x : 0.f;
+			x = x < 1.f ? x : 1.f;
+			return static_cast<uint8_t>(x * 255.f + 0.5f);
+		}
+
+		// Branch free conversions for the lane loops. Hue is in degrees [0, 360), everything else is in the range [0, 1].
+		// Unlike glm::hsvColor, grays get a hue of zero instead of NaN.
+		//
+		// The hue from the sector of the largest channel. The difference and offset of the sector are blended in, and adding the
+		// smallest normal keeps 0 / 0 out for grays without a select on the divisor, so there is nothing left for the compiler to branch on.
+		template<typename T>
+		EZ_MATH_INLINE T hueOf(T r, T g, T b, T max, T delta) noexcept {
+			using ez::simd::select;
+			bool red = r == max;
+			bool green = !red & (g == max);
+
+			T diff = select(red, g - b, select(green, b - r, r - g));
+			T offset = select(red, T(0), select(green, T(120), T(240)));
+			T hue = offset + T(60) * diff / (delta + std::numeric_limits<T>::min());
+			return hue + select(hue < T(0), T(360), T(0));
+		}
+
+		template<typename T>
+		EZ_MATH_INLINE void rgbToHsv(T r, T g, T b, T& h, T& s, T& v) noexcept {
+			T max = std::max(r, std::max(g, b));
+			T min = std::min(r, std::min(g, b));
+			T delta = max - min;
+
+			h = hueOf(r, g, b, max, delta);
+			s = ez::simd::select(max > T(0), delta / (max + std::numeric_limits<T>::min()), T(0));
+			v = max;
+		}
+
+		// value mod period, into [0, period). std::floor only vectorizes with -fno-trapping-math, so round through an integer instead,
+		// clamped so that the conversion stays in range. Written so that NaN ends up at the low end.
+		template<typename T>
+		EZ_MATH_INLINE T wrapSector(T value, T period) noexcept {
+			using ez::simd::select;
+			constexpr T limit = T(1 << 30);
+			T q = value / period;
+			q = select(q > -limit, q, -limit);
+			q = select(q < limit, q, limit);
+
+			T whole = T(std::int32_t(q));
+			whole -= select(whole > q, T(1), T(0));
+			return value - period * whole;
+		}
+
+		template<typename T>
+		EZ_MATH_INLINE void hsvToRgb(T h, T s, T v, T& r, T& g, T& b) noexcept {
+			// f(n) = v - v * s * clamp(min(k, 4 - k), 0, 1), k = (n + h / 60) mod 6
+			T sector = h / T(60);
+			T kr = wrapSector(T(5) + sector, T(6));
+			T kg = wrapSector(T(3) + sector, T(6));
+			T kb = wrapSector(T(1) + sector, T(6));
+			T vs = v * s;
+
+			r = v - vs * std::max(T(0), std::min(T(1), std::min(kr, T(4) - kr)));
+			g = v - vs * std::max(T(0), std::min(T(1), std::min(kg, T(4) - kg)));
+			b = v - vs * std::max(T(0), std::min(T(1), std::min(kb, T(4) - kb)));
+		}
+
+		template<typename T>
+		EZ_MATH_INLINE void rgbToHsl(T r, T g, T b, T& h, T& s, T& l) noexcept {
+			T max = std::max(r, std::max(g, b));
+			T min = std::min(r, std::min(g, b));
+			T delta = max - min;
+			T light = (max + min) * T(0.5);
+			T denom = T(1) - std::abs(T(2) * light - T(1));
+
+			h = hueOf(r, g, b, max, delta);
+			s = ez::simd::select(denom > T(0), delta / (denom + std::numeric_limits<T>::min()), T(0));
+			l = light;
+		}
+
+		template<typename T>
+		EZ_MATH_INLINE void hslToRgb(T h, T s, T l, T& r, T& g, T& b) noexcept {
+			// f(n) = l - a * clamp(min(k - 3, 9 - k), -1, 1), k = (n + h / 30) mod 12
+			T sector = h / T(30);
+			T kr = wrapSector(sector, T(12));
+			T kg = wrapSector(T(8) + sector, T(12));
+			T kb = wrapSector(T(4) + sector, T(12));
+			T a = s * std::min(l, T(1) - l);
+
+			r = l - a * std::max(T(-1), std::min(T(1), std::min(kr - T(3), T(9) - kr)));
+			g = l - a * std::max(T(-1), std::min(T(1), std::min(kg - T(3), T(9) - kg)));
+			b = l - a * std::max(T(-1), std::min(T(1), std::min(kb - T(3), T(9) - kb)));
+		}
+	};
+
+	// Convert a single 8 bit sRGB value into linear space.
+	constexpr float decodeSRGB(uint8_t value) noexcept {
+		return intern::srgbDecodeTable[value];
+	}
+
+	// Convert a single linear value into 8 bit sRGB, clamping to the range [0, 1].
+	// The result is never more than one step away from the correctly rounded value, and is exact for every value returned by decodeSRGB.
+	inline uint8_t encodeSRGB(float value) noexcept {
+		return intern::srgbEncodeTable()[intern::srgbEncodeIndex(value)];
+	}
+
+	// Converts count linear colors into 8 bit sRGB colors. Same accuracy as encodeSRGB.
+	inline void linearToSRGB(const ColorF* src, ColorU* dst, std::size_t count, AlphaMode alpha = AlphaMode::Copy) noexcept {
+		static_assert(sizeof(ColorF) == 16 && sizeof(ColorU) == 4, "ez::color::linearToSRGB requires tightly packed colors!");
+		const uint8_t* table = intern::srgbEncodeTable().data();
+		std::size_t i = 0;
+
+#if defined(EZ_MATH_AVX2)
+		// Compilers cannot gather bytes, so gather the 32 bit word starting at each index and keep the low byte.
+		// Four pixels at a time, the results are narrowed to bytes and put back in order with one permute.
+		{
+			const __m256i low = _mm256_set1_epi32(0xFF);
+			const __m256i order = _mm256_setr_epi32(0, 4, 1, 5, 0, 4, 1, 5);
+			const __m128i alphaBytes = _mm_set1_epi32(int32_t(0xFF000000));
+			const int* words = reinterpret_cast<const int*>(table);
+
+			for (; i + 4 <= count; i += 4) {
+				__m256 x0 = _mm256_loadu_ps(&src[i].r);
+				__m256 x1 = _mm256_loadu_ps(&src[i + 2].r);
+				__m256i c0 = _mm256_and_si256(_mm256_i32gather_epi32(words, intern::srgbEncodeIndex8(x0), 1), low);
+				__m256i c1 = _mm256_and_si256(_mm256_i32gather_epi32(words, intern::srgbEncodeIndex8(x1), 1), low);
+				if (alpha == AlphaMode::Copy) {
+					c0 = _mm256_blend_epi32(c0, intern::unorm8x8(x0), 0x88);
+					c1 = _mm256_blend_epi32(c1, intern::unorm8x8(x1), 0x88);
+				}
+
+				__m256i bytes = _mm256_packus_epi16(_mm256_packus_epi32(c0, c1), _mm256_setzero_si256());
+				__m128i pixels = _mm256_castsi256_si128(_mm256_permutevar8x32_epi32(bytes, order));
+				if (alpha == AlphaMode::Ignore) {
+					pixels = _mm_blendv_epi8(pixels, _mm_loadu_si128(reinterpret_cast<const __m128i*>(&dst[i])), alphaBytes);
+				}
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(&dst[i]), pixels);
+			}
+		}
+#endif
+
+		if (alpha == AlphaMode::Copy) {
+			EZ_MATH_VECTORIZE
+			for (; i < count; ++i) {
+				dst[i].r = table[intern::srgbEncodeIndex(src[i].r)];
+				dst[i].g = table[intern::srgbEncodeIndex(src[i].g)];
+				dst[i].b = table[intern::srgbEncodeIndex(src[i].b)];
+				dst[i].a = intern::unorm8(src[i].a);
+			}
+		}
+		else {
+			EZ_MATH_VECTORIZE
+			for (; i < count; ++i) {
+				dst[i].r = table[intern::srgbEncodeIndex(src[i].r)];
+				dst[i].g = table[intern::srgbEncodeIndex(src[i].g)];
+				dst[i].b = table[intern::srgbEncodeIndex(src[i].b)];
+			}
+		}
+	}
+
+	// Converts count 8 bit sRGB colors into linear colors, using a lookup table.
+	inline void srgbToLinear(const ColorU* src, ColorF* dst, std::size_t count, AlphaMode alpha = AlphaMode::Copy) noexcept {
+		static_assert(sizeof(ColorF) == 16 && sizeof(ColorU) == 4, "ez::color::srgbToLinear requires tightly packed colors!");
+		const float* table = intern::srgbDecodeTable.data();
+		std::size_t i = 0;
+
+#if defined(EZ_MATH_AVX2)
+		// Two pixels at a time, the channels are widened into gather indices and alpha is blended in afterwards.
+		// Leaving the alpha of the destination alone is a strided store that compilers do not vectorize by themselves.
+		for (; i + 2 <= count; i += 2) {
+			__m256i channels = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(&src[i])));
+			__m256 linear = _mm256_i32gather_ps(table, channels, 4);
+			__m256 a = alpha == AlphaMode::Copy ?
+				_mm256_div_ps(_mm256_cvtepi32_ps(channels), _mm256_set1_ps(255.f)) :
+				_mm256_loadu_ps(&dst[i].r);
+			_mm256_storeu_ps(&dst[i].r, _mm256_blend_ps(linear, a, 0x88));
+		}
+#endif
+
+		if (alpha == AlphaMode::Copy) {
+			EZ_MATH_VECTORIZE
+			for (; i < count; ++i) {
+				dst[i].r = table[src[i].r];
+				dst[i].g = table[src[i].g];
+				dst[i].b = table[src[i].b];
+				dst[i].a = float(src[i].a) / 255.f;
+			}
+		}
+		else {
+			EZ_MATH_VECTORIZE
+			for (; i < count; ++i) {
+				dst[i].r = table[src[i].r];
+				dst[i].g = table[src[i].g];
+				dst[i].b = table[src[i].b];
+			}
+		}
+	}
+
+	/*
+		Bulk HSV and HSL conversions. Hue is in degrees [0, 360), same as Color::fromHSV and Color::toHSV.
+		The array of structures versions store the result as (h, s, v, a) or (h, s, l, a), and carry the alpha over.
+		The structure of arrays versions take one array per channel, and may be used in place.
+	*/
+
+	template<typename T>
+	void rgbToHsv(const Color<T>* src, glm::tvec4<T>* dst, std::size_t count) noexcept {
+		static_assert(std::is_floating_point_v<T>, "ez::color::rgbToHsv requires floating point types!");
+		EZ_MATH_VECTORIZE
+		for (std::size_t i = 0; i < count; ++i) {
+			T h, s, v, a = src[i].a;
+			intern::rgbToHsv(src[i].r, src[i].g, src[i].b, h, s, v);
+			dst[i] = glm::tvec4<T>{ h, s, v, a };
+		}
+	}
+	template<typename T>
+	void rgbToHsv(const T* r, const T* g, const T* b, T* h, T* s, T* v, std::size_t count) noexcept {
+		static_assert(std::is_floating_point_v<T>, "ez::color::rgbToHsv requires floating point types!");
+		EZ_MATH_VECTORIZE
+		for (std::size_t i = 0; i < count; ++i) {
+			intern::rgbToHsv(r[i], g[i], b[i], h[i], s[i], v[i]);
+		}
+	}
+
+	template<typename T>
+	void hsvToRgb(const glm::tvec4<T>* src, Color<T>* dst, std::size_t count) noexcept {
+		static_assert(std::is_floating_point_v<T>, "ez::color::hsvToRgb requires floating point types!");
+		EZ_MATH_VECTORIZE
+		for (std::size_t i = 0; i < count; ++i) {
+			T r, g, b, a = src[i].w;
+			intern::hsvToRgb(src[i].x, src[i].y, src[i].z, r, g, b);
+			dst[i] = Color<T>{ r, g, b, a };
+		}
+	}
+	template<typename T>
+	void hsvToRgb(const T* h, const T* s, const T* v, T* r, T* g, T* b, std::size_t count) noexcept {
+		static_assert(std::is_floating_point_v<T>, "ez::color::hsvToRgb requires floating point types!");
+		EZ_MATH_VECTORIZE
+		for (std::size_t i = 0; i < count; ++i) {
+			intern::hsvToRgb(h[i], s[i], v[i], r[i], g[i], b[i]);
+		}
+	}
+
+	template<typename T>
+	void rgbToHsl(const Color<T>* src, glm::tvec4<T>* dst, std::size_t count) noexcept {
+		static_assert(std::is_floating_point_v<T>, "ez::color::rgbToHsl requires floating point types!");
+		EZ_MATH_VECTORIZE
+		for (std::size_t i = 0; i < count; ++i) {
+			T h, s, l, a = src[i].a;
+			intern::rgbToHsl(src[i].r, src[i].g, src[i].b, h, s, l);
+			dst[i] = glm::tvec4<T>{ h, s, l, a };
+		}
+	}
+	template<typename T>
+	void rgbToHsl(const T* r, const T* g, const T* b, T* h, T* s, T* l, std::size_t count) noexcept {
+		static_assert(std::is_floating_point_v<T>, "ez::color::rgbToHsl requires floating point types!");
+		EZ_MATH_VECTORIZE
+		for (std::size_t i = 0; i < count; ++i) {
+			intern::rgbToHsl(r[i], g[i], b[i], h[i], s[i], l[i]);
+		}
+	}
+
+	template<typename T>
+	void hslToRgb(const glm::tvec4<T>* src, Color<T>* dst, std::size_t count) noexcept {
+		static_assert(std::is_floating_point_v<T>, "ez::color::hslToRgb requires floating point types!");
+		EZ_MATH_VECTORIZE
+		for (std::size_t i = 0; i < count; ++i) {
+			T r, g, b, a = src[i].w;
+			intern::hslToRgb(src[i].x, src[i].y, src[i].z, r, g, b);
+			dst[i] = Color<T>{ r, g, b, a };
+		}
+	}
+	template<typename T>
+	void hslToRgb(const T* h, const T* s, const T* l, T* r, T* g, T* b, std::size_t count) noexcept {
+		static_assert(std::is_floating_point_v<T>, "ez::color::hslToRgb requires floating point types!");
+		EZ_MATH_VECTORIZE
+		for (std::size_t i = 0; i < count; ++i) {
+			intern::hslToRgb(h[i], s[i], l[i], r[i], g[i], b[i]);
+		}
+	}
+};
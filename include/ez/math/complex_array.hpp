@@ -0,0 +1,254 @@
+#pragma once
+#include <cstddef>
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <algorithm>
+#include <type_traits>
+#include <vector>
+#include "complex.hpp"
+#include "fastmath.hpp"
+#include "simd.hpp"
+
+/*
+	Structure of arrays storage for complex numbers, with the real and imaginary parts in separate arrays.
+	The operations on it are plain arithmetic without the C99 special cases for infinities and nan that
+	std::complex multiplication and division go through, so they vectorize.
+	The operations are free functions in ez::complex, ie ez::complex::multiply(lh, rh, out).
+*/
+
+namespace ez {
+	namespace intern {
+		// Number of elements processed per pass by the kernels that need a scratch buffer.
+		static constexpr std::size_t complexBlock = 256;
+	};
+
+	// Copy interleaved complex values into separate real and imaginary arrays
+	template<typename T>
+	void deinterleave(const glm::tcomplex<T>* values, T* re, T* im, std::size_t count) noexcept {
+		// std::complex is guaranteed to be laid out as an array of two values
+		const T* parts = reinterpret_cast<const T*>(values);
+
+		EZ_MATH_VECTORIZE
+		for (std::size_t i = 0; i < count; ++i) {
+			re[i] = parts[i * 2];
+			im[i] = parts[i * 2 + 1];
+		}
+	}
+
+	// Copy separate real and imaginary arrays into interleaved complex values
+	template<typename T>
+	void interleave(const T* re, const T* im, glm::tcomplex<T>* values, std::size_t count) noexcept {
+		T* parts = reinterpret_cast<T*>(values);
+
+		EZ_MATH_VECTORIZE
+		for (std::size_t i = 0; i < count; ++i) {
+			parts[i * 2] = re[i];
+			parts[i * 2 + 1] = im[i];
+		}
+	}
+
+	template<typename T>
+	class ComplexArray {
+	public:
+		static_assert(std::is_floating_point_v<T>, "ez::ComplexArray requires floating point types!");
+		using value_type = glm::tcomplex<T>;
+
+		ComplexArray() = default;
+
+		// count zeros
+		explicit ComplexArray(std::size_t count)
+			: re_(count, T(0))
+			, im_(count, T(0))
+		{}
+
+		ComplexArray(const value_type* values, std::size_t count) {
+			assign(values, count);
+		}
+
+		std::size_t size() const noexcept {
+			return re_.size();
+		}
+		bool empty() const noexcept {
+			return re_.empty();
+		}
+
+		// New elements are zero
+		void resize(std::size_t count) {
+			re_.resize(count, T(0));
+			im_.resize(count, T(0));
+		}
+		void clear() noexcept {
+			re_.clear();
+			im_.clear();
+		}
+
+		T* real() noexcept {
+			return re_.data();
+		}
+		const T* real() const noexcept {
+			return re_.data();
+		}
+		T* imag() noexcept {
+			return im_.data();
+		}
+		const T* imag() const noexcept {
+			return im_.data();
+		}
+
+		value_type operator[](std::size_t index) const noexcept {
+			return value_type{ re_[index], im_[index] };
+		}
+		void set(std::size_t index, const value_type& value) noexcept {
+			re_[index] = value.real();
+			im_[index] = value.imag();
+		}
+
+		// Replace the contents with interleaved values
+		void assign(const value_type* values, std::size_t count) {
+			re_.resize(count);
+			im_.resize(count);
+			deinterleave(values, re_.data(), im_.data(), count);
+		}
+
+		// Write the contents out as size() interleaved values
+		void copyTo(value_type* values) const noexcept {
+			interleave(re_.data(), im_.data(), values, size());
+		}
+	private:
+		std::vector<T> re_, im_;
+	};
+};
+
+// Element wise operations on ComplexArray
+namespace ez::complex {
+	// The element wise product lh * rh. out may be one of the inputs.
+	template<typename T>
+	void multiply(const ComplexArray<T>& lh, const ComplexArray<T>& rh, ComplexArray<T>& out) {
+		assert(lh.size() == rh.size());
+		std::size_t count = std::min(lh.size(), rh.size());
+		out.resize(count);
+
+		const T* ar = lh.real(), * ai = lh.imag();
+		const T* br = rh.real(), * bi = rh.imag();
+		T* outr = out.real(), * outi = out.imag();
+
+		EZ_MATH_VECTORIZE
+		for (std::size_t i = 0; i < count; ++i) {
+			T re = ar[i] * br[i] - ai[i] * bi[i];
+			T im = ar[i] * bi[i] + ai[i] * br[i];
+			outr[i] = re;
+			outi[i] = im;
+		}
+	}
+
+	// The element wise product lh * conj(rh), as used for correlation. out may be one of the inputs.
+	template<typename T>
+	void multiplyConjugate(const ComplexArray<T>& lh, const ComplexArray<T>& rh, ComplexArray<T>& out) {
+		assert(lh.size() == rh.size());
+		std::size_t count = std::min(lh.size(), rh.size());
+		out.resize(count);
+
+		const T* ar = lh.real(), * ai = lh.imag();
+		const T* br = rh.real(), * bi = rh.imag();
+		T* outr = out.real(), * outi = out.imag();
+
+		EZ_MATH_VECTORIZE
+		for (std::size_t i = 0; i < count; ++i) {
+			T re = ar[i] * br[i] + ai[i] * bi[i];
+			T im = ai[i] * br[i] - ar[i] * bi[i];
+			outr[i] = re;
+			outi[i] = im;
+		}
+	}
+
+	// Multiply every element by a single value, which rotates them when it has unit length. out may be the input.
+	template<typename T>
+	void rotate(const ComplexArray<T>& values, const glm::tcomplex<T>& rotation, ComplexArray<T>& out) {
+		std::size_t count = values.size();
+		out.resize(count);
+
+		const T* ar = values.real(), * ai = values.imag();
+		T* outr = out.real(), * outi = out.imag();
+		T br = rotation.real(), bi = rotation.imag();
+
+		EZ_MATH_VECTORIZE
+		for (std::size_t i = 0; i < count; ++i) {
+			T re = ar[i] * br - ai[i] * bi;
+			T im = ar[i] * bi + ai[i] * br;
+			outr[i] = re;
+			outi[i] = im;
+		}
+	}
+
+	// Rotate every element by an angle in radians
+	template<typename T>
+	void rotate(const ComplexArray<T>& values, T angle, ComplexArray<T>& out) {
+		rotate(values, glm::polar(angle), out);
+	}
+
+	// Scale every element to unit length. Zero stays zero. out may be the input.
+	template<typename T>
+	void normalize(const ComplexArray<T>& values, ComplexArray<T>& out) {
+		std::size_t count = values.size();
+		out.resize(count);
+
+		const T* ar = values.real(), * ai = values.imag();
+		T* outr = out.real(), * outi = out.imag();
+
+		T length[intern::complexBlock];
+		for (std::size_t offset = 0; offset < count; offset += intern::complexBlock) {
+			std::size_t n = std::min(intern::complexBlock, count - offset);
+
+			EZ_MATH_VECTORIZE
+			for (std::size_t i = 0; i < n; ++i) {
+				// Divided by the larger component first, so the squares neither underflow for tiny values nor overflow for huge ones.
+				// The smallest subnormal keeps 0 / 0 out of zero, without a select on the divisor.
+				T largest = std::max(std::max(std::abs(ar[offset + i]), std::abs(ai[offset + i])), std::numeric_limits<T>::denorm_min());
+				T re = ar[offset + i] / largest;
+				T im = ai[offset + i] / largest;
+				outr[offset + i] = re;
+				outi[offset + i] = im;
+				length[i] = re * re + im * im;
+			}
+			ez::simd::sqrt(length, n);
+
+			EZ_MATH_VECTORIZE
+			for (std::size_t i = 0; i < n; ++i) {
+				// The length is zero or at least one, so adding the smallest normal only changes zero
+				T scale = T(1) / (length[i] + std::numeric_limits<T>::min());
+				outr[offset + i] *= scale;
+				outi[offset + i] *= scale;
+			}
+		}
+	}
+
+	// The magnitude of every element. Unlike std::abs there is no rescaling to avoid overflow,
+	// so values with components beyond the square root of the largest T give infinity.
+	template<typename T>
+	void abs(const ComplexArray<T>& values, T* out) noexcept {
+		std::size_t count = values.size();
+		const T* ar = values.real(), * ai = values.imag();
+
+		EZ_MATH_VECTORIZE
+		for (std::size_t i = 0; i < count; ++i) {
+			out[i] = ar[i] * ar[i] + ai[i] * ai[i];
+		}
+		ez::simd::sqrt(out, count);
+	}
+
+	// The angle of every element, in [-pi, pi]. Computed with ez::fastmath::atan2, at the given precision.
+	// The fastmath tiers are no more accurate than float, so doubles at full precision use std::atan2 instead, which does not vectorize.
+	template<fastmath::Precision P = fastmath::Precision::Full, typename T>
+	void arg(const ComplexArray<T>& values, T* out) noexcept {
+		if constexpr (P == fastmath::Precision::Full && !std::is_same_v<T, float>) {
+			const T* ar = values.real(), * ai = values.imag();
+			for (std::size_t i = 0; i < values.size(); ++i) {
+				out[i] = std::atan2(ai[i], ar[i]);
+			}
+		}
+		else {
+			fastmath::atan2<P>(values.imag(), values.real(), out, values.size());
+		}
+	}
+};
\ No newline at end of file
@@ -0,0 +1,489 @@
+#pragma once
+#include <cinttypes>
+#include <cstddef>
+#include <cstring>
+#include <cassert>
+#include <type_traits>
+#include "prng.hpp"
+#include "simd.hpp"
+
+/*
+	Distributions for the ez::prng engines.
+	Unlike the <random> distributions, these are fully specified, so a given engine state produces the same values regardless of the standard library.
+	The ziggurat tables are computed at compile time using only basic arithmetic for the same reason.
+	Bit for bit identical results across compilers and targets also need floating point contraction turned off (-ffp-contract=off for gcc and clang).
+	Otherwise a multiply and add may be fused where the target has fma, which rounds differently in uniform, the ziggurat's wedge and tail tests,
+	and the normal and exponential overloads that scale the result. The integer distributions and the ziggurat's fast path are not affected.
+
+	The fill functions take their random bits from the engine's own fill, and convert them in bulk.
+*/
+
+namespace ez::prng {
+	namespace intern {
+		// 32 random bits from an engine, 64 bit engines provide their upper bits since those are the strongest.
+		template<typename Engine>
+		constexpr std::uint32_t next32(Engine& gen) noexcept {
+			if constexpr (sizeof(typename Engine::result_type) == 8) {
+				return std::uint32_t(gen() >> 32);
+			}
+			else {
+				return std::uint32_t(gen());
+			}
+		}
+
+		// 64 random bits from an engine, 32 bit engines are called twice with the first output in the upper half.
+		template<typename Engine>
+		constexpr std::uint64_t next64(Engine& gen) noexcept {
+			if constexpr (sizeof(typename Engine::result_type) == 8) {
+				return std::uint64_t(gen());
+			}
+			else {
+				std::uint64_t high = std::uint32_t(gen());
+				return (high << 32) | std::uint32_t(gen());
+			}
+		}
+
+		// [0, 1) with 23 bits of precision, through the exponent of a float in [1, 2)
+		inline float bitsToFloat(std::uint32_t bits) noexcept {
+			std::uint32_t word = 0x3F800000u | (bits >> 9);
+			float value;
+			std::memcpy(&value, &word, sizeof(value));
+			return value - 1.f;
+		}
+
+		// [0, 1) with 52 bits of precision, through the exponent of a double in [1, 2)
+		inline double bitsToDouble(std::uint64_t bits) noexcept {
+			std::uint64_t word = 0x3FF0000000000000ull | (bits >> 12);
+			double value;
+			std::memcpy(&value, &word, sizeof(value));
+			return value - 1.0;
+		}
+
+		// Deterministic exp and log, used to build the ziggurat tables at compile time and for the slow paths of sampling.
+		// Only basic arithmetic is used, so the result does not depend on the platform's math library.
+		constexpr double ln2 = 0.69314718055994530942;
+
+		constexpr double exactExp(double x) noexcept {
+			// x = k * ln2 + r, |r| <= ln2 / 2
+			double k = x / ln2;
+			long long n = (long long)(k < 0 ? k - 0.5 : k + 0.5);
+			double r = x - double(n) * 0.693147180369123816490 - double(n) * 1.90821492927058770002e-10;
+
+			double term = 1.0, sum = 1.0;
+			for (int i = 1; i < 24; ++i) {
+				term *= r / double(i);
+				sum += term;
+			}
+
+			for (; n > 0; --n) {
+				sum *= 2.0;
+			}
+			for (; n < 0; ++n) {
+				sum *= 0.5;
+			}
+			return sum;
+		}
+
+		constexpr double exactLog(double x) noexcept {
+			// x = m * 2^e, with m in [sqrt(1/2), sqrt(2))
+			int e = 0;
+			while (x >= 1.4142135623730951) {
+				x *= 0.5;
+				++e;
+			}
+			while (x < 0.7071067811865476) {
+				x *= 2.0;
+				--e;
+			}
+
+			// log(m) = 2 atanh((m - 1) / (m + 1))
+			double s = (x - 1.0) / (x + 1.0);
+			double s2 = s * s;
+			double term = s, sum = 0.0;
+			for (int i = 1; i < 40; i += 2) {
+				sum += term / double(i);
+				term *= s2;
+			}
+			return 2.0 * sum + double(e) * ln2;
+		}
+
+		constexpr double exactSqrt(double x) noexcept {
+			if (x <= 0.0) {
+				return 0.0;
+			}
+			double y = x > 1.0 ? x : 1.0;
+			for (int i = 0; i < 64; ++i) {
+				double next = 0.5 * (y + x / y);
+				if (next >= y) {
+					break;
+				}
+				y = next;
+			}
+			return y;
+		}
+
+		// Layers of a 256 layer ziggurat. Layer i covers [0, x[i]] between the heights f(x[i]) and f(x[i + 1]).
+		// Layer 0 is the base strip, which includes the tail beyond x[1].
+		struct Ziggurat {
+			double x[257];
+			double f[257];
+		};
+
+		constexpr double normalDensity(double x) noexcept {
+			return exactExp(-0.5 * x * x);
+		}
+		constexpr double exponentialDensity(double x) noexcept {
+			return exactExp(-x);
+		}
+
+		constexpr Ziggurat makeNormalZiggurat() noexcept {
+			// Start of the tail and the area of each layer, from Marsaglia and Tsang
+			constexpr double r = 3.6541528853610088;
+			constexpr double v = 0.00492867323399;
+
+			Ziggurat table{};
+			table.x[0] = v / normalDensity(r);
+			table.x[1] = r;
+			for (int i = 1; i < 255; ++i) {
+				table.x[i + 1] = exactSqrt(-2.0 * exactLog(v / table.x[i] + normalDensity(table.x[i])));
+			}
+			table.x[256] = 0.0;
+
+			for (int i = 0; i < 257; ++i) {
+				table.f[i] = normalDensity(table.x[i]);
+			}
+			return table;
+		}
+
+		constexpr Ziggurat makeExponentialZiggurat() noexcept {
+			constexpr double r = 7.69711747013104972;
+			constexpr double v = 0.0039496598225815571993;
+
+			Ziggurat table{};
+			table.x[0] = v / exponentialDensity(r);
+			table.x[1] = r;
+			for (int i = 1; i < 255; ++i) {
+				table.x[i + 1] = -exactLog(v / table.x[i] + exponentialDensity(table.x[i]));
+			}
+			table.x[256] = 0.0;
+
+			for (int i = 0; i < 257; ++i) {
+				table.f[i] = exponentialDensity(table.x[i]);
+			}
+			return table;
+		}
+
+		inline constexpr Ziggurat normalZiggurat = makeNormalZiggurat();
+		inline constexpr Ziggurat exponentialZiggurat = makeExponentialZiggurat();
+
+		// The fast path shared by the scalar and batch samplers. The low 8 bits pick the layer, bit 8 the sign,
+		// and the top 53 bits the position within the layer. Returns false if the slow path is needed.
+		constexpr bool normalFast(std::uint64_t bits, double& result) noexcept {
+			std::size_t i = std::size_t(bits & 255u);
+			double x = double(bits >> 11) * 0x1.0p-53 * normalZiggurat.x[i];
+			result = bits & 256u ? -x : x;
+			return x < normalZiggurat.x[i + 1];
+		}
+		constexpr bool exponentialFast(std::uint64_t bits, double& result) noexcept {
+			std::size_t i = std::size_t(bits & 255u);
+			result = double(bits >> 11) * 0x1.0p-53 * exponentialZiggurat.x[i];
+			return result < exponentialZiggurat.x[i + 1];
+		}
+
+		// (0, 1], safe to take the log of
+		template<typename Engine>
+		constexpr double openUniform(Engine& gen) noexcept {
+			return double((next64(gen) >> 11) + 1) * 0x1.0p-53;
+		}
+
+		template<typename Engine>
+		constexpr double normalSlow(Engine& gen, std::uint64_t bits) noexcept {
+			const Ziggurat& table = normalZiggurat;
+
+			while (true) {
+				double result = 0.0;
+				if (normalFast(bits, result)) {
+					return result;
+				}
+
+				std::size_t i = std::size_t(bits & 255u);
+				bool negative = bits & 256u;
+				if (i == 0) {
+					// Marsaglia's tail method
+					double a = 0.0, b = 0.0;
+					do {
+						a = -exactLog(openUniform(gen)) / table.x[1];
+						b = -exactLog(openUniform(gen));
+					} while (b + b < a * a);
+					return negative ? -(table.x[1] + a) : table.x[1] + a;
+				}
+
+				// Wedge between the layer and the curve
+				double y = table.f[i] + (table.f[i + 1] - table.f[i]) * (double(next64(gen) >> 11) * 0x1.0p-53);
+				if (y < normalDensity(result)) {
+					return result;
+				}
+
+				bits = next64(gen);
+			}
+		}
+
+		template<typename Engine>
+		constexpr double exponentialSlow(Engine& gen, std::uint64_t bits) noexcept {
+			const Ziggurat& table = exponentialZiggurat;
+			double offset = 0.0;
+
+			while (true) {
+				double result = 0.0;
+				if (exponentialFast(bits, result)) {
+					return offset + result;
+				}
+
+				std::size_t i = std::size_t(bits & 255u);
+				if (i == 0) {
+					// The tail is another exponential, shifted by x[1]
+					offset += table.x[1];
+				}
+				else {
+					double y = table.f[i] + (table.f[i + 1] - table.f[i]) * (double(next64(gen) >> 11) * 0x1.0p-53);
+					if (y < exponentialDensity(result)) {
+						return offset + result;
+					}
+				}
+
+				bits = next64(gen);
+			}
+		}
+
+		// The fill functions generate the random words in blocks of this size with the engine's fill, then convert them.
+		static constexpr std::size_t fillBlock = 256;
+	};
+
+	// Uniform integer in [0, range), using Lemire's nearly divisionless method. A range of zero returns zero.
+	template<typename Engine>
+	constexpr std::uint32_t bounded(Engine& gen, std::uint32_t range) noexcept {
+		std::uint64_t m = std::uint64_t(intern::next32(gen)) * range;
+		std::uint32_t low = std::uint32_t(m);
+		if (low < range) {
+			std::uint32_t threshold = std::uint32_t(-range) % range;
+			while (low < threshold) {
+				m = std::uint64_t(intern::next32(gen)) * range;
+				low = std::uint32_t(m);
+			}
+		}
+		return std::uint32_t(m >> 32);
+	}
+
+	// Uniform integer in [0, range), using Lemire's nearly divisionless method. A range of zero returns zero.
+	template<typename Engine>
+	constexpr std::uint64_t bounded64(Engine& gen, std::uint64_t range) noexcept {
+		std::uint64_t low = 0;
+		std::uint64_t high = intern::mulHigh64(intern::next64(gen), range, low);
+		if (low < range) {
+			std::uint64_t threshold = std::uint64_t(-range) % range;
+			while (low < threshold) {
+				high = intern::mulHigh64(intern::next64(gen), range, low);
+			}
+		}
+		return high;
+	}
+
+	// Uniform integer in [lo, hi]
+	template<typename T, typename Engine>
+	constexpr T uniformInt(Engine& gen, T lo, T hi) noexcept {
+		static_assert(std::is_integral_v<T>, "ez::prng::uniformInt requires integral types!");
+		assert(lo <= hi);
+
+		using U = std::make_unsigned_t<T>;
+		U range = U(U(hi) - U(lo));
+		if constexpr (sizeof(T) <= 4) {
+			if (range == U(~U(0)) && sizeof(T) == 4) {
+				return T(intern::next32(gen));
+			}
+			return T(U(lo) + U(bounded(gen, std::uint32_t(range) + 1u)));
+		}
+		else {
+			if (range == ~U(0)) {
+				return T(intern::next64(gen));
+			}
+			return T(U(lo) + U(bounded64(gen, std::uint64_t(range) + 1u)));
+		}
+	}
+
+	// Uniform float in [0, 1), with 23 bits of precision
+	template<typename Engine>
+	float uniformFloat(Engine& gen) noexcept {
+		return intern::bitsToFloat(intern::next32(gen));
+	}
+
+	// Uniform double in [0, 1), with 52 bits of precision
+	template<typename Engine>
+	double uniformDouble(Engine& gen) noexcept {
+		return intern::bitsToDouble(intern::next64(gen));
+	}
+
+	// Uniform value in [lo, hi)
+	template<typename T, typename Engine>
+	T uniform(Engine& gen, T lo, T hi) noexcept {
+		static_assert(std::is_floating_point_v<T>, "ez::prng::uniform requires floating point types!");
+		if constexpr (std::is_same_v<T, float>) {
+			return lo + (hi - lo) * uniformFloat(gen);
+		}
+		else {
+			return lo + (hi - lo) * T(uniformDouble(gen));
+		}
+	}
+
+	// Standard normal distribution, using a 256 layer ziggurat
+	template<typename T = double, typename Engine>
+	constexpr T normal(Engine& gen) noexcept {
+		static_assert(std::is_floating_point_v<T>, "ez::prng::normal requires floating point types!");
+		return T(intern::normalSlow(gen, intern::next64(gen)));
+	}
+
+	template<typename T = double, typename Engine>
+	constexpr T normal(Engine& gen, T mean, T stddev) noexcept {
+		return mean + stddev * normal<T>(gen);
+	}
+
+	// Exponential distribution with rate 1, using a 256 layer ziggurat
+	template<typename T = double, typename Engine>
+	constexpr T exponential(Engine& gen) noexcept {
+		static_assert(std::is_floating_point_v<T>, "ez::prng::exponential requires floating point types!");
+		return T(intern::exponentialSlow(gen, intern::next64(gen)));
+	}
+
+	template<typename T = double, typename Engine>
+	constexpr T exponential(Engine& gen, T rate) noexcept {
+		return exponential<T>(gen) / rate;
+	}
+
+	// Fills out with uniform integers in [0, range). The bulk of the work is branch free,
+	// only the rare values that would be biased are drawn again afterwards.
+	template<typename Engine>
+	void fillBounded(Engine& gen, std::uint32_t* out, std::size_t count, std::uint32_t range) noexcept {
+		using W = typename Engine::result_type;
+		constexpr int shift = sizeof(W) == 8 ? 32 : 0;
+		W words[intern::fillBlock];
+		bool retry[intern::fillBlock];
+
+		for (std::size_t first = 0; first < count; first += intern::fillBlock) {
+			std::size_t n = std::min(intern::fillBlock, count - first);
+			gen.fill(words, n);
+
+			EZ_MATH_VECTORIZE
+			for (std::size_t i = 0; i < n; ++i) {
+				std::uint64_t m = std::uint64_t(std::uint32_t(words[i] >> shift)) * range;
+				out[first + i] = std::uint32_t(m >> 32);
+				retry[i] = std::uint32_t(m) < range;
+			}
+
+			for (std::size_t i = 0; i < n; ++i) {
+				if (retry[i]) {
+					std::uint32_t threshold = std::uint32_t(-range) % range;
+					std::uint64_t m = std::uint64_t(std::uint32_t(words[i] >> shift)) * range;
+					if (std::uint32_t(m) < threshold) {
+						out[first + i] = bounded(gen, range);
+					}
+				}
+			}
+		}
+	}
+
+	// Fills out with uniform values in [0, 1)
+	template<typename Engine>
+	void fillUniform(Engine& gen, float* out, std::size_t count) noexcept {
+		using W = typename Engine::result_type;
+		constexpr int shift = sizeof(W) == 8 ? 32 : 0;
+		W words[intern::fillBlock];
+
+		for (std::size_t first = 0; first < count; first += intern::fillBlock) {
+			std::size_t n = std::min(intern::fillBlock, count - first);
+			gen.fill(words, n);
+
+			EZ_MATH_VECTORIZE
+			for (std::size_t i = 0; i < n; ++i) {
+				out[first + i] = intern::bitsToFloat(std::uint32_t(words[i] >> shift));
+			}
+		}
+	}
+
+	// Fills out with uniform values in [0, 1)
+	template<typename Engine>
+	void fillUniform(Engine& gen, double* out, std::size_t count) noexcept {
+		using W = typename Engine::result_type;
+		constexpr std::size_t per = sizeof(std::uint64_t) / sizeof(W);
+		W words[intern::fillBlock * per];
+
+		for (std::size_t first = 0; first < count; first += intern::fillBlock) {
+			std::size_t n = std::min(intern::fillBlock, count - first);
+			gen.fill(words, n * per);
+
+			EZ_MATH_VECTORIZE
+			for (std::size_t i = 0; i < n; ++i) {
+				std::uint64_t bits = per == 1 ? std::uint64_t(words[i]) : (std::uint64_t(words[i * per]) << 32) | std::uint64_t(words[i * per + per - 1]);
+				out[first + i] = intern::bitsToDouble(bits);
+			}
+		}
+	}
+
+	// Fills out with standard normal values. Samples that land outside the ziggurat's layers are redrawn afterwards.
+	template<typename T, typename Engine>
+	void fillNormal(Engine& gen, T* out, std::size_t count) noexcept {
+		static_assert(std::is_floating_point_v<T>, "ez::prng::fillNormal requires floating point types!");
+		using W = typename Engine::result_type;
+		constexpr std::size_t per = sizeof(std::uint64_t) / sizeof(W);
+		W words[intern::fillBlock * per];
+		std::uint64_t bits[intern::fillBlock];
+		bool slow[intern::fillBlock];
+
+		for (std::size_t first = 0; first < count; first += intern::fillBlock) {
+			std::size_t n = std::min(intern::fillBlock, count - first);
+			gen.fill(words, n * per);
+
+			EZ_MATH_VECTORIZE
+			for (std::size_t i = 0; i < n; ++i) {
+				bits[i] = per == 1 ? std::uint64_t(words[i]) : (std::uint64_t(words[i * per]) << 32) | std::uint64_t(words[i * per + per - 1]);
+				double value = 0.0;
+				slow[i] = !intern::normalFast(bits[i], value);
+				out[first + i] = T(value);
+			}
+
+			for (std::size_t i = 0; i < n; ++i) {
+				if (slow[i]) {
+					out[first + i] = T(intern::normalSlow(gen, bits[i]));
+				}
+			}
+		}
+	}
+
+	// Fills out with exponential values with rate 1. Samples that land outside the ziggurat's layers are redrawn afterwards.
+	template<typename T, typename Engine>
+	void fillExponential(Engine& gen, T* out, std::size_t count) noexcept {
+		static_assert(std::is_floating_point_v<T>, "ez::prng::fillExponential requires floating point types!");
+		using W = typename Engine::result_type;
+		constexpr std::size_t per = sizeof(std::uint64_t) / sizeof(W);
+		W words[intern::fillBlock * per];
+		std::uint64_t bits[intern::fillBlock];
+		bool slow[intern::fillBlock];
+
+		for (std::size_t first = 0; first < count; first += intern::fillBlock) {
+			std::size_t n = std::min(intern::fillBlock, count - first);
+			gen.fill(words, n * per);
+
+			EZ_MATH_VECTORIZE
+			for (std::size_t i = 0; i < n; ++i) {
+				bits[i] = per == 1 ? std::uint64_t(words[i]) : (std::uint64_t(words[i * per]) << 32) | std::uint64_t(words[i * per + per - 1]);
+				double value = 0.0;
+				slow[i] = !intern::exponentialFast(bits[i], value);
+				out[first + i] = T(value);
+			}
+
+			for (std::size_t i = 0; i < n; ++i) {
+				if (slow[i]) {
+					out[first + i] = T(intern::exponentialSlow(gen, bits[i]));
+				}
+			}
+		}
+	}
+};
\ No newline at end of file
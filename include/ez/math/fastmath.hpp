@@ -0,0 +1,431 @@
+#pragma once
+#include <algorithm>
+#include <cinttypes>
+#include <cstddef>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+#include "simd.hpp"
+
+/*
+	Polynomial approximations of the common elementary functions, for when libm is too slow.
+	Every function takes a compile time precision tier, so the cost only covers the accuracy that is needed.
+	The kernels are branch free, so the array overloads vectorize, and the scalar versions inline into user loops.
+
+	sin, cos, sincos and atan2 are constexpr. exp, log and pow need to manipulate the exponent bits directly, so they are not.
+
+	The tiers are tuned for float. Double arguments are computed in double, but are no more accurate than the tier.
+	sin and cos reduce their argument by pi / 2 in the argument's own type, so accuracy degrades for floats
+	larger than about 2^16, and doubles larger than about 2^30. Past 2^22 quarter turns for floats and 2^30 for doubles the argument counts as zero.
+	Infinities and nan are propagated by exp, log and pow. sin and cos of either are nan, and atan2 does not handle them.
+*/
+
+namespace ez::fastmath {
+	// Error targets for the approximations.
+	// The error is absolute for sin, cos and atan2, and relative for exp, log and pow.
+	enum class Precision {
+		// About 1e-3
+		Low,
+		// About 1e-5
+		Medium,
+		// A few ulp of float
+		Full,
+	};
+
+	namespace intern {
+		// Horner's scheme, unrolled at compile time so the lane loops stay free of inner loops
+		template<std::size_t I = 0, typename T, std::size_t N>
+		constexpr T horner(T x, const double(&c)[N]) noexcept {
+			if constexpr (I + 1 == N) {
+				return T(c[I]);
+			}
+			else {
+				return horner<I + 1>(x, c) * x + T(c[I]);
+			}
+		}
+
+		using ez::simd::roundMagic;
+
+		template<typename T>
+		constexpr T abs(T x) noexcept {
+			return x < T(0) ? -x : x;
+		}
+
+		// Layout of the floating point types, for the functions that build or take apart the exponent.
+		// Exponents are kept in 32 bit integers for both types, since vector conversions between double and 64 bit integers need AVX-512.
+		template<typename T>
+		struct FloatBits;
+
+		template<>
+		struct FloatBits<float> {
+			using Uint = std::uint32_t;
+			static constexpr int mantissa = 23;
+			static constexpr int bias = 127;
+			static constexpr Uint exponentMask = 0xFFu;
+		};
+		template<>
+		struct FloatBits<double> {
+			using Uint = std::uint64_t;
+			static constexpr int mantissa = 52;
+			static constexpr int bias = 1023;
+			static constexpr Uint exponentMask = 0x7FFu;
+		};
+
+		template<typename T>
+		EZ_MATH_INLINE T pow2(std::int32_t n) noexcept {
+			using Bits = FloatBits<T>;
+			typename Bits::Uint bits = typename Bits::Uint(n + Bits::bias) << Bits::mantissa;
+			T result;
+			std::memcpy(&result, &bits, sizeof(T));
+			return result;
+		}
+
+		using ez::simd::select;
+
+		// sin(r) and cos(r) for r in [-pi/4, pi/4]
+		template<Precision P, typename T>
+		constexpr T sinPoly(T r) noexcept {
+			T r2 = r * r;
+			if constexpr (P == Precision::Low) {
+				constexpr double c[] = { 0.9990314229131829, -0.16034401672346188 };
+				return r * horner(r2, c);
+			}
+			else if constexpr (P == Precision::Medium) {
+				constexpr double c[] = { 0.9999949975616433, -0.16660161988235425, 0.00812155792462514 };
+				return r * horner(r2, c);
+			}
+			else {
+				// Keeps the leading term exact, so small angles are accurate to the ulp
+				constexpr double c[] = { -0.16666654943701148, 0.00833217814613985, -0.00019517298981383516 };
+				return r + r * r2 * horner(r2, c);
+			}
+		}
+
+		template<Precision P, typename T>
+		constexpr T cosPoly(T r) noexcept {
+			T r2 = r * r;
+			if constexpr (P == Precision::Low) {
+				constexpr double c[] = { 0.9999900349553448, -0.49970814035693445, 0.04039853596906776 };
+				return horner(r2, c);
+			}
+			else if constexpr (P == Precision::Medium) {
+				constexpr double c[] = { 0.9999999724233232, -0.49999856695849865, 0.04165502688429943, -0.0013585908510622608 };
+				return horner(r2, c);
+			}
+			else {
+				constexpr double c[] = { 0.04166664686644229, -0.0013887367515731102, 2.443845159363396e-05 };
+				return T(1) - T(0.5) * r2 + r2 * r2 * horner(r2, c);
+			}
+		}
+
+		// Reduces x by multiples of pi / 2, returning the remainder in [-pi/4, pi/4] and the quadrant in [0, 3]
+		template<typename T>
+		constexpr T reduceQuadrant(T x, int& quadrant) noexcept {
+			constexpr T invHalfPi = T(0.63661977236758134308);
+			T k = roundMagic(x * invHalfPi);
+
+			// Past the range where roundMagic is exact for float, and int for double, no precision is left in the remainder,
+			// and converting k to int is undefined for nan and infinities. Those are reduced to x - x instead, which is zero for finite x and nan otherwise.
+			constexpr T limit = std::is_same_v<T, float> ? T(1 << 22) : T(1 << 30);
+			bool inRange = abs(k) < limit;
+			k = inRange ? k : T(0);
+			quadrant = int(k) & 3;
+
+			// pi / 2 split into parts, so that the products with k are exact
+			T r = x;
+			if constexpr (std::is_same_v<T, float>) {
+				constexpr float parts[] = { 1.5703125f, 4.837512969970703125e-4f, 7.54978995489188216e-8f };
+				r = ez::simd::subtractSplit(x, k, parts);
+			}
+			else {
+				constexpr double parts[] = { 1.57079632673412561417e+00, 6.07710050630396597660e-11, 2.02226624871116645580e-21 };
+				r = ez::simd::subtractSplit(x, k, parts);
+			}
+			return inRange ? r : x - x;
+		}
+
+		// atan(a) for a in [0, 1]
+		template<Precision P, typename T>
+		constexpr T atanPoly(T a) noexcept {
+			T a2 = a * a;
+			if constexpr (P == Precision::Low) {
+				constexpr double c[] = { 0.9953579547504575, -0.28869023801218546, 0.07933904141898554 };
+				return a * horner(a2, c);
+			}
+			else if constexpr (P == Precision::Medium) {
+				constexpr double c[] = {
+					0.9999772190822531, -0.3326228278902581, 0.19354037608394165,
+					-0.11642648197002207, 0.05264735146595904, -0.011719135734284498
+				};
+				return a * horner(a2, c);
+			}
+			else {
+				constexpr double c[] = {
+					-0.33333152736084093, 0.19993772837223447, -0.1421105533759908, 0.10666004787707194,
+					-0.07552214630569236, 0.043211865138518414, -0.0163679307830229, 0.002920692950026228
+				};
+				return a + a * a2 * horner(a2, c);
+			}
+		}
+
+		// exp(r) for r in [-ln2 / 2, ln2 / 2]
+		template<Precision P, typename T>
+		constexpr T expPoly(T r) noexcept {
+			if constexpr (P == Precision::Low) {
+				constexpr double c[] = { 0.9999280735404956, 1.0001641857610948, 0.5049632641822398, 0.16566842347964333 };
+				return horner(r, c);
+			}
+			else if constexpr (P == Precision::Medium) {
+				constexpr double c[] = { 0.9999992614457144, 0.9999634048526979, 0.5000435866145754, 0.16790907215230025, 0.04145860818751203 };
+				return horner(r, c);
+			}
+			else {
+				constexpr double c[] = {
+					1.0000000005541665, 1.0000000363231976, 0.49999992079816696, 0.16666420169849686,
+					0.04166822556952568, 0.008374815804362865, 0.0013836845990719037
+				};
+				return horner(r, c);
+			}
+		}
+
+		// log(m) for m in [sqrt(1/2), sqrt(2)], written in terms of s = (m - 1) / (m + 1), since log(m) = 2 atanh(s)
+		template<Precision P, typename T>
+		constexpr T logPoly(T s) noexcept {
+			T s2 = s * s;
+			if constexpr (P == Precision::Low) {
+				constexpr double c[] = { 0.6766044075601064 };
+				return T(2) * s + s * s2 * horner(s2, c);
+			}
+			else if constexpr (P == Precision::Medium) {
+				constexpr double c[] = { 0.6665562201397753, 0.4120199457875195 };
+				return T(2) * s + s * s2 * horner(s2, c);
+			}
+			else {
+				constexpr double c[] = { 0.6666677608549204, 0.39977574015631206, 0.29870937247222673 };
+				return T(2) * s + s * s2 * horner(s2, c);
+			}
+		}
+
+		template<typename T>
+		struct Ln2 {
+			static constexpr T hi = T(0.693359375);
+			static constexpr T lo = T(-2.12194440e-4);
+		};
+		template<>
+		struct Ln2<double> {
+			static constexpr double hi = 6.93147180369123816490e-01;
+			static constexpr double lo = 1.90821492927058770002e-10;
+		};
+	};
+
+	template<Precision P = Precision::Full, typename T>
+	EZ_MATH_INLINE constexpr void sincos(T x, T& sinOut, T& cosOut) noexcept {
+		static_assert(std::is_floating_point_v<T>, "ez::fastmath::sincos requires floating point types!");
+
+		int quadrant = 0;
+		T r = intern::reduceQuadrant(x, quadrant);
+		T s = intern::sinPoly<P>(r);
+		T c = intern::cosPoly<P>(r);
+
+		// Rotate by the quadrant, (s, c) -> (c, -s) -> (-s, -c) -> (-c, s)
+		T odd = T(quadrant & 1);
+		T sinValue = s * (T(1) - odd) + c * odd;
+		T cosValue = c * (T(1) - odd) + s * odd;
+		sinOut = sinValue * T(1 - (quadrant & 2));
+		cosOut = cosValue * T(1 - ((quadrant + 1) & 2));
+	}
+
+	template<Precision P = Precision::Full, typename T>
+	EZ_MATH_INLINE constexpr T sin(T x) noexcept {
+		static_assert(std::is_floating_point_v<T>, "ez::fastmath::sin requires floating point types!");
+
+		int quadrant = 0;
+		T r = intern::reduceQuadrant(x, quadrant);
+		// Both polynomials are evaluated and blended, the compiler would move a plain select back into branches
+		T s = intern::sinPoly<P>(r);
+		T c = intern::cosPoly<P>(r);
+		T odd = T(quadrant & 1);
+		return (s * (T(1) - odd) + c * odd) * T(1 - (quadrant & 2));
+	}
+
+	template<Precision P = Precision::Full, typename T>
+	EZ_MATH_INLINE constexpr T cos(T x) noexcept {
+		static_assert(std::is_floating_point_v<T>, "ez::fastmath::cos requires floating point types!");
+
+		int quadrant = 0;
+		T r = intern::reduceQuadrant(x, quadrant);
+		T s = intern::sinPoly<P>(r);
+		T c = intern::cosPoly<P>(r);
+		T odd = T(quadrant & 1);
+		return (c * (T(1) - odd) + s * odd) * T(1 - ((quadrant + 1) & 2));
+	}
+
+	// The angle of the point (x, y), in the range [-pi, pi]. atan2(0, 0) is zero.
+	template<Precision P = Precision::Full, typename T>
+	EZ_MATH_INLINE constexpr T atan2(T y, T x) noexcept {
+		static_assert(std::is_floating_point_v<T>, "ez::fastmath::atan2 requires floating point types!");
+		constexpr T pi = T(3.14159265358979323846);
+
+		T ax = intern::abs(x);
+		T ay = intern::abs(y);
+		bool steep = ay > ax;
+		T high = steep ? ay : ax;
+		T low = steep ? ax : ay;
+		// Adding the smallest normal keeps 0 / 0 out, without a select on the divisor
+		T r = intern::atanPoly<P>(low / (high + std::numeric_limits<T>::min()));
+
+		// The octant fixups only select constants, the arithmetic is unconditional so it stays branch free
+		r = (steep ? pi / T(2) : T(0)) + (steep ? T(-1) : T(1)) * r;
+		r = (x < T(0) ? pi : T(0)) + (x < T(0) ? T(-1) : T(1)) * r;
+		return (y < T(0) ? T(-1) : T(1)) * r;
+	}
+
+	template<Precision P = Precision::Full, typename T>
+	EZ_MATH_INLINE T exp(T x) noexcept {
+		static_assert(std::is_floating_point_v<T>, "ez::fastmath::exp requires floating point types!");
+		constexpr T log2e = T(1.44269504088896340736);
+
+		// Past these limits the result is zero or infinity anyway, clamping keeps the exponent math in range
+		constexpr T low = std::is_same_v<T, float> ? T(-104) : T(-746);
+		constexpr T high = std::is_same_v<T, float> ? T(89) : T(710);
+		T clamped = intern::select(x < low, low, x);
+		clamped = intern::select(clamped > high, high, clamped);
+
+		T k = intern::roundMagic(clamped * log2e);
+#if defined(__FAST_MATH__)
+		// Keeps the two parts of ln2 apart, as in intern::reduceQuadrant
+		T r = std::fma(-k, intern::Ln2<T>::lo, std::fma(-k, intern::Ln2<T>::hi, clamped));
+#else
+		T r = (clamped - k * intern::Ln2<T>::hi) - k * intern::Ln2<T>::lo;
+#endif
+		T p = intern::expPoly<P>(r);
+
+		// Scale in two steps, so that results that overflow or are subnormal come out right.
+		// A nan k is undefined to convert, so it scales by one, p is nan already.
+		std::int32_t n = std::int32_t(intern::select(k == k, k, T(0)));
+		std::int32_t half = n / 2;
+		return p * intern::pow2<T>(half) * intern::pow2<T>(n - half);
+	}
+
+	// The natural logarithm. Zero gives -infinity, and negative values nan.
+	template<Precision P = Precision::Full, typename T>
+	EZ_MATH_INLINE T log(T x) noexcept {
+		static_assert(std::is_floating_point_v<T>, "ez::fastmath::log requires floating point types!");
+		using Bits = intern::FloatBits<T>;
+		using Uint = typename Bits::Uint;
+		constexpr T sqrt2 = T(1.41421356237309504880);
+
+		// Subnormals are scaled up into the normal range first
+		bool subnormal = x < std::numeric_limits<T>::min();
+		T scaled = x * intern::select(subnormal, T(Uint(1) << Bits::mantissa), T(1));
+
+		Uint bits;
+		std::memcpy(&bits, &scaled, sizeof(T));
+		std::int32_t e = std::int32_t((bits >> Bits::mantissa) & Bits::exponentMask) - Bits::bias - (subnormal ? Bits::mantissa : 0);
+		bits = (bits & ((Uint(1) << Bits::mantissa) - 1)) | (Uint(Bits::bias) << Bits::mantissa);
+		T m;
+		std::memcpy(&m, &bits, sizeof(T));
+
+		// Center the mantissa on one
+		bool big = m > sqrt2;
+		m *= intern::select(big, T(0.5), T(1));
+		e += big ? 1 : 0;
+
+		T fe = T(e);
+		T lm = intern::logPoly<P>((m - T(1)) / (m + T(1)));
+		T result = fe * intern::Ln2<T>::hi + (lm + fe * intern::Ln2<T>::lo);
+
+		result = intern::select(x == T(0), -std::numeric_limits<T>::infinity(), result);
+		result = intern::select(x < T(0), std::numeric_limits<T>::quiet_NaN(), result);
+		return intern::select(x < std::numeric_limits<T>::infinity(), result, x);
+	}
+
+	// x raised to the power y, for non negative x. pow(x, 0) is one.
+	// At full precision float arguments are computed in double, since the error of log(x) is scaled by y.
+	template<Precision P = Precision::Full, typename T>
+	EZ_MATH_INLINE T pow(T x, T y) noexcept {
+		static_assert(std::is_floating_point_v<T>, "ez::fastmath::pow requires floating point types!");
+		using W = std::conditional_t<P == Precision::Full, double, T>;
+
+		T result = T(exp<P>(W(y) * log<P>(W(x))));
+		return intern::select(y == T(0), T(1), result);
+	}
+
+	// Array versions, out may be the same array as the input.
+	template<Precision P = Precision::Full, typename T>
+	void sin(const T* x, T* out, std::size_t count) noexcept {
+		EZ_MATH_VECTORIZE
+		for (std::size_t i = 0; i < count; ++i) {
+			out[i] = sin<P>(x[i]);
+		}
+	}
+
+	template<Precision P = Precision::Full, typename T>
+	void cos(const T* x, T* out, std::size_t count) noexcept {
+		EZ_MATH_VECTORIZE
+		for (std::size_t i = 0; i < count; ++i) {
+			out[i] = cos<P>(x[i]);
+		}
+	}
+
+	template<Precision P = Precision::Full, typename T>
+	void sincos(const T* x, T* sinOut, T* cosOut, std::size_t count) noexcept {
+		EZ_MATH_VECTORIZE
+		for (std::size_t i = 0; i < count; ++i) {
+			T s = T(0), c = T(0);
+			sincos<P>(x[i], s, c);
+			sinOut[i] = s;
+			cosOut[i] = c;
+		}
+	}
+
+	template<Precision P = Precision::Full, typename T>
+	void atan2(const T* y, const T* x, T* out, std::size_t count) noexcept {
+		EZ_MATH_VECTORIZE
+		for (std::size_t i = 0; i < count; ++i) {
+			out[i] = atan2<P>(y[i], x[i]);
+		}
+	}
+
+	template<Precision P = Precision::Full, typename T>
+	void exp(const T* x, T* out, std::size_t count) noexcept {
+		EZ_MATH_VECTORIZE
+		for (std::size_t i = 0; i < count; ++i) {
+			out[i] = exp<P>(x[i]);
+		}
+	}
+
+	template<Precision P = Precision::Full, typename T>
+	void log(const T* x, T* out, std::size_t count) noexcept {
+		EZ_MATH_VECTORIZE
+		for (std::size_t i = 0; i < count; ++i) {
+			out[i] = log<P>(x[i]);
+		}
+	}
+
+	// Runs log and exp as separate passes over a block, so each pass is a single small loop that vectorizes on its own
+	template<Precision P = Precision::Full, typename T>
+	void pow(const T* x, const T* y, T* out, std::size_t count) noexcept {
+		using W = std::conditional_t<P == Precision::Full, double, T>;
+		constexpr std::size_t block = 256;
+		W temp[block];
+
+		for (std::size_t first = 0; first < count; first += block) {
+			std::size_t n = std::min(block, count - first);
+
+			for (std::size_t i = 0; i < n; ++i) {
+				temp[i] = W(x[first + i]);
+			}
+			log<P>(temp, temp, n);
+			for (std::size_t i = 0; i < n; ++i) {
+				temp[i] *= W(y[first + i]);
+			}
+			exp<P>(temp, temp, n);
+
+			EZ_MATH_VECTORIZE
+			for (std::size_t i = 0; i < n; ++i) {
+				out[first + i] = intern::select(y[first + i] == T(0), T(1), T(temp[i]));
+			}
+		}
+	}
+};
\ No newline at end of file
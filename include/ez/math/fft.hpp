@@ -0,0 +1,612 @@
+#pragma once
+#include <cstddef>
+#include <cassert>
+#include <cmath>
+#include <memory>
+#include <vector>
+#include <atomic>
+#include <thread>
+#include <algorithm>
+#include <type_traits>
+#include "constants.hpp"
+#include "complex.hpp"
+#include "complex_array.hpp"
+#include "simd.hpp"
+
+/*
+	Fast fourier transforms on complex float and double data.
+
+	A plan is created once per transform size, precomputing the twiddle factors and allocating its scratch space,
+	and can then be executed any number of times. Power of two sizes use radix 4 Stockham stages, with a single
+	radix 2 stage when the size is an odd power of two. The Stockham form writes every stage in natural order,
+	so there is no bit reversal pass, and the inner loops run over contiguous memory. Every other size uses Bluestein's
+	algorithm, which turns the transform into a convolution computed with a power of two plan.
+
+	The plans work on split real and imaginary arrays (see ez::ComplexArray), with overloads for interleaved glm::tcomplex buffers.
+	The forward transform is unscaled, X[k] = sum x[j] * exp(-2 pi i j k / n), and the inverse is scaled by 1 / n,
+	so that inverse(forward(x)) gives back x.
+
+	Executing a plan modifies its scratch space, so a plan must not be executed by several threads at once.
+*/
+
+namespace ez::fft {
+	namespace intern {
+		constexpr bool isPowerOfTwo(std::size_t n) noexcept {
+			return n != 0 && (n & (n - 1)) == 0;
+		}
+
+		constexpr std::size_t nextPowerOfTwo(std::size_t n) noexcept {
+			std::size_t result = 1;
+			while (result < n) {
+				result *= 2;
+			}
+			return result;
+		}
+
+		// exp(-2 pi i k / n), computed in a wider type than T
+		template<typename T>
+		glm::tcomplex<T> twiddle(std::size_t k, std::size_t n) {
+			using wide_t = std::conditional_t<std::is_same_v<T, float>, double, long double>;
+			wide_t angle = -ez::tau<wide_t>() * wide_t(k % n) / wide_t(n);
+			return glm::tcomplex<T>{ T(std::cos(angle)), T(std::sin(angle)) };
+		}
+
+		// Complex multiply in place
+		template<typename T>
+		EZ_MATH_INLINE void multiply(T& re, T& im, T wr, T wi) noexcept {
+			T tr = re * wr - im * wi;
+			im = re * wi + im * wr;
+			re = tr;
+		}
+
+		// One radix 4 decimation in frequency butterfly.
+		// Reads x[in + k * quarter] and writes y[out + k * s], for k in [0, 4)
+		template<typename T>
+		EZ_MATH_INLINE void butterfly4(
+			const T* xr, const T* xi, T* yr, T* yi,
+			std::size_t in, std::size_t out, std::size_t quarter, std::size_t s,
+			T w1r, T w1i, T w2r, T w2i, T w3r, T w3i) noexcept
+		{
+			T ar = xr[in], ai = xi[in];
+			T br = xr[in + quarter], bi = xi[in + quarter];
+			T cr = xr[in + 2 * quarter], ci = xi[in + 2 * quarter];
+			T dr = xr[in + 3 * quarter], di = xi[in + 3 * quarter];
+
+			T apcr = ar + cr, apci = ai + ci;
+			T amcr = ar - cr, amci = ai - ci;
+			T bpdr = br + dr, bpdi = bi + di;
+			// i * (b - d)
+			T jbmdr = di - bi, jbmdi = br - dr;
+
+			T r1 = amcr - jbmdr, i1 = amci - jbmdi;
+			T r2 = apcr - bpdr, i2 = apci - bpdi;
+			T r3 = amcr + jbmdr, i3 = amci + jbmdi;
+			multiply(r1, i1, w1r, w1i);
+			multiply(r2, i2, w2r, w2i);
+			multiply(r3, i3, w3r, w3i);
+
+			yr[out] = apcr + bpdr;
+			yi[out] = apci + bpdi;
+			yr[out + s] = r1;
+			yi[out + s] = i1;
+			yr[out + 2 * s] = r2;
+			yi[out + 2 * s] = i2;
+			yr[out + 3 * s] = r3;
+			yi[out + 3 * s] = i3;
+		}
+
+		// A radix 4 Stockham stage, transforming sequences of length len spaced stride apart.
+		// w holds the twiddles w^p, w^2p and w^3p for p in [0, len / 4), one after the other.
+		template<typename T>
+		void radix4(std::size_t len, std::size_t stride, const T* xr, const T* xi, T* yr, T* yi, const T* wr, const T* wi) noexcept {
+			std::size_t m = len / 4, s = stride;
+			const T* w1r = wr, * w2r = wr + m, * w3r = wr + 2 * m;
+			const T* w1i = wi, * w2i = wi + m, * w3i = wi + 2 * m;
+
+			if (s == 1) {
+				// The first stage, vectorize across the butterflies instead
+				EZ_MATH_VECTORIZE
+				for (std::size_t p = 0; p < m; ++p) {
+					butterfly4(xr, xi, yr, yi, p, 4 * p, m, 1, w1r[p], w1i[p], w2r[p], w2i[p], w3r[p], w3i[p]);
+				}
+				return;
+			}
+
+			for (std::size_t p = 0; p < m; ++p) {
+				T t1r = w1r[p], t1i = w1i[p], t2r = w2r[p], t2i = w2i[p], t3r = w3r[p], t3i = w3i[p];
+
+				EZ_MATH_VECTORIZE
+				for (std::size_t q = 0; q < s; ++q) {
+					butterfly4(xr, xi, yr, yi, q + s * p, q + s * 4 * p, s * m, s, t1r, t1i, t2r, t2i, t3r, t3i);
+				}
+			}
+		}
+
+		// The final radix 2 stage, for odd powers of two. All of its twiddles are one.
+		template<typename T>
+		void radix2(std::size_t stride, const T* xr, const T* xi, T* yr, T* yi) noexcept {
+			std::size_t s = stride;
+
+			EZ_MATH_VECTORIZE
+			for (std::size_t q = 0; q < s; ++q) {
+				T ar = xr[q], ai = xi[q];
+				T br = xr[q + s], bi = xi[q + s];
+				yr[q] = ar + br;
+				yi[q] = ai + bi;
+				yr[q + s] = ar - br;
+				yi[q + s] = ai - bi;
+			}
+		}
+
+		template<typename T>
+		void scale(T* re, T* im, std::size_t count, T factor) noexcept {
+			EZ_MATH_VECTORIZE
+			for (std::size_t i = 0; i < count; ++i) {
+				re[i] *= factor;
+				im[i] *= factor;
+			}
+		}
+
+		// Run work(index, thread) for every index in [0, count), using up to threads threads including the calling one
+		template<typename F>
+		void parallelFor(std::size_t count, unsigned threads, F&& work) {
+			threads = unsigned(std::min<std::size_t>(threads, count));
+			if (threads <= 1) {
+				for (std::size_t i = 0; i < count; ++i) {
+					work(i, 0u);
+				}
+				return;
+			}
+
+			std::atomic<std::size_t> next{ 0 };
+			auto worker = [&next, &work, count](unsigned thread) {
+				for (std::size_t i = next++; i < count; i = next++) {
+					work(i, thread);
+				}
+			};
+
+			std::vector<std::thread> workers;
+			workers.reserve(threads - 1);
+			for (unsigned i = 1; i < threads; ++i) {
+				workers.emplace_back(worker, i);
+			}
+			worker(0u);
+			for (std::thread& thread : workers) {
+				thread.join();
+			}
+		}
+	};
+
+	// Complex to complex transform of a fixed size
+	template<typename T>
+	class Plan {
+	public:
+		static_assert(std::is_floating_point_v<T>, "ez::fft::Plan requires floating point types!");
+		using complex_t = glm::tcomplex<T>;
+
+		Plan() = default;
+
+		explicit Plan(std::size_t size)
+			: size_(size)
+			, work_(size)
+		{
+			if (intern::isPowerOfTwo(size)) {
+				initPowerOfTwo();
+			}
+			else if (size > 0) {
+				initBluestein();
+			}
+		}
+
+		std::size_t size() const noexcept {
+			return size_;
+		}
+
+		// Transform size() values. The input and output arrays may be the same.
+		void forward(const T* inRe, const T* inIm, T* outRe, T* outIm) {
+			transform(inRe, inIm, outRe, outIm);
+		}
+		void inverse(const T* inRe, const T* inIm, T* outRe, T* outIm) {
+			// The inverse transform is the forward transform with the real and imaginary parts exchanged
+			transform(inIm, inRe, outIm, outRe);
+			intern::scale(outRe, outIm, size_, T(1) / T(size_));
+		}
+
+		void forward(const ComplexArray<T>& in, ComplexArray<T>& out) {
+			assert(in.size() == size_);
+			out.resize(size_);
+			forward(in.real(), in.imag(), out.real(), out.imag());
+		}
+		void inverse(const ComplexArray<T>& in, ComplexArray<T>& out) {
+			assert(in.size() == size_);
+			out.resize(size_);
+			inverse(in.real(), in.imag(), out.real(), out.imag());
+		}
+
+		// Interleaved data is split into the plan's own buffer, and merged again afterwards
+		void forward(const complex_t* in, complex_t* out) {
+			deinterleave(in, work_.real(), work_.imag(), size_);
+			forward(work_.real(), work_.imag(), work_.real(), work_.imag());
+			interleave(work_.real(), work_.imag(), out, size_);
+		}
+		void inverse(const complex_t* in, complex_t* out) {
+			deinterleave(in, work_.real(), work_.imag(), size_);
+			inverse(work_.real(), work_.imag(), work_.real(), work_.imag());
+			interleave(work_.real(), work_.imag(), out, size_);
+		}
+	private:
+		void initPowerOfTwo() {
+			scratch_.resize(size_);
+
+			for (std::size_t len = size_; len >= 4; len /= 4) {
+				std::size_t m = len / 4;
+				for (std::size_t k = 1; k <= 3; ++k) {
+					for (std::size_t p = 0; p < m; ++p) {
+						complex_t w = intern::twiddle<T>(k * p, len);
+						twiddleRe_.push_back(w.real());
+						twiddleIm_.push_back(w.imag());
+					}
+				}
+			}
+		}
+
+		void initBluestein() {
+			std::size_t m = intern::nextPowerOfTwo(2 * size_ - 1);
+			inner_ = std::make_unique<Plan>(m);
+			chirp_.resize(size_);
+			kernel_.resize(m);
+			padded_.resize(m);
+
+			// exp(-pi i k^2 / n), with k^2 reduced modulo 2n while it is still exact
+			for (std::size_t k = 0; k < size_; ++k) {
+				chirp_.set(k, intern::twiddle<T>((k * k) % (2 * size_), 2 * size_));
+			}
+
+			// The conjugate chirp, wrapped around so that the circular convolution matches the linear one.
+			// The 1 / m of the inverse transform is folded in here.
+			T scale = T(1) / T(m);
+			kernel_.set(0, std::conj(chirp_[0]) * scale);
+			for (std::size_t k = 1; k < size_; ++k) {
+				complex_t value = std::conj(chirp_[k]) * scale;
+				kernel_.set(k, value);
+				kernel_.set(m - k, value);
+			}
+			inner_->transform(kernel_.real(), kernel_.imag(), kernel_.real(), kernel_.imag());
+		}
+
+		// The unscaled forward transform
+		void transform(const T* inRe, const T* inIm, T* outRe, T* outIm) {
+			if (size_ <= 1) {
+				if (size_ == 1) {
+					outRe[0] = inRe[0];
+					outIm[0] = inIm[0];
+				}
+			}
+			else if (inner_) {
+				bluestein(inRe, inIm, outRe, outIm);
+			}
+			else {
+				powerOfTwo(inRe, inIm, outRe, outIm);
+			}
+		}
+
+		void powerOfTwo(const T* inRe, const T* inIm, T* outRe, T* outIm) {
+			std::size_t stages = 0, len = size_;
+			for (; len >= 4; len /= 4) {
+				++stages;
+			}
+			stages += len == 2;
+
+			// Ping pong between the output and the scratch, choosing the first target so that the last stage writes the output
+			T* re[2] = { outRe, scratch_.real() };
+			T* im[2] = { outIm, scratch_.imag() };
+			int target = stages % 2 == 1 ? 0 : 1;
+
+			const T* srcRe = inRe, * srcIm = inIm;
+			if (target == 0 && inRe == outRe) {
+				std::copy(inRe, inRe + size_, scratch_.real());
+				std::copy(inIm, inIm + size_, scratch_.imag());
+				srcRe = scratch_.real();
+				srcIm = scratch_.imag();
+			}
+
+			const T* wr = twiddleRe_.data(), * wi = twiddleIm_.data();
+			std::size_t stride = 1;
+			for (len = size_; len >= 4; len /= 4) {
+				intern::radix4(len, stride, srcRe, srcIm, re[target], im[target], wr, wi);
+				wr += 3 * (len / 4);
+				wi += 3 * (len / 4);
+				srcRe = re[target];
+				srcIm = im[target];
+				target ^= 1;
+				stride *= 4;
+			}
+			if (len == 2) {
+				intern::radix2(stride, srcRe, srcIm, re[target], im[target]);
+			}
+		}
+
+		void bluestein(const T* inRe, const T* inIm, T* outRe, T* outIm) {
+			std::size_t m = padded_.size();
+			T* ar = padded_.real(), * ai = padded_.imag();
+			const T* cr = chirp_.real(), * ci = chirp_.imag();
+
+			EZ_MATH_VECTORIZE
+			for (std::size_t k = 0; k < size_; ++k) {
+				T re = inRe[k], im = inIm[k];
+				intern::multiply(re, im, cr[k], ci[k]);
+				ar[k] = re;
+				ai[k] = im;
+			}
+			std::fill(ar + size_, ar + m, T(0));
+			std::fill(ai + size_, ai + m, T(0));
+
+			inner_->transform(ar, ai, ar, ai);
+			ez::complex::multiply(padded_, kernel_, padded_);
+			// Inverse, with the exchanged parts trick
+			inner_->transform(ai, ar, ai, ar);
+
+			EZ_MATH_VECTORIZE
+			for (std::size_t k = 0; k < size_; ++k) {
+				T re = ar[k], im = ai[k];
+				intern::multiply(re, im, cr[k], ci[k]);
+				outRe[k] = re;
+				outIm[k] = im;
+			}
+		}
+
+		std::size_t size_ = 0;
+
+		// Power of two sizes, the twiddles for each radix 4 stage in order
+		std::vector<T> twiddleRe_, twiddleIm_;
+		ComplexArray<T> scratch_;
+
+		// Other sizes, the chirp, the transformed convolution kernel, and the power of two plan they are convolved with
+		std::unique_ptr<Plan> inner_;
+		ComplexArray<T> chirp_, kernel_, padded_;
+
+		// Split copy of interleaved inputs
+		ComplexArray<T> work_;
+	};
+
+	/*
+		Transform of real input of a fixed size, producing the size / 2 + 1 non redundant bins of the spectrum.
+		The remaining bins are the complex conjugates of these, X[n - k] = conj(X[k]).
+		Even sizes are packed into a complex transform of half the size.
+	*/
+	template<typename T>
+	class RealPlan {
+	public:
+		static_assert(std::is_floating_point_v<T>, "ez::fft::RealPlan requires floating point types!");
+		using complex_t = glm::tcomplex<T>;
+
+		RealPlan() = default;
+
+		explicit RealPlan(std::size_t size)
+			: size_(size)
+			, plan_(size % 2 == 0 ? size / 2 : size)
+			, work_(size % 2 == 0 ? size / 2 : size)
+			, bins_(size / 2 + 1)
+		{
+			if (size % 2 == 0) {
+				std::size_t half = size / 2;
+				twiddles_.resize(half);
+				for (std::size_t k = 0; k < half; ++k) {
+					twiddles_.set(k, intern::twiddle<T>(k, size));
+				}
+			}
+		}
+
+		std::size_t size() const noexcept {
+			return size_;
+		}
+		// The number of complex values produced by forward, and consumed by inverse
+		std::size_t bins() const noexcept {
+			return size_ == 0 ? 0 : size_ / 2 + 1;
+		}
+
+		void forward(const T* in, T* outRe, T* outIm) {
+			if (size_ == 0) {
+				return;
+			}
+			T* zr = work_.real(), * zi = work_.imag();
+
+			if (size_ % 2 == 1) {
+				std::copy(in, in + size_, zr);
+				std::fill(zi, zi + size_, T(0));
+				plan_.forward(zr, zi, zr, zi);
+				std::copy(zr, zr + bins(), outRe);
+				std::copy(zi, zi + bins(), outIm);
+				return;
+			}
+
+			// Even samples in the real part, odd in the imaginary
+			std::size_t half = size_ / 2;
+			EZ_MATH_VECTORIZE
+			for (std::size_t k = 0; k < half; ++k) {
+				zr[k] = in[2 * k];
+				zi[k] = in[2 * k + 1];
+			}
+			plan_.forward(zr, zi, zr, zi);
+
+			// Separate the spectra of the even and odd samples, and combine them with one radix 2 step
+			const T* wr = twiddles_.real(), * wi = twiddles_.imag();
+			EZ_MATH_VECTORIZE
+			for (std::size_t k = 1; k < half; ++k) {
+				T ar = zr[k], ai = zi[k];
+				T br = zr[half - k], bi = -zi[half - k];
+
+				T evenr = T(0.5) * (ar + br), eveni = T(0.5) * (ai + bi);
+				// (a - b) / 2i
+				T oddr = T(0.5) * (ai - bi), oddi = T(0.5) * (br - ar);
+				intern::multiply(oddr, oddi, wr[k], wi[k]);
+
+				outRe[k] = evenr + oddr;
+				outIm[k] = eveni + oddi;
+			}
+			outRe[0] = zr[0] + zi[0];
+			outIm[0] = T(0);
+			outRe[half] = zr[0] - zi[0];
+			outIm[half] = T(0);
+		}
+
+		// The inverse, scaled by 1 / size. The imaginary parts of the first and (for even sizes) the last bin are ignored.
+		void inverse(const T* inRe, const T* inIm, T* out) {
+			if (size_ == 0) {
+				return;
+			}
+			T* zr = work_.real(), * zi = work_.imag();
+
+			if (size_ % 2 == 1) {
+				std::size_t count = bins();
+				zr[0] = inRe[0];
+				zi[0] = T(0);
+				for (std::size_t k = 1; k < count; ++k) {
+					zr[k] = inRe[k];
+					zi[k] = inIm[k];
+					zr[size_ - k] = inRe[k];
+					zi[size_ - k] = -inIm[k];
+				}
+				plan_.inverse(zr, zi, zr, zi);
+				std::copy(zr, zr + size_, out);
+				return;
+			}
+
+			std::size_t half = size_ / 2;
+			const T* wr = twiddles_.real(), * wi = twiddles_.imag();
+			EZ_MATH_VECTORIZE
+			for (std::size_t k = 1; k < half; ++k) {
+				T ar = inRe[k], ai = inIm[k];
+				T br = inRe[half - k], bi = -inIm[half - k];
+
+				T evenr = T(0.5) * (ar + br), eveni = T(0.5) * (ai + bi);
+				T oddr = T(0.5) * (ar - br), oddi = T(0.5) * (ai - bi);
+				intern::multiply(oddr, oddi, wr[k], -wi[k]);
+
+				// even + i * odd
+				zr[k] = evenr - oddi;
+				zi[k] = eveni + oddr;
+			}
+			zr[0] = T(0.5) * (inRe[0] + inRe[half]);
+			zi[0] = T(0.5) * (inRe[0] - inRe[half]);
+			plan_.inverse(zr, zi, zr, zi);
+
+			EZ_MATH_VECTORIZE
+			for (std::size_t k = 0; k < half; ++k) {
+				out[2 * k] = zr[k];
+				out[2 * k + 1] = zi[k];
+			}
+		}
+
+		void forward(const T* in, complex_t* out) {
+			forward(in, bins_.real(), bins_.imag());
+			interleave(bins_.real(), bins_.imag(), out, bins());
+		}
+		void inverse(const complex_t* in, T* out) {
+			deinterleave(in, bins_.real(), bins_.imag(), bins());
+			inverse(bins_.real(), bins_.imag(), out);
+		}
+	private:
+		std::size_t size_ = 0;
+		Plan<T> plan_;
+		ComplexArray<T> twiddles_, work_, bins_;
+	};
+
+	/*
+		Two dimensional complex transform of row major width x height data, in place.
+		Transforms the rows, transposes, transforms the rows again and transposes back.
+		Each pass can be split across threads, every thread using its own plans.
+	*/
+	template<typename T>
+	class Plan2D {
+	public:
+		static_assert(std::is_floating_point_v<T>, "ez::fft::Plan2D requires floating point types!");
+
+		Plan2D() = default;
+
+		Plan2D(std::size_t width, std::size_t height, unsigned threads = 1)
+			: width_(width)
+			, height_(height)
+			, transposed_(width * height)
+		{
+			threads = std::max(threads, 1u);
+			for (unsigned i = 0; i < threads; ++i) {
+				rows_.emplace_back(width);
+				columns_.emplace_back(height);
+			}
+		}
+
+		std::size_t width() const noexcept {
+			return width_;
+		}
+		std::size_t height() const noexcept {
+			return height_;
+		}
+		unsigned threads() const noexcept {
+			return unsigned(rows_.size());
+		}
+
+		void forward(T* re, T* im) {
+			transform(re, im, false);
+		}
+		void inverse(T* re, T* im) {
+			transform(re, im, true);
+		}
+
+		void forward(ComplexArray<T>& data) {
+			assert(data.size() == width_ * height_);
+			forward(data.real(), data.imag());
+		}
+		void inverse(ComplexArray<T>& data) {
+			assert(data.size() == width_ * height_);
+			inverse(data.real(), data.imag());
+		}
+	private:
+		static constexpr std::size_t block = 16;
+
+		// Blocked transpose of a rows x columns matrix, split across the threads by bands of rows
+		void transpose(const T* re, const T* im, T* outRe, T* outIm, std::size_t rows, std::size_t columns) {
+			std::size_t bands = (rows + block - 1) / block;
+			intern::parallelFor(bands, threads(), [&](std::size_t band, unsigned) {
+				std::size_t y0 = band * block, y1 = std::min(y0 + block, rows);
+				for (std::size_t x0 = 0; x0 < columns; x0 += block) {
+					std::size_t x1 = std::min(x0 + block, columns);
+					for (std::size_t y = y0; y < y1; ++y) {
+						for (std::size_t x = x0; x < x1; ++x) {
+							outRe[x * rows + y] = re[y * columns + x];
+							outIm[x * rows + y] = im[y * columns + x];
+						}
+					}
+				}
+			});
+		}
+
+		void rowPass(std::vector<Plan<T>>& plans, T* re, T* im, std::size_t rows, std::size_t length, bool invert) {
+			intern::parallelFor(rows, threads(), [&](std::size_t row, unsigned thread) {
+				T* r = re + row * length, * i = im + row * length;
+				if (invert) {
+					plans[thread].inverse(r, i, r, i);
+				}
+				else {
+					plans[thread].forward(r, i, r, i);
+				}
+			});
+		}
+
+		void transform(T* re, T* im, bool invert) {
+			if (width_ == 0 || height_ == 0) {
+				return;
+			}
+			T* tr = transposed_.real(), * ti = transposed_.imag();
+
+			rowPass(rows_, re, im, height_, width_, invert);
+			transpose(re, im, tr, ti, height_, width_);
+			rowPass(columns_, tr, ti, width_, height_, invert);
+			transpose(tr, ti, re, im, width_, height_);
+		}
+
+		std::size_t width_ = 0, height_ = 0;
+		std::vector<Plan<T>> rows_, columns_;
+		ComplexArray<T> transposed_;
+	};
+};
\ No newline at end of file
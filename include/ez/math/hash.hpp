@@ -0,0 +1,213 @@
+#pragma once
+#include <cinttypes>
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include "prng.hpp"
+
+/*
+	Fast non-cryptographic 64 bit hashing of byte strings, using Wang Yi's wyhash (final version 4).
+	Long inputs are consumed 48 bytes at a time, as three independent 16 byte lanes.
+
+	The functions are constexpr for character strings, and produce the same value at compile time and at run time.
+	Bytes are always read in little endian order, so the hashes are the same on every platform.
+*/
+
+namespace ez::prng {
+	namespace intern {
+		static constexpr std::uint64_t wyhashSecret[4] = {
+			0x2d358dccaa6c78a5ull,
+			0x8bb84b93962eacc9ull,
+			0x4b33a62ed433d4a3ull,
+			0x4d5a2da51de1aa47ull,
+		};
+
+		// Reads are written as byte loads so they work at compile time, compilers merge them into single loads.
+		template<typename Byte>
+		constexpr std::uint64_t wyRead8(const Byte* p) noexcept {
+			std::uint64_t result = 0;
+			for (int i = 0; i < 8; ++i) {
+				result |= std::uint64_t(std::uint8_t(p[i])) << (i * 8);
+			}
+			return result;
+		}
+		template<typename Byte>
+		constexpr std::uint64_t wyRead4(const Byte* p) noexcept {
+			std::uint64_t result = 0;
+			for (int i = 0; i < 4; ++i) {
+				result |= std::uint64_t(std::uint8_t(p[i])) << (i * 8);
+			}
+			return result;
+		}
+		template<typename Byte>
+		constexpr std::uint64_t wyRead3(const Byte* p, std::size_t k) noexcept {
+			return (std::uint64_t(std::uint8_t(p[0])) << 16) | (std::uint64_t(std::uint8_t(p[k >> 1])) << 8) | std::uint64_t(std::uint8_t(p[k - 1]));
+		}
+
+		constexpr std::uint64_t wyMix(std::uint64_t a, std::uint64_t b) noexcept {
+			std::uint64_t low = 0;
+			std::uint64_t high = mulHigh64(a, b, low);
+			return low ^ high;
+		}
+
+		constexpr std::uint64_t wySeed(std::uint64_t seed) noexcept {
+			return seed ^ wyMix(seed ^ wyhashSecret[0], wyhashSecret[1]);
+		}
+
+		// The three lanes of the bulk loop
+		struct WyLanes {
+			std::uint64_t seed, see1, see2;
+		};
+
+		template<typename Byte>
+		constexpr void wyBlock(WyLanes& lanes, const Byte* p) noexcept {
+			lanes.seed = wyMix(wyRead8(p) ^ wyhashSecret[1], wyRead8(p + 8) ^ lanes.seed);
+			lanes.see1 = wyMix(wyRead8(p + 16) ^ wyhashSecret[2], wyRead8(p + 24) ^ lanes.see1);
+			lanes.see2 = wyMix(wyRead8(p + 32) ^ wyhashSecret[3], wyRead8(p + 40) ^ lanes.see2);
+		}
+
+		// The last 1 to 48 bytes of an input longer than 16 bytes. The final read can reach up to 16 bytes before p.
+		template<typename Byte>
+		constexpr std::uint64_t wyFinish(std::uint64_t seed, const Byte* p, std::size_t i, std::size_t length) noexcept {
+			while (i > 16) {
+				seed = wyMix(wyRead8(p) ^ wyhashSecret[1], wyRead8(p + 8) ^ seed);
+				i -= 16;
+				p += 16;
+			}
+
+			std::uint64_t a = wyRead8(p + i - 16) ^ wyhashSecret[1];
+			std::uint64_t b = wyRead8(p + i - 8) ^ seed;
+			std::uint64_t low = 0;
+			std::uint64_t high = mulHigh64(a, b, low);
+			return wyMix(low ^ wyhashSecret[0] ^ length, high ^ wyhashSecret[1]);
+		}
+
+		template<typename Byte>
+		constexpr std::uint64_t wyhash(const Byte* p, std::size_t length, std::uint64_t seed) noexcept {
+			seed = wySeed(seed);
+
+			if (length <= 16) {
+				std::uint64_t a = 0, b = 0;
+				if (length >= 4) {
+					std::size_t offset = (length >> 3) << 2;
+					a = (wyRead4(p) << 32) | wyRead4(p + offset);
+					b = (wyRead4(p + length - 4) << 32) | wyRead4(p + length - 4 - offset);
+				}
+				else if (length > 0) {
+					a = wyRead3(p, length);
+				}
+
+				a ^= wyhashSecret[1];
+				b ^= seed;
+				std::uint64_t low = 0;
+				std::uint64_t high = mulHigh64(a, b, low);
+				return wyMix(low ^ wyhashSecret[0] ^ length, high ^ wyhashSecret[1]);
+			}
+
+			std::size_t i = length;
+			if (i > 48) {
+				WyLanes lanes{ seed, seed, seed };
+				do {
+					wyBlock(lanes, p);
+					p += 48;
+					i -= 48;
+				} while (i > 48);
+				seed = lanes.seed ^ lanes.see1 ^ lanes.see2;
+			}
+			return wyFinish(seed, p, i, length);
+		}
+	};
+
+	// Hash of length bytes of data
+	constexpr std::uint64_t wyhash(const char* data, std::size_t length, std::uint64_t seed = 0) noexcept {
+		return intern::wyhash(data, length, seed);
+	}
+	constexpr std::uint64_t wyhash(const unsigned char* data, std::size_t length, std::uint64_t seed = 0) noexcept {
+		return intern::wyhash(data, length, seed);
+	}
+	inline std::uint64_t wyhash(const void* data, std::size_t length, std::uint64_t seed = 0) noexcept {
+		return intern::wyhash(static_cast<const unsigned char*>(data), length, seed);
+	}
+
+	// Hash of a string literal, without the null terminator
+	template<std::size_t N>
+	constexpr std::uint64_t wyhash(const char(&str)[N], std::uint64_t seed = 0) noexcept {
+		return intern::wyhash(str, N - 1, seed);
+	}
+	constexpr std::uint64_t wyhash(std::string_view str, std::uint64_t seed = 0) noexcept {
+		return intern::wyhash(str.data(), str.size(), seed);
+	}
+	inline std::uint64_t wyhash(const std::string& str, std::uint64_t seed = 0) noexcept {
+		return intern::wyhash(str.data(), str.size(), seed);
+	}
+
+	// Incremental wyhash, for input that arrives in pieces. The digest is the same as hashing all the input at once.
+	class Wyhash {
+	public:
+		explicit Wyhash(std::uint64_t seed = 0) noexcept {
+			reset(seed);
+		}
+
+		void reset(std::uint64_t seed = 0) noexcept {
+			initial = seed;
+			lanes = intern::WyLanes{ intern::wySeed(seed), intern::wySeed(seed), intern::wySeed(seed) };
+			length = 0;
+			pending = 0;
+		}
+
+		void update(const void* data, std::size_t count) noexcept {
+			const unsigned char* p = static_cast<const unsigned char*>(data);
+			length += count;
+
+			// A block is only consumed once it is known not to be the last 48 bytes of the input,
+			// since the final step treats those differently.
+			while (pending + count > 48) {
+				if (pending == 0) {
+					while (count > 48) {
+						intern::wyBlock(lanes, p);
+						p += 48;
+						count -= 48;
+					}
+					std::memcpy(buffer, p - 16, 16);
+					break;
+				}
+
+				std::size_t take = std::min(48 - pending, count);
+				std::memcpy(buffer + 16 + pending, p, take);
+				pending += take;
+				p += take;
+				count -= take;
+
+				if (pending == 48 && count > 0) {
+					intern::wyBlock(lanes, buffer + 16);
+					std::memcpy(buffer, buffer + 48, 16);
+					pending = 0;
+				}
+			}
+
+			std::memcpy(buffer + 16 + pending, p, count);
+			pending += count;
+		}
+		void update(std::string_view str) noexcept {
+			update(str.data(), str.size());
+		}
+
+		std::uint64_t digest() const noexcept {
+			// Nothing has been consumed yet, so the whole input is still in the buffer
+			if (length <= 48) {
+				return intern::wyhash(buffer + 16, pending, initial);
+			}
+
+			std::uint64_t seed = lanes.seed ^ lanes.see1 ^ lanes.see2;
+			return intern::wyFinish(seed, buffer + 16, pending, length);
+		}
+	private:
+		std::uint64_t initial;
+		intern::WyLanes lanes;
+		std::uint64_t length;
+		std::size_t pending;
+		// The last 16 bytes consumed, followed by up to 48 bytes of pending input
+		unsigned char buffer[64];
+	};
+};
\ No newline at end of file
@@ -0,0 +1,388 @@
+#pragma once
+#include <cinttypes>
+#include <cstddef>
+#include <cassert>
+#include <cmath>
+#include <vector>
+#include <array>
+#include <algorithm>
+#include "color.hpp"
+#include "simd.hpp"
+
+namespace ez {
+	enum class Dither {
+		None,
+		// 4x4 Bayer matrix
+		Ordered,
+		// Error diffusion, scanning left to right
+		FloydSteinberg,
+	};
+
+	/*
+		Palette of up to 256 colors, for reducing images to 8 bit indices.
+		Only the red, green and blue channels are considered, the alpha of the palette colors is always opaque.
+
+		Nearest color queries are answered either exactly, or through a precomputed 32x32x32 inverse lookup cube.
+		The cube maps each 5 bit per channel cell to the palette color nearest to the center of the cell.
+	*/
+	class ColorPalette {
+	public:
+		static constexpr std::size_t maxSize = 256;
+
+		ColorPalette() = default;
+
+		// Create a palette from a set of colors, at most maxSize of them.
+		ColorPalette(const ColorU* colors, std::size_t count) {
+			assert(count <= maxSize);
+			count = std::min(count, maxSize);
+
+			colors_.reserve(count);
+			for (std::size_t i = 0; i < count; ++i) {
+				colors_.push_back(ColorU{ colors[i].r, colors[i].g, colors[i].b });
+			}
+			rebuild();
+		}
+
+		// Build a palette of at most size colors that represents the pixels, with a variant of median cut over a 5 bit per channel histogram.
+		// Boxes are split along a single channel like median cut, but not at the median. The cut goes where the variance between the two halves
+		// is largest (Otsu's method), which keeps dense clusters whole. The result can be refined with a number of k-means iterations afterwards.
+		static ColorPalette medianCut(const ColorU* pixels, std::size_t count, std::size_t size = maxSize, int kmeansIterations = 0) {
+			assert(size > 0 && size <= maxSize);
+			size = std::max(std::size_t(1), std::min(size, maxSize));
+
+			// Work on a 5 bit per channel histogram instead of the pixels themselves
+			std::vector<Bin> bins = histogram(pixels, count);
+
+			struct Box {
+				std::size_t first, last;
+			};
+			std::vector<Box> boxes;
+			if (!bins.empty()) {
+				boxes.push_back(Box{ 0, bins.size() });
+			}
+
+			while (boxes.size() < size) {
+				// Split the box with the largest weighted variance along a single channel
+				int best = -1, bestChannel = 0;
+				double bestError = 0.0;
+				for (std::size_t i = 0; i < boxes.size(); ++i) {
+					const Box& box = boxes[i];
+					if (box.last - box.first < 2) {
+						continue;
+					}
+
+					for (int c = 0; c < 3; ++c) {
+						double total = 0.0, sum = 0.0, squares = 0.0;
+						for (std::size_t k = box.first; k < box.last; ++k) {
+							double w = bins[k].count, v = bins[k].color[c];
+							total += w;
+							sum += w * v;
+							squares += w * v * v;
+						}
+
+						double error = squares - sum * sum / total;
+						if (error > bestError) {
+							bestError = error;
+							best = int(i);
+							bestChannel = c;
+						}
+					}
+				}
+				if (best < 0) {
+					break;
+				}
+
+				Box& box = boxes[best];
+				std::sort(bins.begin() + box.first, bins.begin() + box.last, [bestChannel](const Bin& lh, const Bin& rh) {
+					return lh.color[bestChannel] < rh.color[bestChannel];
+				});
+
+				// Split where the variance between the two halves is largest
+				double total = 0.0, sum = 0.0;
+				for (std::size_t k = box.first; k < box.last; ++k) {
+					total += bins[k].count;
+					sum += double(bins[k].count) * bins[k].color[bestChannel];
+				}
+
+				double lowTotal = 0.0, lowSum = 0.0, bestScore = -1.0;
+				std::size_t split = box.first + 1;
+				for (std::size_t k = box.first; k + 1 < box.last; ++k) {
+					lowTotal += bins[k].count;
+					lowSum += double(bins[k].count) * bins[k].color[bestChannel];
+					if (bins[k].color[bestChannel] == bins[k + 1].color[bestChannel]) {
+						continue;
+					}
+
+					double highTotal = total - lowTotal;
+					double diff = lowSum / lowTotal - (sum - lowSum) / highTotal;
+					double score = lowTotal * highTotal * diff * diff;
+					if (score > bestScore) {
+						bestScore = score;
+						split = k + 1;
+					}
+				}
+
+				Box upper{ split, box.last };
+				box.last = split;
+				boxes.push_back(upper);
+			}
+
+			ColorPalette palette;
+			for (const Box& box : boxes) {
+				uint64_t sum[3] = { 0, 0, 0 }, total = 0;
+				for (std::size_t k = box.first; k < box.last; ++k) {
+					for (int c = 0; c < 3; ++c) {
+						sum[c] += bins[k].sum[c];
+					}
+					total += bins[k].count;
+				}
+				palette.colors_.push_back(average(sum, total));
+			}
+
+			for (int iter = 0; iter < kmeansIterations && !palette.colors_.empty(); ++iter) {
+				std::vector<std::array<uint64_t, 4>> sums(palette.colors_.size(), std::array<uint64_t, 4>{ 0, 0, 0, 0 });
+				palette.rebuild();
+
+				for (const Bin& bin : bins) {
+					std::array<uint64_t, 4>& target = sums[palette.nearest(bin.color)];
+					for (int c = 0; c < 3; ++c) {
+						target[c] += bin.sum[c];
+					}
+					target[3] += bin.count;
+				}
+
+				for (std::size_t i = 0; i < sums.size(); ++i) {
+					if (sums[i][3] != 0) {
+						uint64_t sum[3] = { sums[i][0], sums[i][1], sums[i][2] };
+						palette.colors_[i] = average(sum, sums[i][3]);
+					}
+				}
+			}
+
+			palette.rebuild();
+			return palette;
+		}
+
+		std::size_t size() const noexcept {
+			return colors_.size();
+		}
+		bool empty() const noexcept {
+			return colors_.empty();
+		}
+		const ColorU* data() const noexcept {
+			return colors_.data();
+		}
+		const ColorU& operator[](std::size_t i) const noexcept {
+			assert(i < colors_.size());
+			return colors_[i];
+		}
+		std::vector<ColorU>::const_iterator begin() const noexcept {
+			return colors_.begin();
+		}
+		std::vector<ColorU>::const_iterator end() const noexcept {
+			return colors_.end();
+		}
+
+		// Index of the palette color closest to the given color, by squared distance in RGB.
+		uint8_t nearest(const ColorU& color) const noexcept {
+			assert(!empty());
+
+			int best = 0;
+			int bestDist = distance(0, color);
+			for (std::size_t i = 1; i < colors_.size(); ++i) {
+				int d = distance(i, color);
+				if (d < bestDist) {
+					bestDist = d;
+					best = int(i);
+				}
+			}
+			return uint8_t(best);
+		}
+
+		// Index of the palette color closest to the center of the lookup cube cell containing color.
+		// A cell spans 8 levels per channel, so the result can be up to about 14 RGB units farther from color than nearest.
+		// Use nearest when the exact answer is needed.
+		uint8_t lookup(const ColorU& color) const noexcept {
+			assert(!empty());
+			return cube_[cellIndex(color.r, color.g, color.b)];
+		}
+
+		// Map each pixel to its palette index, using the lookup cube.
+		// Like lookup, an index can be up to about 14 RGB units worse than nearest would give.
+		void quantize(const ColorU* pixels, uint8_t* indices, std::size_t count) const noexcept {
+			assert(!empty());
+			const uint8_t* cube = cube_.data();
+
+			EZ_MATH_VECTORIZE
+			for (std::size_t i = 0; i < count; ++i) {
+				indices[i] = cube[cellIndex(pixels[i].r, pixels[i].g, pixels[i].b)];
+			}
+		}
+
+		// Map an image to palette indices, optionally dithering the result. The image is stored row by row.
+		void quantize(const ColorU* pixels, uint8_t* indices, std::size_t width, std::size_t height, Dither dither) const {
+			assert(!empty());
+
+			switch (dither) {
+			case Dither::None:
+				quantize(pixels, indices, width * height);
+				break;
+			case Dither::Ordered:
+				quantizeOrdered(pixels, indices, width, height);
+				break;
+			case Dither::FloydSteinberg:
+				quantizeFloydSteinberg(pixels, indices, width, height);
+				break;
+			}
+		}
+	private:
+		struct Bin {
+			ColorU color;
+			uint32_t count;
+			uint64_t sum[3];
+		};
+
+		static std::size_t cellIndex(int r, int g, int b) noexcept {
+			return std::size_t(((r >> 3) << 10) | ((g >> 3) << 5) | (b >> 3));
+		}
+
+		static ColorU average(const uint64_t(&sum)[3], uint64_t total) noexcept {
+			return ColorU{
+				uint8_t((sum[0] + total / 2) / total),
+				uint8_t((sum[1] + total / 2) / total),
+				uint8_t((sum[2] + total / 2) / total),
+			};
+		}
+
+		static std::vector<Bin> histogram(const ColorU* pixels, std::size_t count) {
+			std::vector<uint32_t> counts(32 * 32 * 32, 0);
+			std::vector<std::array<uint64_t, 3>> sums(32 * 32 * 32, std::array<uint64_t, 3>{ 0, 0, 0 });
+			for (std::size_t i = 0; i < count; ++i) {
+				std::size_t cell = cellIndex(pixels[i].r, pixels[i].g, pixels[i].b);
+				++counts[cell];
+				sums[cell][0] += pixels[i].r;
+				sums[cell][1] += pixels[i].g;
+				sums[cell][2] += pixels[i].b;
+			}
+
+			std::vector<Bin> bins;
+			for (std::size_t cell = 0; cell < counts.size(); ++cell) {
+				if (counts[cell] != 0) {
+					Bin bin;
+					bin.count = counts[cell];
+					bin.sum[0] = sums[cell][0];
+					bin.sum[1] = sums[cell][1];
+					bin.sum[2] = sums[cell][2];
+					bin.color = average(bin.sum, bin.count);
+					bins.push_back(bin);
+				}
+			}
+			return bins;
+		}
+
+		int distance(std::size_t i, const ColorU& color) const noexcept {
+			int dr = int(colors_[i].r) - int(color.r);
+			int dg = int(colors_[i].g) - int(color.g);
+			int db = int(colors_[i].b) - int(color.b);
+			return dr * dr + dg * dg + db * db;
+		}
+
+		void rebuild() {
+			cube_.assign(32 * 32 * 32, 0);
+			if (colors_.empty()) {
+				return;
+			}
+
+			// Structure of arrays copy of the palette, so the search over the palette vectorizes
+			std::size_t count = colors_.size();
+			std::vector<int> pr(count), pg(count), pb(count), dist(count);
+			for (std::size_t i = 0; i < count; ++i) {
+				pr[i] = colors_[i].r;
+				pg[i] = colors_[i].g;
+				pb[i] = colors_[i].b;
+			}
+
+			for (int r = 0; r < 32; ++r) {
+				for (int g = 0; g < 32; ++g) {
+					for (int b = 0; b < 32; ++b) {
+						int cr = (r << 3) | 4, cg = (g << 3) | 4, cb = (b << 3) | 4;
+
+						EZ_MATH_VECTORIZE
+						for (std::size_t i = 0; i < count; ++i) {
+							int dr = pr[i] - cr, dg = pg[i] - cg, db = pb[i] - cb;
+							dist[i] = dr * dr + dg * dg + db * db;
+						}
+
+						std::size_t best = std::min_element(dist.begin(), dist.end()) - dist.begin();
+						cube_[(r << 10) | (g << 5) | b] = uint8_t(best);
+					}
+				}
+			}
+		}
+
+		void quantizeOrdered(const ColorU* pixels, uint8_t* indices, std::size_t width, std::size_t height) const noexcept {
+			static constexpr int bayer[4][4] = {
+				{ 0, 8, 2, 10 },
+				{ 12, 4, 14, 6 },
+				{ 3, 11, 1, 9 },
+				{ 15, 7, 13, 5 },
+			};
+
+			// Spread the threshold over roughly the distance between palette levels
+			float spread = 255.f / std::max(1.f, std::cbrt(float(colors_.size())));
+
+			for (std::size_t y = 0; y < height; ++y) {
+				int offsets[4];
+				for (int x = 0; x < 4; ++x) {
+					offsets[x] = int(std::lround(((bayer[y & 3][x] + 0.5f) / 16.f - 0.5f) * spread));
+				}
+
+				const ColorU* row = pixels + y * width;
+				uint8_t* out = indices + y * width;
+				for (std::size_t x = 0; x < width; ++x) {
+					int offset = offsets[x & 3];
+					int r = std::max(0, std::min(int(row[x].r) + offset, 255));
+					int g = std::max(0, std::min(int(row[x].g) + offset, 255));
+					int b = std::max(0, std::min(int(row[x].b) + offset, 255));
+					out[x] = cube_[cellIndex(r, g, b)];
+				}
+			}
+		}
+
+		void quantizeFloydSteinberg(const ColorU* pixels, uint8_t* indices, std::size_t width, std::size_t height) const {
+			// Accumulated error for the current and next row, with a pixel of padding on each side. Stored times 16.
+			std::vector<int> current((width + 2) * 3, 0), next((width + 2) * 3, 0);
+
+			for (std::size_t y = 0; y < height; ++y) {
+				std::fill(next.begin(), next.end(), 0);
+
+				const ColorU* row = pixels + y * width;
+				uint8_t* out = indices + y * width;
+				for (std::size_t x = 0; x < width; ++x) {
+					int* err = &current[(x + 1) * 3];
+					// Rounded to nearest, the shift floors negative errors as well, where dividing would truncate them toward zero
+					int wanted[3];
+					for (int c = 0; c < 3; ++c) {
+						wanted[c] = std::max(0, std::min(int(row[x][c]) + ((err[c] + 8) >> 4), 255));
+					}
+
+					uint8_t index = cube_[cellIndex(wanted[0], wanted[1], wanted[2])];
+					out[x] = index;
+
+					for (int c = 0; c < 3; ++c) {
+						int diff = wanted[c] - int(colors_[index][c]);
+						current[(x + 2) * 3 + c] += diff * 7;
+						next[x * 3 + c] += diff * 3;
+						next[(x + 1) * 3 + c] += diff * 5;
+						next[(x + 2) * 3 + c] += diff;
+					}
+				}
+
+				std::swap(current, next);
+			}
+		}
+
+		std::vector<ColorU> colors_;
+		std::vector<uint8_t> cube_;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,312 @@
+#pragma once
+#include <cinttypes>
+#include <cstddef>
+#include <cassert>
+#include <cstring>
+#include "color.hpp"
+#include "simd.hpp"
+
+namespace ez {
+	/*
+		Describes how a single pixel is packed in memory.
+		The channels are located by their bit offset into the pixel word, read as a little endian integer of `size` bytes.
+		For the 8 bit formats this means the offset divided by 8 is the index of the byte in memory.
+
+		ColorU has the same layout as rgba8. The words produced by Color::toU32 (ARGB) are stored as bgra8 on little endian machines.
+	*/
+	struct PixelFormat {
+		// Size of a single pixel in bytes, either 2 or 4.
+		uint8_t size;
+		// Bit offset of the r, g, b, and a channels in the pixel word.
+		uint8_t shift[4];
+		// Bit width of the r, g, b, and a channels, zero if the channel is not present.
+		// Missing color channels unpack as zero, a missing alpha unpacks as opaque.
+		uint8_t bits[4];
+
+		// Bytes in memory order R, G, B, A
+		static constexpr PixelFormat rgba8() noexcept {
+			return PixelFormat{ 4, {0, 8, 16, 24}, {8, 8, 8, 8} };
+		}
+		// Bytes in memory order B, G, R, A
+		static constexpr PixelFormat bgra8() noexcept {
+			return PixelFormat{ 4, {16, 8, 0, 24}, {8, 8, 8, 8} };
+		}
+		// Bytes in memory order A, R, G, B
+		static constexpr PixelFormat argb8() noexcept {
+			return PixelFormat{ 4, {8, 16, 24, 0}, {8, 8, 8, 8} };
+		}
+		// Bytes in memory order A, B, G, R
+		static constexpr PixelFormat abgr8() noexcept {
+			return PixelFormat{ 4, {24, 16, 8, 0}, {8, 8, 8, 8} };
+		}
+		// 16 bit word, red in the top 5 bits, blue in the bottom 5 bits
+		static constexpr PixelFormat rgb565() noexcept {
+			return PixelFormat{ 2, {11, 5, 0, 0}, {5, 6, 5, 0} };
+		}
+		// 32 bit word, red in the bottom 10 bits, alpha in the top 2 bits
+		static constexpr PixelFormat rgb10a2() noexcept {
+			return PixelFormat{ 4, {0, 10, 20, 30}, {10, 10, 10, 2} };
+		}
+
+		constexpr bool operator==(const PixelFormat& other) const noexcept {
+			for (int i = 0; i < 4; ++i) {
+				if (shift[i] != other.shift[i] || bits[i] != other.bits[i]) {
+					return false;
+				}
+			}
+			return size == other.size;
+		}
+		constexpr bool operator!=(const PixelFormat& other) const noexcept {
+			return !(*this == other);
+		}
+
+		// Every channel is a whole byte of a 4 byte pixel, so conversions are just byte shuffles.
+		constexpr bool isByteAligned() const noexcept {
+			if (size != 4) {
+				return false;
+			}
+			for (int i = 0; i < 4; ++i) {
+				if ((bits[i] != 8 && bits[i] != 0) || shift[i] % 8 != 0) {
+					return false;
+				}
+			}
+			return true;
+		}
+	};
+}
+
+namespace ez::color {
+	namespace intern {
+		// Byte shuffle between two byte aligned formats. For each destination byte, index holds the source byte
+		// or 0x80 if the byte is filled from fill. Safe to use in place.
+		inline void shufflePixels(const uint8_t* src, uint8_t* dst, std::size_t count, const uint8_t(&index)[4], const uint8_t(&fill)[4]) noexcept {
+			std::size_t i = 0;
+
+#if defined(EZ_MATH_SSSE3)
+			// The shuffles only work within 128 bit lanes, which is fine since the pixels never straddle them.
+			alignas(64) uint8_t mask[64];
+			alignas(64) uint8_t fillMask[64];
+			for (int k = 0; k < 64; ++k) {
+				uint8_t idx = index[k % 4];
+				mask[k] = idx & 0x80 ? uint8_t(0x80) : uint8_t((k & 15 & ~3) + idx);
+				fillMask[k] = fill[k % 4];
+			}
+
+#if defined(EZ_MATH_AVX512BW)
+			{
+				__m512i vmask = _mm512_load_si512(mask);
+				__m512i vfill = _mm512_load_si512(fillMask);
+				for (; i + 16 <= count; i += 16) {
+					__m512i px = _mm512_loadu_si512(src + i * 4);
+					px = _mm512_or_si512(_mm512_shuffle_epi8(px, vmask), vfill);
+					_mm512_storeu_si512(dst + i * 4, px);
+				}
+			}
+#endif
+#if defined(EZ_MATH_AVX2)
+			{
+				__m256i vmask = _mm256_load_si256(reinterpret_cast<const __m256i*>(mask));
+				__m256i vfill = _mm256_load_si256(reinterpret_cast<const __m256i*>(fillMask));
+				for (; i + 8 <= count; i += 8) {
+					__m256i px = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i * 4));
+					px = _mm256_or_si256(_mm256_shuffle_epi8(px, vmask), vfill);
+					_mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i * 4), px);
+				}
+			}
+#endif
+			{
+				__m128i vmask = _mm_load_si128(reinterpret_cast<const __m128i*>(mask));
+				__m128i vfill = _mm_load_si128(reinterpret_cast<const __m128i*>(fillMask));
+				for (; i + 4 <= count; i += 4) {
+					__m128i px = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 4));
+					px = _mm_or_si128(_mm_shuffle_epi8(px, vmask), vfill);
+					_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i * 4), px);
+				}
+			}
+#endif
+
+			for (; i < count; ++i) {
+				uint8_t px[4] = { src[i * 4 + 0], src[i * 4 + 1], src[i * 4 + 2], src[i * 4 + 3] };
+				for (int k = 0; k < 4; ++k) {
+					dst[i * 4 + k] = index[k] & 0x80 ? fill[k] : px[index[k]];
+				}
+			}
+		}
+
+		inline uint32_t loadWord(const uint8_t* p, int size) noexcept {
+			uint32_t word = uint32_t(p[0]) | (uint32_t(p[1]) << 8);
+			if (size == 4) {
+				word |= (uint32_t(p[2]) << 16) | (uint32_t(p[3]) << 24);
+			}
+			return word;
+		}
+
+		inline void storeWord(uint8_t* p, int size, uint32_t word) noexcept {
+			p[0] = uint8_t(word);
+			p[1] = uint8_t(word >> 8);
+			if (size == 4) {
+				p[2] = uint8_t(word >> 16);
+				p[3] = uint8_t(word >> 24);
+			}
+		}
+
+		// Rescale an n bit channel into 8 bits, with rounding
+		inline uint32_t expandChannel(uint32_t value, int bits) noexcept {
+			uint32_t max = (1u << bits) - 1u;
+			return (value * 255u + (max >> 1)) / max;
+		}
+
+		// Rescale an 8 bit channel into n bits, with rounding
+		inline uint32_t reduceChannel(uint32_t value, int bits) noexcept {
+			uint32_t max = (1u << bits) - 1u;
+			return (value * max + 127u) / 255u;
+		}
+
+		// The rgb565 and rgb10a2 presets to and from rgba8, with the rescaling of expandChannel and reduceChannel done as a multiply and shift.
+		// The constants were checked against the divisions for every input. Written as plain loops over whole pixels, which the compiler vectorizes.
+		inline void pack565(const uint8_t* src, uint8_t* dst, std::size_t count) noexcept {
+			EZ_MATH_VECTORIZE
+			for (std::size_t i = 0; i < count; ++i) {
+				const uint8_t* px = src + i * 4;
+				uint32_t r = (uint32_t(px[0]) * 249u + 1014u) >> 11;
+				uint32_t g = (uint32_t(px[1]) * 253u + 505u) >> 10;
+				uint32_t b = (uint32_t(px[2]) * 249u + 1014u) >> 11;
+				storeWord(dst + i * 2, 2, (r << 11) | (g << 5) | b);
+			}
+		}
+
+		inline void unpack565(const uint8_t* src, uint8_t* dst, std::size_t count) noexcept {
+			EZ_MATH_VECTORIZE
+			for (std::size_t i = 0; i < count; ++i) {
+				uint32_t word = loadWord(src + i * 2, 2);
+				uint8_t* px = dst + i * 4;
+				px[0] = uint8_t((((word >> 11) & 31u) * 527u + 23u) >> 6);
+				px[1] = uint8_t((((word >> 5) & 63u) * 259u + 33u) >> 6);
+				px[2] = uint8_t(((word & 31u) * 527u + 23u) >> 6);
+				px[3] = 255;
+			}
+		}
+
+		// Safe to use in place
+		inline void pack10a2(const uint8_t* src, uint8_t* dst, std::size_t count) noexcept {
+			EZ_MATH_VECTORIZE
+			for (std::size_t i = 0; i < count; ++i) {
+				const uint8_t* px = src + i * 4;
+				uint32_t r = (uint32_t(px[0]) * 1027u + 129u) >> 8;
+				uint32_t g = (uint32_t(px[1]) * 1027u + 129u) >> 8;
+				uint32_t b = (uint32_t(px[2]) * 1027u + 129u) >> 8;
+				uint32_t a = (uint32_t(px[3]) * 3u + 129u) >> 8;
+				storeWord(dst + i * 4, 4, r | (g << 10) | (b << 20) | (a << 30));
+			}
+		}
+
+		// Safe to use in place
+		inline void unpack10a2(const uint8_t* src, uint8_t* dst, std::size_t count) noexcept {
+			EZ_MATH_VECTORIZE
+			for (std::size_t i = 0; i < count; ++i) {
+				uint32_t word = loadWord(src + i * 4, 4);
+				uint8_t* px = dst + i * 4;
+				px[0] = uint8_t(((word & 1023u) * 1021u + 2041u) >> 12);
+				px[1] = uint8_t((((word >> 10) & 1023u) * 1021u + 2041u) >> 12);
+				px[2] = uint8_t((((word >> 20) & 1023u) * 1021u + 2041u) >> 12);
+				px[3] = uint8_t((word >> 30) * 85u);
+			}
+		}
+
+		// Fallback for formats that are not byte aligned, goes through 8 bit RGBA one pixel at a time.
+		inline void convertPixels(const uint8_t* src, PixelFormat from, uint8_t* dst, PixelFormat to, std::size_t count) noexcept {
+			for (std::size_t i = 0; i < count; ++i) {
+				uint32_t word = loadWord(src + i * from.size, from.size);
+
+				uint32_t result = 0;
+				for (int c = 0; c < 4; ++c) {
+					uint32_t value;
+					if (from.bits[c] == 0) {
+						value = c == 3 ? 255u : 0u;
+					}
+					else {
+						value = (word >> from.shift[c]) & ((1u << from.bits[c]) - 1u);
+						value = from.bits[c] == 8 ? value : expandChannel(value, from.bits[c]);
+					}
+
+					if (to.bits[c] != 0) {
+						value = to.bits[c] == 8 ? value : reduceChannel(value, to.bits[c]);
+						result |= value << to.shift[c];
+					}
+				}
+
+				storeWord(dst + i * to.size, to.size, result);
+			}
+		}
+	};
+
+	// Converts count pixels from one format to another.
+	// Conversions between byte aligned formats (rgba8, bgra8, argb8, abgr8) are done with vector byte shuffles,
+	// and the rgb565 and rgb10a2 presets have dedicated loops to and from rgba8, so pack and unpack are fast for them.
+	// The source and destination may be the same buffer, as long as both formats have the same pixel size.
+	inline void convertFormat(const void* src, PixelFormat from, void* dst, PixelFormat to, std::size_t count) noexcept {
+		assert(src != dst || from.size == to.size);
+
+		const uint8_t* in = static_cast<const uint8_t*>(src);
+		uint8_t* out = static_cast<uint8_t*>(dst);
+
+		if (from == to) {
+			if (in != out) {
+				std::memmove(out, in, count * from.size);
+			}
+			return;
+		}
+
+		if (from.isByteAligned() && to.isByteAligned()) {
+			uint8_t index[4] = { 0x80, 0x80, 0x80, 0x80 };
+			uint8_t fill[4] = { 0, 0, 0, 0 };
+			for (int c = 0; c < 4; ++c) {
+				if (to.bits[c] == 0) {
+					continue;
+				}
+
+				int byte = to.shift[c] / 8;
+				if (from.bits[c] != 0) {
+					index[byte] = uint8_t(from.shift[c] / 8);
+				}
+				else {
+					fill[byte] = c == 3 ? 0xFF : 0;
+				}
+			}
+			intern::shufflePixels(in, out, count, index, fill);
+		}
+		else if (from == PixelFormat::rgba8() && to == PixelFormat::rgb565()) {
+			intern::pack565(in, out, count);
+		}
+		else if (from == PixelFormat::rgb565() && to == PixelFormat::rgba8()) {
+			intern::unpack565(in, out, count);
+		}
+		else if (from == PixelFormat::rgba8() && to == PixelFormat::rgb10a2()) {
+			intern::pack10a2(in, out, count);
+		}
+		else if (from == PixelFormat::rgb10a2() && to == PixelFormat::rgba8()) {
+			intern::unpack10a2(in, out, count);
+		}
+		else {
+			intern::convertPixels(in, from, out, to, count);
+		}
+	}
+
+	// Converts pixels between two formats of the same size, without a second buffer.
+	inline void convertFormat(void* pixels, PixelFormat from, PixelFormat to, std::size_t count) noexcept {
+		assert(from.size == to.size);
+		convertFormat(pixels, from, pixels, to, count);
+	}
+
+	// Packs count colors into the given format.
+	inline void pack(const ColorU* src, void* dst, PixelFormat format, std::size_t count) noexcept {
+		static_assert(sizeof(ColorU) == 4, "ez::color::pack requires ColorU to be tightly packed!");
+		convertFormat(src, PixelFormat::rgba8(), dst, format, count);
+	}
+
+	// Unpacks count pixels of the given format into colors.
+	inline void unpack(const void* src, PixelFormat format, ColorU* dst, std::size_t count) noexcept {
+		static_assert(sizeof(ColorU) == 4, "ez::color::unpack requires ColorU to be tightly packed!");
+		convertFormat(src, format, dst, PixelFormat::rgba8(), count);
+	}
+};
@@ -1,10 +1,22 @@
 #pragma once
 #include <ez/meta.hpp>
 #include <cinttypes>
+#include <cstddef>
 #include <array>
 #include <cmath>
+#include <limits>
+#include <algorithm>
+#include <type_traits>
 #include "constants.hpp"
 #include "complex.hpp"
+#include "simd.hpp"
+
+// The lane loops of the batch solvers have a small constant trip count, which gcc fully unrolls before it gets to vectorizing them.
+#if defined(__GNUC__) && !defined(__clang__)
+	#define EZ_POLY_LANE_LOOP EZ_MATH_VECTORIZE _Pragma("GCC unroll 1")
+#else
+	#define EZ_POLY_LANE_LOOP EZ_MATH_VECTORIZE
+#endif
 
 namespace ez::poly {
 	// Linear polynomial
@@ -16,17 +28,14 @@ namespace ez::poly {
 	// Quadratic polynomial
 	template<typename T, typename U>
 	U evaluate(T a, T b, T c, U t) {
-		return a * t * t + b * t + c;
+		return (a * t + b) * t + c;
 	};
 
 	// Cubic polynomial
 	template<typename T, typename U>
 	U evaluate(T a, T b, T c, T d, U t) {
-		// Does caching this value make the precision worse? It seems to be doing something problematic
-		//U tt = t * t;
-		//return a * tt * t + b * tt + c * t + d;
-
-		return a * t * t * t + b * t * t + c * t + d;
+		// Horner form, which takes fewer operations and rounds less than summing the separate powers of t
+		return ((a * t + b) * t + c) * t + d;
 	};
 
 	// Linear polynomial
@@ -44,7 +53,7 @@ namespace ez::poly {
 	// Cubic polynomial
 	template<typename T, typename U>
 	U derivativeAt(T a, T b, T c, U t) {
-		return T(3) * a * t * t + T(2) * b * t + c;
+		return (T(3) * a * t + T(2) * b) * t + c;
 	}
 
 
@@ -200,87 +209,1071 @@ namespace ez::poly {
 		return solveQuadratic(qa, qb, qc, output) + 1;
 	}
 
-	/* This method works very well for polynomials with different roots, but fails miserably when there are
-	* multiple of the same root
-	template<typename T, typename  Iter>
-	int solveCubic(T a, T b, T c, T d, Iter output) {
-		/// Aberth method
+	// Solver policies for the cubic solvers.
+	// Newton iterates until convergence, so the cost depends on the input and it can fail to find any root.
+	// Analytic uses the closed form solution followed by a fixed number of polishing steps, so the cost is constant.
+	struct Newton {};
+	struct Analytic {};
 
-		static_assert(std::is_floating_point_v<T>, "ez::Polynomial::solveQuadratic requires floating point types!");
-		static_assert(is_output_iterator_v<Iter>, "ez::Polynomial::solveQuadratic requires the iterator passed in to be an output iterator.");
-		static_assert(is_iterator_writable_v<Iter, T>, "ez::Polynomial::solveQuadratic cannot convert type to iterator value_type!");
-		
-		// Roughly equidistant points on unit circle
-		// Slightly non-symmetrical to prevent convergence issues
-		static constexpr glm::tcomplex<T>
-			guess0{ -0.5839603576017,  0.811782175678686 },
-			guess1{ -0.4110438076762, -0.911615592325514 },
-			guess2{  0.9950041652780,  0.099833416646828 };
-
-		if (std::abs(a) < ez::epsilon<T>()) {
-			return solveQuadratic(b, c, d, output);
+	inline constexpr Newton newton{};
+	inline constexpr Analytic analytic{};
+
+	namespace intern {
+		// Branch free equivalent of solveQuadratic, used by the lane kernels.
+		// Every case is computed unconditionally and then selected, so the compiler is free to vectorize the caller.
+		// rootDet and rootSym are the square roots of |b^2 - 4ac| and |c / a|, so that lane loops can take them in a separate pass with ez::simd::sqrt.
+		template<typename T>
+		EZ_MATH_INLINE int quadraticLane(T a, T b, T c, T rootDet, T rootSym, T& r0, T& r1) noexcept {
+			constexpr T eps = ez::epsilon<T>() * T(10);
+
+			// The square roots are only used where their argument is positive
+			T det = b * b - T(4) * a * c;
+			T linear = -c / b;
+			T single = -b / a;
+			T large = (-b - std::copysign(rootDet, b)) / (T(2) * a);
+			T small = c / (a * large);
+			T repeated = -b / (T(2) * a);
+
+			bool isLinear = std::abs(a) < eps;
+			bool noRoots = std::abs(b) < eps;
+			bool zeroC = std::abs(c) < eps;
+			bool flat = std::abs(b) <= eps;
+			bool twoRoots = det > eps;
+			bool oneRoot = det > -eps;
+
+			using ez::simd::select;
+			r0 = select(isLinear, linear, select(zeroC, std::min(T(0), single), select(!twoRoots, repeated, select(flat, -rootSym, std::min(large, small)))));
+			r1 = select(zeroC, std::max(T(0), single), select(flat, rootSym, std::max(large, small)));
+
+			// Counts are built from the conditions arithmetically, nested selects on integers are left as branches
+			int quadratic = int(zeroC | twoRoots) + int(zeroC | oneRoot);
+			int linearCount = int(!noRoots);
+			return isLinear * linearCount + !isLinear * quadratic;
+		}
+		template<typename T>
+		EZ_MATH_INLINE int quadraticLane(T a, T b, T c, T& r0, T& r1) noexcept {
+			return quadraticLane(a, b, c, std::sqrt(std::abs(b * b - T(4) * a * c)), std::sqrt(std::abs(c / a)), r0, r1);
 		}
 
-		// The bounds of the polynomials roots
-		T upper = T(1) + (T(1) / (std::abs(a)) * std::max(std::abs(d), std::max(std::abs(c), std::abs(b))));
-		T lower = std::abs(d) / (std::abs(d) + std::max(std::abs(c), std::max(std::abs(b), std::abs(a))));
-		T mid = (upper + lower) * T(0.5);
+		// Solves exactly N cubics, using the same accelerated newton iteration as solveCubic.
+		// Each lane has its own convergence mask, lanes that have converged are frozen while the others continue.
+		// The masks are integers the same size as T, combined with bitwise operations and blended into the updates, so the loops vectorize.
+		template<typename T, std::size_t N>
+		void solveCubicLanes(Newton, const T* a, const T* b, const T* c, const T* d, int* counts, T* roots) noexcept {
+			using Mask = ez::simd::Mask<T>;
+			constexpr T eps = ez::epsilon<T>() * T(10);
+			constexpr int numIters = sizeof(T) == 4 ? 24 : 64;
+			constexpr T interpRate = T(0.7);
 
-		// The roots we are iterating on
-		std::array<glm::tcomplex<T>, 3> roots{
-			mid * guess0,
-			mid * guess1,
-			mid * guess2
-		};
+			T root[N];
+			Mask active[N];
 
-		std::array<T, 3> deriv{
-			T(3) * a, 
-			T(2) * b, 
-			c
-		};
+			EZ_POLY_LANE_LOOP
+			for (std::size_t l = 0; l < N; ++l) {
+				T dd1 = b[l] * T(2);
+				T start = -dd1 / (a[l] * T(6)) + T(1);
+				// Same threshold as solveLinear, which picks the starting point in solveCubic
+				root[l] = ez::simd::select(std::abs(dd1) < ez::epsilon<T>(), T(0), start);
+
+				// Degenerate lanes are handed off to the quadratic solver below
+				active[l] = Mask(!(std::abs(a[l]) < eps));
+			}
+
+			T accel{ 2.5 };
+			for (int i = 0; i < numIters; ++i) {
+				Mask any = 0;
+
+				EZ_POLY_LANE_LOOP
+				for (std::size_t l = 0; l < N; ++l) {
+					T x = root[l];
+					T fx = poly::evaluate(a[l], b[l], c[l], d[l], x);
+					T delta = accel * fx / poly::evaluate(a[l] * T(3), b[l] * T(2), c[l], x);
+
+					Mask step = active[l] & Mask(!(std::abs(fx) < eps));
+					root[l] = ez::simd::select(step != 0, x - delta, x);
+					active[l] = step;
+					any |= step;
+				}
+
+				if (any == 0) {
+					break;
+				}
+				accel = accel * (T(1) - interpRate) + interpRate;
+			}
+
+			// Factor out the found root, and take the square roots for both quadratics in one pass
+			T qb[N], qc[N], sqrts[N * 4];
+
+			EZ_POLY_LANE_LOOP
+			for (std::size_t l = 0; l < N; ++l) {
+				qb[l] = a[l] * root[l] + b[l];
+				qc[l] = qb[l] * root[l] + c[l];
+
+				sqrts[l] = std::abs(qb[l] * qb[l] - T(4) * a[l] * qc[l]);
+				sqrts[N + l] = std::abs(qc[l] / a[l]);
+				sqrts[N * 2 + l] = std::abs(c[l] * c[l] - T(4) * b[l] * d[l]);
+				sqrts[N * 3 + l] = std::abs(d[l] / b[l]);
+			}
+			ez::simd::sqrt(sqrts, N * 4);
+
+			EZ_POLY_LANE_LOOP
+			for (std::size_t l = 0; l < N; ++l) {
+				T q0, q1, s0, s1;
+				int numFactored = quadraticLane(a[l], qb[l], qc[l], sqrts[l], sqrts[N + l], q0, q1);
+				int numDegenerate = quadraticLane(b[l], c[l], d[l], sqrts[N * 2 + l], sqrts[N * 3 + l], s0, s1);
+				bool degenerate = std::abs(a[l]) < eps;
+
+				// Lanes that are still active failed to converge, same as solveCubic
+				counts[l] = int(degenerate) * numDegenerate + int(!degenerate) * int(Mask(1) - active[l]) * (numFactored + 1);
+				roots[l * 3 + 0] = ez::simd::select(degenerate, s0, root[l]);
+				roots[l * 3 + 1] = ez::simd::select(degenerate, s1, q0);
+				roots[l * 3 + 2] = q1;
+			}
+		}
+
+		// Newton steps used to polish the closed form roots. The step count is fixed, and a step is only taken if it improves the residual.
+		template<typename T>
+		T polishCubicRoot(T a, T b, T c, T d, T x) noexcept {
+			for (int i = 0; i < 2; ++i) {
+				T fx = poly::evaluate(a, b, c, d, x);
+				T next = x - fx / poly::derivativeAt(a, b, c, x);
+				x = std::abs(poly::evaluate(a, b, c, d, next)) < std::abs(fx) ? next : x;
+			}
+			return x;
+		}
+
+		// Closed form cubic solver. Every case is computed and then selected, so the cost does not depend on the input.
+		// The roots are written in ascending order, repeated roots are only written once.
+		template<typename T>
+		int cubicAnalyticLane(T a, T b, T c, T d, T& r0, T& r1, T& r2) noexcept {
+			constexpr T eps = ez::epsilon<T>() * T(10);
+			constexpr T third = T(1) / T(3);
+			constexpr T sector = ez::tau<T>() / T(3);
+
+			// Normalize and depress the cubic, x = t - shift
+			// t^3 + 3 * hp * t + 2 * hq = 0
+			T inv = T(1) / a;
+			T nb = b * inv;
+			T nc = c * inv;
+			T nd = d * inv;
+			T shift = nb * third;
+			T hp = (nc - nb * shift) * third;
+			T hq = (shift * (T(2) * shift * shift - nc) + nd) * T(0.5);
+			T disc = hq * hq + hp * hp * hp;
+
+			// Rough magnitude of the roots, the tolerances are relative to it
+			T mag = std::max(std::abs(shift), std::max(std::sqrt(std::abs(nc)), std::cbrt(std::abs(nd))));
+
+			bool triple = std::abs(hp) <= eps * mag * mag && std::abs(hq) <= eps * mag * mag * mag;
+			bool repeated = std::abs(disc) <= eps * (hq * hq + std::abs(hp * hp * hp));
+			bool single = disc > T(0);
+
+			// One real root, cardano's method
+			T u = std::cbrt(-hq - std::copysign(std::sqrt(std::max(disc, T(0))), hq));
+			T t0 = u == T(0) ? T(0) : u - hp / u;
+
+			// Three real roots, trigonometric method
+			T m = std::sqrt(std::max(-hp, T(0)));
+			T cosine = m > T(0) ? -hq / (m * m * m) : T(0);
+			T theta = std::acos(std::max(T(-1), std::min(cosine, T(1)))) * third;
+			T tlow = T(2) * m * std::cos(theta + sector);
+			T tmid = T(2) * m * std::cos(theta - sector);
+			T thigh = T(2) * m * std::cos(theta);
+
+			// One simple root, one double root
+			T w = std::cbrt(-hq);
+			T dlow = std::min(T(2) * w, -w);
+			T dhigh = std::max(T(2) * w, -w);
+
+			T x0 =
+				triple ? T(0) :
+				repeated ? dlow :
+				single ? t0 : tlow;
+			T x1 = repeated ? dhigh : tmid;
+			T x2 = thigh;
+
+			T s0, s1;
+			int numDegenerate = quadraticLane(b, c, d, s0, s1);
+			bool degenerate = std::abs(a) < eps;
+
+			r0 = degenerate ? s0 : polishCubicRoot(a, b, c, d, x0 - shift);
+			r1 = degenerate ? s1 : polishCubicRoot(a, b, c, d, x1 - shift);
+			r2 = polishCubicRoot(a, b, c, d, x2 - shift);
+
+			return
+				degenerate ? numDegenerate :
+				triple ? 1 :
+				repeated ? 2 :
+				single ? 1 : 3;
+		}
+
+		// Each lane calls acos, cos and cbrt from libm, so unlike the newton lanes this loop stays scalar
+		template<typename T, std::size_t N>
+		void solveCubicLanes(Analytic, const T* a, const T* b, const T* c, const T* d, int* counts, T* roots) noexcept {
+			EZ_POLY_LANE_LOOP
+			for (std::size_t l = 0; l < N; ++l) {
+				counts[l] = cubicAnalyticLane(a[l], b[l], c[l], d[l], roots[l * 3 + 0], roots[l * 3 + 1], roots[l * 3 + 2]);
+			}
+		}
+	};
+
+	// Closed form cubic solver, using the trigonometric method for three real roots and cardano's method otherwise.
+	// The result is polished with a fixed number of newton steps, so the cost does not depend on the input.
+	// Roots are written in ascending order, repeated roots are written once.
+	template<typename T, typename output_iter>
+	int solveCubicAnalytic(T a, T b, T c, T d, output_iter output) {
+		static_assert(is_real_vec_v<T>, "ez::poly::solveCubicAnalytic requires floating point types!");
+		static_assert(is_output_iterator_v<output_iter>, "ez::poly::solveCubicAnalytic requires the iterator passed in to be an output iterator.");
+		static_assert(is_iterator_writable_v<output_iter, T>, "ez::poly::solveCubicAnalytic cannot convert type to iterator value_type!");
+
+		std::array<T, 3> roots;
+		int count = intern::cubicAnalyticLane(a, b, c, d, roots[0], roots[1], roots[2]);
+		for (int i = 0; i < count; ++i) {
+			*output++ = roots[i];
+		}
+		return count;
+	}
+
+	// Select the cubic solver with a policy tag, ie solveCubic(ez::poly::analytic, a, b, c, d, output)
+	template<typename T, typename output_iter>
+	int solveCubic(Newton, T a, T b, T c, T d, output_iter output) {
+		return solveCubic(a, b, c, d, output);
+	}
+	template<typename T, typename output_iter>
+	int solveCubic(Analytic, T a, T b, T c, T d, output_iter output) {
+		return solveCubicAnalytic(a, b, c, d, output);
+	}
+
+	// Solves many cubic polynomials at once, with the coefficients given as separate arrays (structure of arrays).
+	// The number of roots found for polynomial i is written to counts[i], and the roots to roots[i * 3 + k].
+	// Root slots past counts[i] are left unspecified. The results are the same as calling solveCubic with the same policy on each polynomial.
+	template<typename Policy, typename T>
+	void solveCubicBatch(Policy policy, const T* a, const T* b, const T* c, const T* d, std::size_t count, int* counts, T* roots) noexcept {
+		static_assert(std::is_floating_point_v<T>, "ez::poly::solveCubicBatch requires floating point types!");
+
+		constexpr std::size_t N = ez::simd::lanes<T>();
+
+		std::size_t i = 0;
+		for (; i + N <= count; i += N) {
+			intern::solveCubicLanes<T, N>(policy, a + i, b + i, c + i, d + i, counts + i, roots + i * 3);
+		}
+
+		if (i < count) {
+			// Pad the remainder out to a full set of lanes, using x^3 which is trivial for every policy.
+			std::size_t rem = count - i;
+			T pa[N], pb[N], pc[N], pd[N], proots[N * 3];
+			int pcounts[N];
+			for (std::size_t l = 0; l < N; ++l) {
+				bool valid = l < rem;
+				pa[l] = valid ? a[i + l] : T(1);
+				pb[l] = valid ? b[i + l] : T(0);
+				pc[l] = valid ? c[i + l] : T(0);
+				pd[l] = valid ? d[i + l] : T(0);
+			}
+
+			intern::solveCubicLanes<T, N>(policy, pa, pb, pc, pd, pcounts, proots);
+
+			for (std::size_t l = 0; l < rem; ++l) {
+				counts[i + l] = pcounts[l];
+				roots[(i + l) * 3 + 0] = proots[l * 3 + 0];
+				roots[(i + l) * 3 + 1] = proots[l * 3 + 1];
+				roots[(i + l) * 3 + 2] = proots[l * 3 + 2];
+			}
+		}
+	}
+
+	template<typename T>
+	void solveCubicBatch(const T* a, const T* b, const T* c, const T* d, std::size_t count, int* counts, T* roots) noexcept {
+		solveCubicBatch(Newton{}, a, b, c, d, count, counts, roots);
+	}
+
+	namespace intern {
+		// Monic quadratic x^2 + b * x + c. A discriminant that is negative only by rounding error counts as a double root.
+		template<typename T>
+		int solveMonicQuadratic(T b, T c, T* roots) noexcept {
+			constexpr T eps = ez::epsilon<T>() * T(64);
+
+			T det = b * b - T(4) * c;
+			if (det < -eps * (b * b + std::abs(T(4) * c))) {
+				return 0;
+			}
+
+			// Take the larger root first, to avoid cancellation
+			T q = T(-0.5) * (b + std::copysign(std::sqrt(std::max(det, T(0))), b));
+			roots[0] = q;
+			roots[1] = q == T(0) ? T(0) : c / q;
+			return 2;
+		}
+
+		template<typename T>
+		T polishQuarticRoot(T a, T b, T c, T d, T e, T x) noexcept {
+			for (int i = 0; i < 2; ++i) {
+				T fx = (((a * x + b) * x + c) * x + d) * x + e;
+				T dfx = ((T(4) * a * x + T(3) * b) * x + T(2) * c) * x + d;
+				T next = x - fx / dfx;
+				T fnext = (((a * next + b) * next + c) * next + d) * next + e;
+				x = std::abs(fnext) < std::abs(fx) ? next : x;
+			}
+			return x;
+		}
+
+		// Whether the quartic is zero at x, to within a rounding of its largest terms
+		template<typename T>
+		bool quarticVanishes(T a, T b, T c, T d, T e, T x) noexcept {
+			T ax = std::abs(x);
+			T fx = (((a * x + b) * x + c) * x + d) * x + e;
+			T scale = (((std::abs(a) * ax + std::abs(b)) * ax + std::abs(c)) * ax + std::abs(d)) * ax + std::abs(e);
+			return std::abs(fx) <= std::numeric_limits<T>::epsilon() * scale;
+		}
+	};
+
+	// Quartic solver, using ferrari's method with the resolvent cubic solved by solveCubicAnalytic.
+	// Roots are polished with newton steps, and written in ascending order. Repeated roots are written once,
+	// roots closer than about the square root of the epsilon of T, or with the quartic vanishing between them, are considered repeated.
+	template<typename T, typename output_iter>
+	int solveQuartic(T a, T b, T c, T d, T e, output_iter output) {
+		static_assert(is_real_vec_v<T>, "ez::poly::solveQuartic requires floating point types!");
+		static_assert(is_output_iterator_v<output_iter>, "ez::poly::solveQuartic requires the iterator passed in to be an output iterator.");
+		static_assert(is_iterator_writable_v<output_iter, T>, "ez::poly::solveQuartic cannot convert type to iterator value_type!");
 
-		// number of iterations to perform
-		int icount = 128;
 		constexpr T eps = ez::epsilon<T>() * T(10);
 
-		for (int i = 0; i < icount; ++i) {
-			int valid = 0;
-			for (int k = 0; k < 3; ++k) {
-				glm::tcomplex<T> root = roots[k];
-
-				glm::tcomplex<T> factor =  
-					poly::evaluate(a, b, c, d, root) /
-					poly::evaluate(deriv[0], deriv[1], deriv[2], root);
-				
-				glm::tcomplex<T> repulsion{ T(0), T(0) };
-				for (int j = 0; j < 3; ++j) {
-					if (j != k) {
-						repulsion += T(1) / (root - roots[j]);
+		if (std::abs(a) < eps) {
+			return solveCubicAnalytic(b, c, d, e, output);
+		}
+
+		// Normalize and depress the quartic, x = y - shift
+		// y^4 + p * y^2 + q * y + r = 0
+		T inv = T(1) / a;
+		T nb = b * inv;
+		T nc = c * inv;
+		T nd = d * inv;
+		T ne = e * inv;
+		T nb2 = nb * nb;
+		T shift = nb * T(0.25);
+		T p = nc - T(0.375) * nb2;
+		T q = nd - T(0.5) * nb * nc + T(0.125) * nb2 * nb;
+		T r = ne - T(0.25) * nb * nd + T(0.0625) * nb2 * nc - T(3) / T(256) * nb2 * nb2;
+
+		// Resolvent cubic 8m^3 - 4pm^2 - 8rm + 4pr - q^2 = 0. Its largest root m makes
+		// (y^2 + m)^2 = (2m - p) * y^2 - q * y + m^2 - r a difference of two squares.
+		std::array<T, 3> resolvent;
+		int numResolvent = solveCubicAnalytic(T(8), T(-4) * p, T(-8) * r, T(4) * p * r - q * q, resolvent.begin());
+		T m = resolvent[numResolvent - 1];
+		T s2 = T(2) * m - p;
+
+		std::array<T, 4> roots;
+		int count = 0;
+		// Depressing the quartic cancels away the precision of p, q and r when the roots are close together compared to the shift,
+		// which can push the discriminant of a factor with a double root well below zero. The quartic itself still vanishes at its vertex.
+		auto factor = [&](T fb, T fc) {
+			int found = intern::solveMonicQuadratic(fb, fc, roots.data() + count);
+			if (found == 0 && intern::quarticVanishes(a, b, c, d, e, T(-0.5) * fb - shift)) {
+				roots[count] = T(-0.5) * fb;
+				found = 1;
+			}
+			count += found;
+		};
+		if (s2 > eps * std::max(std::abs(p), std::abs(m))) {
+			T s = std::sqrt(s2);
+			T h = q / (T(2) * s);
+			factor(-s, m + h);
+			factor(s, m - h);
+		}
+		else {
+			// q is zero, so the quartic is a quadratic in y^2
+			std::array<T, 2> squares;
+			int numSquares = intern::solveMonicQuadratic(p, r, squares.data());
+			for (int i = 0; i < numSquares; ++i) {
+				if (squares[i] >= -eps * std::max(std::abs(p), T(1))) {
+					T y = std::sqrt(std::max(squares[i], T(0)));
+					roots[count++] = -y;
+					roots[count++] = y;
+				}
+			}
+		}
+
+		for (int i = 0; i < count; ++i) {
+			roots[i] = intern::polishQuarticRoot(a, b, c, d, e, roots[i] - shift);
+		}
+
+		// Sorting network over the four slots, the unused ones are set to infinity so they end up last.
+		// std::sort makes gcc warn about its code path for more than sixteen elements.
+		for (int i = count; i < 4; ++i) {
+			roots[i] = std::numeric_limits<T>::infinity();
+		}
+		constexpr int network[5][2] = { { 0, 1 }, { 2, 3 }, { 0, 2 }, { 1, 3 }, { 1, 2 } };
+		for (const auto& pair : network) {
+			T low = std::min(roots[pair[0]], roots[pair[1]]);
+			roots[pair[1]] = std::max(roots[pair[0]], roots[pair[1]]);
+			roots[pair[0]] = low;
+		}
+
+		const T tolerance = std::sqrt(ez::epsilon<T>());
+		int written = 0;
+		for (int i = 0; i < count; ++i) {
+			// Rounding pulls a double root apart, but the quartic still vanishes between the two halves
+			if (i > 0 && (roots[i] - roots[i - 1] <= tolerance * std::max(T(1), std::abs(roots[i])) ||
+				intern::quarticVanishes(a, b, c, d, e, (roots[i - 1] + roots[i]) * T(0.5)))) {
+				continue;
+			}
+			*output++ = roots[i];
+			++written;
+		}
+		return written;
+	}
+
+	namespace intern {
+		// Floats are solved in double precision, so that the rounding of the coefficients in float is the only error that counts
+		template<typename T>
+		using root_work_t = std::conditional_t<std::is_same_v<T, float>, double, T>;
+
+		// Horner evaluation of the ascending coefficients c[0] .. c[degree]
+		template<typename T>
+		constexpr T evaluateHorner(const T* c, int degree, T t) noexcept {
+			T result = c[degree];
+			for (int i = degree - 1; i >= 0; --i) {
+				result = result * t + c[i];
+			}
+			return result;
+		}
+
+		// floor(log2(n)), and zero for zero
+		constexpr std::size_t floorLog2(std::size_t n) noexcept {
+			std::size_t result = 0;
+			while (n > 1) {
+				n /= 2;
+				++result;
+			}
+			return result;
+		}
+
+		// Estrin evaluation of the coefficients c[First] .. c[First + Count - 1], given t^1, t^2, t^4 ... in powers.
+		// The range is split at the largest power of two below Count, p(t) = low(t) + t^half * high(t), and both halves are
+		// independent, so the dependency chain is log2(N) steps long instead of N.
+		template<std::size_t First, std::size_t Count, typename T, std::size_t N>
+		EZ_MATH_INLINE constexpr T evaluateEstrin(const std::array<T, N + 1>& c, const T* powers) noexcept {
+			if constexpr (Count == 1) {
+				return c[First];
+			}
+			else {
+				constexpr std::size_t level = floorLog2(Count - 1);
+				constexpr std::size_t half = std::size_t(1) << level;
+				return evaluateEstrin<First, half, T, N>(c, powers) + powers[level] * evaluateEstrin<First + half, Count - half, T, N>(c, powers);
+			}
+		}
+
+		template<typename T, std::size_t N>
+		EZ_MATH_INLINE constexpr T evaluateEstrin(const std::array<T, N + 1>& c, T t) noexcept {
+			T powers[floorLog2(N) + 1]{};
+			powers[0] = t;
+			for (std::size_t i = 1; i < std::size(powers); ++i) {
+				powers[i] = powers[i - 1] * powers[i - 1];
+			}
+			return evaluateEstrin<0, N + 1, T, N>(c, powers);
+		}
+
+		// Horner evaluation with the rounding error of every step recovered exactly, using fma for the products,
+		// and added back at the end. The result is as accurate as Horner's method in twice the working precision.
+		// The steps are unrolled at compile time, which gcc does not do by itself for a body this size, so that batches vectorize.
+		template<std::size_t I, typename T, std::size_t N>
+		EZ_MATH_INLINE void compensatedStep(const std::array<T, N + 1>& c, T t, T& result, T& error) noexcept {
+			T product = result * t;
+			T productError = std::fma(result, t, -product);
+
+			T sum = product + c[I];
+			T z = sum - product;
+			T sumError = (product - (sum - z)) + (c[I] - z);
+
+			error = error * t + (productError + sumError);
+			result = sum;
+			if constexpr (I > 0) {
+				compensatedStep<I - 1, T, N>(c, t, result, error);
+			}
+		}
+
+		template<typename T, std::size_t N>
+		EZ_MATH_INLINE T evaluateCompensated(const std::array<T, N + 1>& c, T t) noexcept {
+			T result = c[N];
+			T error = T(0);
+			if constexpr (N > 0) {
+				compensatedStep<N - 1, T, N>(c, t, result, error);
+			}
+			return result + error;
+		}
+
+		// Bracketed newton iteration on [lo, hi], where the polynomial changes sign.
+		// Falls back to bisection whenever the newton step leaves the bracket.
+		template<typename T>
+		T refineRoot(const T* c, const T* dc, int degree, T lo, T hi) noexcept {
+			T flo = evaluateHorner(c, degree, lo);
+			T x = T(0.5) * (lo + hi);
+
+			for (int i = 0; i < 128; ++i) {
+				T fx = evaluateHorner(c, degree, x);
+				if (fx == T(0)) {
+					break;
+				}
+				if ((fx < T(0)) == (flo < T(0))) {
+					lo = x;
+					flo = fx;
+				}
+				else {
+					hi = x;
+				}
+
+				T next = x - fx / evaluateHorner(dc, degree - 1, x);
+				if (!(next > lo && next < hi)) {
+					next = T(0.5) * (lo + hi);
+				}
+				if (next == x || hi - lo <= ez::epsilon<T>() * std::max(std::abs(lo), std::abs(hi))) {
+					x = next;
+					break;
+				}
+				x = next;
+			}
+			return x;
+		}
+
+		// The rounding error of evaluating c[0] + c[1] * t + ... + c[degree] * t^degree at x, when the coefficients are only exact to eps.
+		// The terms round independently, so their errors add up like a random walk, about one and a half roundings per degree.
+		template<typename T>
+		T evaluationError(const T* c, int degree, T x, T eps) noexcept {
+			T scale = T(0), power = T(1);
+			for (int i = 0; i <= degree; ++i) {
+				scale += (c[i] * power) * (c[i] * power);
+				power *= x;
+			}
+			return T(3 * degree) / T(2) * eps * std::sqrt(scale);
+		}
+
+		// The distinct real roots of c[0] + c[1] * t + ... + c[degree] * t^degree in [lo, hi], written to roots in ascending order.
+		// The leading coefficient must not be zero. The range is split into monotonic pieces at the roots of the derivative, found the same way,
+		// and the pieces where the sign changes are refined with bracketed newton steps. Values within rounding error of zero count as roots,
+		// eps being the precision the coefficients are exact to. That catches the repeated roots at an extremum, even when rounding has moved them
+		// apart or off the real line. The pieces on either side are then part of the same cluster, and not searched.
+		template<typename T, std::size_t N>
+		int monotonicRoots(const T* c, int degree, T lo, T hi, T eps, T* roots) noexcept {
+			if (degree == 1) {
+				roots[0] = -c[0] / c[1];
+				return roots[0] >= lo && roots[0] <= hi ? 1 : 0;
+			}
+
+			std::array<T, N + 1> dc{};
+			for (int i = 1; i <= degree; ++i) {
+				dc[i - 1] = T(i) * c[i];
+			}
+
+			// The range split at the extrema inside it
+			std::array<T, N + 1> bounds;
+			int numBounds = 1 + monotonicRoots<T, N>(dc.data(), degree - 1, lo, hi, eps, bounds.data() + 1);
+			bounds[0] = lo;
+			if (bounds[numBounds - 1] < hi) {
+				bounds[numBounds++] = hi;
+			}
+
+			// Rounding pulls a repeated root apart to where the curvature makes up for the error, so that is how far a cluster reaches
+			std::array<T, N + 1> values, reach;
+			std::array<bool, N + 1> zero;
+			for (int i = 0; i < numBounds; ++i) {
+				T error = evaluationError(c, degree, bounds[i], eps);
+				T curvature = T(0);
+				for (int k = degree; k > 1; --k) {
+					curvature = curvature * bounds[i] + T(k * (k - 1)) * c[k];
+				}
+				values[i] = evaluateHorner(c, degree, bounds[i]);
+				zero[i] = std::abs(values[i]) <= error;
+				reach[i] = std::sqrt(T(8) * error / std::abs(curvature));
+			}
+			auto near = [&](T root, int i) {
+				return zero[i] && std::abs(root - bounds[i]) <= reach[i];
+			};
+
+			// The roots of the pieces, those next to a zero bound are part of its cluster
+			std::array<T, N + 1> crossings;
+			std::array<bool, N + 1> distinct{};
+			for (int i = 1; i < numBounds; ++i) {
+				if (values[i - 1] != T(0) && values[i] != T(0) && (values[i - 1] < T(0)) != (values[i] < T(0))) {
+					crossings[i] = refineRoot(c, dc.data(), degree, bounds[i - 1], bounds[i]);
+					distinct[i] = !near(crossings[i], i - 1) && !near(crossings[i], i);
+				}
+			}
+
+			// Zero bounds are roots, unless the polynomial crosses zero beside them, further away than a cluster would reach.
+			// Neighbouring zero bounds within reach of each other are one flat cluster, and only the one closest to zero is kept.
+			int count = 0, last = -1;
+			for (int i = 0; i < numBounds; ++i) {
+				if (i > 0 && distinct[i]) {
+					roots[count++] = crossings[i];
+				}
+				if (!zero[i] || (i > 0 && distinct[i]) || (i + 1 < numBounds && distinct[i + 1])) {
+					continue;
+				}
+				if (last == i - 1 && last >= 0 && near(bounds[i], last)) {
+					if (std::abs(values[i]) < std::abs(values[last])) {
+						roots[count - 1] = bounds[i];
+						last = i;
 					}
+					continue;
 				}
+				roots[count++] = bounds[i];
+				last = i;
+			}
+			return count;
+		}
 
-				glm::tcomplex<T> offset = factor / (T(1) - factor * repulsion);
-				roots[k] -= offset;
+		// The distinct real roots of c[0] + c[1] * t + ... + c[N] * t^N in [lo, hi], in ascending order
+		template<typename T, std::size_t N, typename output_iter>
+		int solvePolynomial(const std::array<T, N + 1>& coefficients, T lo, T hi, output_iter& output) {
+			using W = root_work_t<T>;
+			if (!(lo <= hi)) {
+				return 0;
+			}
 
-				if (std::abs(offset.real()) < eps && std::abs(offset.imag()) < eps) {
-					++valid;
+			std::array<W, N + 1> c;
+			int degree = -1;
+			for (std::size_t i = 0; i <= N; ++i) {
+				c[i] = W(coefficients[i]);
+				degree = c[i] != W(0) ? int(i) : degree;
+			}
+			// Leading terms too small to change the value anywhere in the range are rounding error, for example from degree elevation,
+			// and dividing by them would wreck the search
+			W reach = std::max(std::abs(W(lo)), std::abs(W(hi)));
+			while (degree > 0) {
+				W lower = W(0), power = W(1);
+				for (int i = 0; i < degree; ++i) {
+					lower += std::abs(c[i]) * power;
+					power *= reach;
 				}
+				if (!(std::abs(c[degree]) * power < W(ez::epsilon<T>()) * lower)) {
+					break;
+				}
+				--degree;
+			}
+			if (degree <= 0) {
+				// Constant, either no roots or all of them
+				return 0;
 			}
 
-			if (valid == 3) {
-				break;
+			// Cauchy's bound, every root lies strictly within it
+			W bound = W(0);
+			for (int i = 0; i < degree; ++i) {
+				bound = std::max(bound, std::abs(c[i] / c[degree]));
+			}
+			bound += W(1);
+			// A root on lo or hi evaluates to rounding error there, of either sign, so the signs at the ends cannot be trusted.
+			// Search a slightly wider range instead, roots outside [lo, hi] are only kept if the polynomial vanishes at that end.
+			W widen = std::sqrt(W(ez::epsilon<T>()));
+			W reachLo = widen * std::max(W(1), std::abs(W(lo)));
+			W reachHi = widen * std::max(W(1), std::abs(W(hi)));
+			W wlo = std::max(W(lo) - reachLo, -bound);
+			W whi = std::min(W(hi) + reachHi, bound);
+			if (!(wlo < whi)) {
+				return 0;
+			}
+
+			// Collect the roots in the working precision before converting them.
+			// The coefficients are only exact in T, which sets the rounding error that counts as zero.
+			std::array<W, N> roots;
+			int found = monotonicRoots<W, N>(c.data(), degree, wlo, whi, W(std::numeric_limits<T>::epsilon()), roots.data());
+
+			// Zero to within the rounding error of evaluating the coefficients.
+			// Roots at that end are found anywhere the value is within the same error, so the window around the end that they
+			// are put back on is that error turned into a distance through the slope, no further than the search was widened.
+			// Any further in they can be distinct roots close to the end.
+			auto snapDistance = [&](W x, W reach) {
+				W error = W(4) * evaluationError(c.data(), degree, x, W(ez::epsilon<T>()));
+				W value = evaluateHorner(c.data(), degree, x);
+				if (!(std::abs(value) <= error)) {
+					return W(-1);
+				}
+				W slope = W(0);
+				for (int i = degree; i > 0; --i) {
+					slope = slope * x + W(i) * c[i];
+				}
+				W ulps = W(4) * W(std::numeric_limits<T>::epsilon()) * std::max(W(1), std::abs(x));
+				return std::min(reach, std::max(ulps, error / std::abs(slope)));
+			};
+
+			// Roots found past an end where the polynomial vanishes, or close enough to it, are put exactly on that end
+			W distanceLo = snapDistance(W(lo), reachLo);
+			W distanceHi = snapDistance(W(hi), reachHi);
+			bool zeroLo = distanceLo >= W(0);
+			bool zeroHi = distanceHi >= W(0);
+			W snapLo = W(lo) + distanceLo;
+			W snapHi = W(hi) - distanceHi;
+
+			W cluster = std::sqrt(W(std::numeric_limits<T>::epsilon()));
+			T previous{ 0 };
+			int count = 0;
+			for (int i = 0; i < found; ++i) {
+				W root = roots[i];
+				if (zeroLo && root < snapLo) {
+					root = W(lo);
+				}
+				else if (zeroHi && root > snapHi) {
+					root = W(hi);
+				}
+				else if (root < W(lo) || root > W(hi)) {
+					continue;
+				}
+				// Snapping can land two roots on the same end, and the refined roots of one rounded apart cluster can still differ in the last bits
+				if (count == 0 || std::abs(root - W(previous)) > cluster * std::abs(root)) {
+					previous = T(root);
+					*output++ = previous;
+					++count;
+				}
+			}
+			return count;
+		}
+	};
+
+	// Evaluation policies for Polynomial.
+	// Horner is a single chain of multiply adds, with the least work and a small rounding error.
+	// Estrin splits the chain into independent pairs of terms, which the processor can overlap at higher degrees, for a little more rounding error.
+	// CompensatedHorner also tracks the rounding error of each step, for nearly twice the precision. It relies on std::fma,
+	// which is slow when the target has no fused multiply add instruction. Under -ffast-math the compiler reorders the error terms away,
+	// and it is no more accurate than Horner.
+	struct Horner {};
+	struct Estrin {};
+	struct CompensatedHorner {};
+
+	inline constexpr Horner horner{};
+	inline constexpr Estrin estrin{};
+	inline constexpr CompensatedHorner compensatedHorner{};
+
+	/*
+		Polynomial of fixed degree N, c[0] + c[1] * t + ... + c[N] * t^N.
+		Note the coefficients are stored lowest power first, the reverse of the argument order of the loose functions above.
+
+		The roots are found between the extrema, where the polynomial is monotonic, with bracketed newton steps. The extrema are the roots of the derivative,
+		found the same way. Repeated roots are found once, at the extremum they sit on, even when rounding of the coefficients has pulled them apart.
+		Nothing is allocated, all storage is on the stack and sized by N.
+
+		The arithmetic is constexpr, and the degree of each result is worked out at compile time,
+		so a product of degrees N and M has degree N + M even when the leading coefficients cancel.
+	*/
+	template<typename T, std::size_t N>
+	struct Polynomial {
+		static_assert(std::is_floating_point_v<T>, "ez::poly::Polynomial requires floating point types!");
+
+		using value_type = T;
+		static constexpr std::size_t degree = N;
+
+		std::array<T, N + 1> coefficients;
+
+		constexpr T& operator[](std::size_t power) noexcept {
+			return coefficients[power];
+		}
+		constexpr const T& operator[](std::size_t power) const noexcept {
+			return coefficients[power];
+		}
+
+		constexpr T operator()(T t) const noexcept {
+			return intern::evaluateHorner(coefficients.data(), int(N), t);
+		}
+
+		constexpr T evaluate(Horner, T t) const noexcept {
+			return intern::evaluateHorner(coefficients.data(), int(N), t);
+		}
+		constexpr T evaluate(Estrin, T t) const noexcept {
+			return intern::evaluateEstrin<T, N>(coefficients, t);
+		}
+		T evaluate(CompensatedHorner, T t) const noexcept {
+			return intern::evaluateCompensated<T, N>(coefficients, t);
+		}
+
+		// Evaluate at count values of t. The loop is vectorized across the values, so this is much faster than calling evaluate in a loop.
+		template<typename Policy = Horner>
+		void evaluate(const T* t, T* out, std::size_t count, Policy policy = Policy{}) const noexcept {
+			EZ_MATH_VECTORIZE
+			for (std::size_t i = 0; i < count; ++i) {
+				out[i] = evaluate(policy, t[i]);
+			}
+		}
+
+		// The first derivative at t, without forming the derivative polynomial
+		constexpr T derivativeAt(T t) const noexcept {
+			if constexpr (N == 0) {
+				return T(0);
+			}
+			else {
+				T result = T(N) * coefficients[N];
+				for (std::size_t i = N - 1; i > 0; --i) {
+					result = result * t + T(i) * coefficients[i];
+				}
+				return result;
+			}
+		}
+
+		constexpr Polynomial<T, (N > 0 ? N - 1 : 0)> derivative() const noexcept {
+			Polynomial<T, (N > 0 ? N - 1 : 0)> result{};
+			for (std::size_t i = 1; i <= N; ++i) {
+				result.coefficients[i - 1] = T(i) * coefficients[i];
+			}
+			return result;
+		}
+
+		// The antiderivative with the given value at zero
+		constexpr Polynomial<T, N + 1> integral(T constant = T(0)) const noexcept {
+			Polynomial<T, N + 1> result{};
+			result.coefficients[0] = constant;
+			for (std::size_t i = 0; i <= N; ++i) {
+				result.coefficients[i + 1] = coefficients[i] / T(i + 1);
+			}
+			return result;
+		}
+
+		// The polynomial p(q(t)), expanded with horner's method on q
+		template<std::size_t M>
+		constexpr Polynomial<T, N * M> compose(const Polynomial<T, M>& q) const noexcept {
+			Polynomial<T, N * M> result{};
+			result.coefficients[0] = coefficients[N];
+			std::size_t degree = 0;
+
+			for (std::size_t i = N; i-- > 0;) {
+				// result = result * q + c[i]
+				Polynomial<T, N * M> product{};
+				for (std::size_t j = 0; j <= degree; ++j) {
+					for (std::size_t k = 0; k <= M; ++k) {
+						product.coefficients[j + k] += result.coefficients[j] * q.coefficients[k];
+					}
+				}
+				product.coefficients[0] += coefficients[i];
+				result = product;
+				degree += M;
+			}
+			return result;
+		}
+
+		// The taylor shift p(t + shift), by repeated synthetic division
+		constexpr Polynomial shift(T amount) const noexcept {
+			Polynomial result = *this;
+			for (std::size_t i = 0; i < N; ++i) {
+				for (std::size_t j = N; j-- > i;) {
+					result.coefficients[j] += amount * result.coefficients[j + 1];
+				}
 			}
+			return result;
+		}
+
+		// Writes the distinct real roots in ascending order, returning the number written, at most N.
+		// A polynomial that is constant has no roots.
+		template<typename output_iter>
+		int solve(output_iter output) const {
+			static_assert(is_output_iterator_v<output_iter>, "ez::poly::Polynomial::solve requires the iterator passed in to be an output iterator.");
+			static_assert(is_iterator_writable_v<output_iter, T>, "ez::poly::Polynomial::solve cannot convert type to iterator value_type!");
+
+			return intern::solvePolynomial<T, N>(coefficients, -std::numeric_limits<T>::max(), std::numeric_limits<T>::max(), output);
 		}
 
-		int found = 0;
-		for (int i = 0; i < 3; ++i) {
-			if (std::abs(roots[i].imag()) < eps) {
-				*output++ = roots[i].real();
-				++found;
+		// Same as solve, but only the roots in [lo, hi]
+		template<typename output_iter>
+		int solveInRange(T lo, T hi, output_iter output) const {
+			static_assert(is_output_iterator_v<output_iter>, "ez::poly::Polynomial::solveInRange requires the iterator passed in to be an output iterator.");
+			static_assert(is_iterator_writable_v<output_iter, T>, "ez::poly::Polynomial::solveInRange cannot convert type to iterator value_type!");
+
+			return intern::solvePolynomial<T, N>(coefficients, lo, hi, output);
+		}
+	};
+
+	template<typename T, std::size_t N, std::size_t M>
+	constexpr bool operator==(const Polynomial<T, N>& lh, const Polynomial<T, M>& rh) noexcept {
+		for (std::size_t i = 0; i <= std::max(N, M); ++i) {
+			T l = i <= N ? lh.coefficients[i] : T(0);
+			T r = i <= M ? rh.coefficients[i] : T(0);
+			if (l != r) {
+				return false;
 			}
 		}
-		return found;
+		return true;
+	}
+	template<typename T, std::size_t N, std::size_t M>
+	constexpr bool operator!=(const Polynomial<T, N>& lh, const Polynomial<T, M>& rh) noexcept {
+		return !(lh == rh);
+	}
+
+	template<typename T, std::size_t N>
+	constexpr Polynomial<T, N> operator-(const Polynomial<T, N>& value) noexcept {
+		Polynomial<T, N> result{};
+		for (std::size_t i = 0; i <= N; ++i) {
+			result.coefficients[i] = -value.coefficients[i];
+		}
+		return result;
+	}
+
+	template<typename T, std::size_t N, std::size_t M>
+	constexpr Polynomial<T, std::max(N, M)> operator+(const Polynomial<T, N>& lh, const Polynomial<T, M>& rh) noexcept {
+		Polynomial<T, std::max(N, M)> result{};
+		for (std::size_t i = 0; i <= N; ++i) {
+			result.coefficients[i] += lh.coefficients[i];
+		}
+		for (std::size_t i = 0; i <= M; ++i) {
+			result.coefficients[i] += rh.coefficients[i];
+		}
+		return result;
+	}
+
+	template<typename T, std::size_t N, std::size_t M>
+	constexpr Polynomial<T, std::max(N, M)> operator-(const Polynomial<T, N>& lh, const Polynomial<T, M>& rh) noexcept {
+		return lh + -rh;
+	}
+
+	template<typename T, std::size_t N, std::size_t M>
+	constexpr Polynomial<T, N + M> operator*(const Polynomial<T, N>& lh, const Polynomial<T, M>& rh) noexcept {
+		Polynomial<T, N + M> result{};
+		for (std::size_t i = 0; i <= N; ++i) {
+			for (std::size_t j = 0; j <= M; ++j) {
+				result.coefficients[i + j] += lh.coefficients[i] * rh.coefficients[j];
+			}
+		}
+		return result;
+	}
+
+	template<typename T, std::size_t N>
+	constexpr Polynomial<T, N> operator*(const Polynomial<T, N>& lh, T rh) noexcept {
+		Polynomial<T, N> result{};
+		for (std::size_t i = 0; i <= N; ++i) {
+			result.coefficients[i] = lh.coefficients[i] * rh;
+		}
+		return result;
+	}
+	template<typename T, std::size_t N>
+	constexpr Polynomial<T, N> operator*(T lh, const Polynomial<T, N>& rh) noexcept {
+		return rh * lh;
+	}
+	template<typename T, std::size_t N>
+	constexpr Polynomial<T, N> operator/(const Polynomial<T, N>& lh, T rh) noexcept {
+		return lh * (T(1) / rh);
+	}
+
+	namespace intern {
+		// True when a * t^3 + b * t^2 + c * t + d provably has no root in [lo, hi].
+		// The taylor expansion around the midpoint bounds how far the polynomial can move from its value there.
+		template<typename T>
+		bool excludesRoots(T a, T b, T c, T d, T lo, T hi) noexcept {
+			constexpr T eps = ez::epsilon<T>() * T(16);
+
+			T m = T(0.5) * (lo + hi);
+			T h = T(0.5) * (hi - lo);
+			T am = std::abs(m);
+
+			T f = ((a * m + b) * m + c) * m + d;
+			T d1 = (T(3) * a * m + T(2) * b) * m + c;
+			T d2 = T(3) * a * m + b;
+			T spread = ((std::abs(a) * h + std::abs(d2)) * h + std::abs(d1)) * h;
+
+			// Rounding error of the evaluation, so a root on the boundary is never excluded
+			T error = eps * (((std::abs(a) * am + std::abs(b)) * am + std::abs(c)) * am + std::abs(d) + spread);
+			return std::abs(f) > spread + error;
+		}
+
+		// Writes the root unless it repeats the previous one
+		template<typename T, typename output_iter>
+		void writeRoot(T root, T* previous, int& count, output_iter& output) {
+			if (count > 0 && root <= *previous) {
+				return;
+			}
+			*output++ = root;
+			*previous = root;
+			++count;
+		}
+	};
+
+	// Same as solveQuadratic, but only the roots in [lo, hi], in ascending order.
+	// A bound on the polynomial over the range rejects most ranges without a root before solving.
+	template<typename T, typename output_iter>
+	int solveQuadraticInRange(T a, T b, T c, T lo, T hi, output_iter output) {
+		static_assert(is_real_vec_v<T>, "ez::poly::solveQuadraticInRange requires floating point types!");
+		static_assert(is_output_iterator_v<output_iter>, "ez::poly::solveQuadraticInRange requires the iterator passed in to be an output iterator.");
+		static_assert(is_iterator_writable_v<output_iter, T>, "ez::poly::solveQuadraticInRange cannot convert type to iterator value_type!");
+
+		if (!(lo <= hi) || intern::excludesRoots(T(0), a, b, c, lo, hi)) {
+			return 0;
+		}
+
+		std::array<T, 2> roots;
+		int found = solveQuadratic(a, b, c, roots.begin());
+
+		T previous{ 0 };
+		int count = 0;
+		for (int i = 0; i < found; ++i) {
+			if (roots[i] >= lo && roots[i] <= hi) {
+				intern::writeRoot(roots[i], &previous, count, output);
+			}
+		}
+		return count;
+	}
+
+	// Same as solveCubic, but only the roots in [lo, hi], in ascending order. Repeated roots are written once.
+	// Ranges that a bound on the polynomial shows to be empty are rejected first. Otherwise the range is split into
+	// monotonic pieces at the roots of the derivative, and only the pieces where the sign changes are refined,
+	// with bracketed newton steps.
+	template<typename T, typename output_iter>
+	int solveCubicInRange(T a, T b, T c, T d, T lo, T hi, output_iter output) {
+		static_assert(is_real_vec_v<T>, "ez::poly::solveCubicInRange requires floating point types!");
+		static_assert(is_output_iterator_v<output_iter>, "ez::poly::solveCubicInRange requires the iterator passed in to be an output iterator.");
+		static_assert(is_iterator_writable_v<output_iter, T>, "ez::poly::solveCubicInRange cannot convert type to iterator value_type!");
+
+		constexpr T eps = ez::epsilon<T>() * T(10);
+
+		if (!(lo <= hi) || intern::excludesRoots(a, b, c, d, lo, hi)) {
+			return 0;
+		}
+		if (std::abs(a) < eps) {
+			return solveQuadraticInRange(b, c, d, lo, hi, output);
+		}
+
+		// Ascending coefficients for intern::refineRoot
+		const T co[4] = { d, c, b, a };
+		const T dco[3] = { c, T(2) * b, T(3) * a };
+
+		// The range split at the critical points inside it
+		std::array<T, 4> bounds;
+		int numBounds = 0;
+		bounds[numBounds++] = lo;
+
+		std::array<T, 2> critical;
+		if (intern::solveMonicQuadratic(T(2) * b / (T(3) * a), c / (T(3) * a), critical.data()) == 2) {
+			if (critical[0] > critical[1]) {
+				std::swap(critical[0], critical[1]);
+			}
+			for (T x : critical) {
+				if (x > bounds[numBounds - 1] && x < hi) {
+					bounds[numBounds++] = x;
+				}
+			}
+		}
+		bounds[numBounds++] = hi;
+
+		// Values within rounding error of zero count as roots, which catches the double root at a critical point
+		auto evaluate = [&](T x, bool& zero) {
+			T ax = std::abs(x);
+			T fx = poly::evaluate(a, b, c, d, x);
+			zero = std::abs(fx) <= eps * (((std::abs(a) * ax + std::abs(b)) * ax + std::abs(c)) * ax + std::abs(d));
+			return fx;
+		};
+
+		T previous{ 0 };
+		int count = 0;
+		bool zero0;
+		T f0 = evaluate(bounds[0], zero0);
+		for (int i = 1; i < numBounds; ++i) {
+			bool zero1;
+			T f1 = evaluate(bounds[i], zero1);
+
+			if (zero0) {
+				intern::writeRoot(bounds[i - 1], &previous, count, output);
+			}
+			else if (!zero1 && (f0 < T(0)) != (f1 < T(0))) {
+				intern::writeRoot(intern::refineRoot(co, dco, 3, bounds[i - 1], bounds[i]), &previous, count, output);
+			}
+			f0 = f1;
+			zero0 = zero1;
+		}
+		if (zero0) {
+			intern::writeRoot(bounds[numBounds - 1], &previous, count, output);
+		}
+		return count;
 	}
-	*/
-	
 };
\ No newline at end of file
@@ -0,0 +1,1026 @@
+#pragma once
+#include <cinttypes>
+#include <cstddef>
+#include <cassert>
+#include <string>
+#include <string_view>
+#include <algorithm>
+#include <array>
+#include <type_traits>
+#include "simd.hpp"
+
+/*
+	Small, fast pseudo random number generators. None of these are suitable for cryptography.
+
+	Every engine satisfies the standard UniformRandomBitGenerator requirements, so they can be used with the <random> distributions.
+	Each engine also provides a fill function for generating large amounts of numbers at once.
+*/
+
+namespace ez::prng {
+	constexpr std::uint8_t rotl8(std::uint8_t value, int shift) noexcept {
+		shift &= 7;
+		return std::uint8_t((value << shift) | (value >> ((8 - shift) & 7)));
+	}
+	constexpr std::uint8_t rotr8(std::uint8_t value, int shift) noexcept {
+		shift &= 7;
+		return std::uint8_t((value >> shift) | (value << ((8 - shift) & 7)));
+	}
+
+	constexpr std::uint16_t rotl16(std::uint16_t value, int shift) noexcept {
+		shift &= 15;
+		return std::uint16_t((value << shift) | (value >> ((16 - shift) & 15)));
+	}
+	constexpr std::uint16_t rotr16(std::uint16_t value, int shift) noexcept {
+		shift &= 15;
+		return std::uint16_t((value >> shift) | (value << ((16 - shift) & 15)));
+	}
+
+	constexpr std::uint32_t rotl32(std::uint32_t value, int shift) noexcept {
+		shift &= 31;
+		return (value << shift) | (value >> ((32 - shift) & 31));
+	}
+	constexpr std::uint32_t rotr32(std::uint32_t value, int shift) noexcept {
+		shift &= 31;
+		return (value >> shift) | (value << ((32 - shift) & 31));
+	}
+
+	constexpr std::uint64_t rotl64(std::uint64_t value, int shift) noexcept {
+		shift &= 63;
+		return (value << shift) | (value >> ((64 - shift) & 63));
+	}
+	constexpr std::uint64_t rotr64(std::uint64_t value, int shift) noexcept {
+		shift &= 63;
+		return (value >> shift) | (value << ((64 - shift) & 63));
+	}
+
+	// Dan Bernstein's string hash, hash * 33 + c. Works on any character type, each character is added as a whole.
+	template<typename Char>
+	constexpr std::uint32_t djb2_32(const Char* str, std::size_t length) noexcept {
+		std::uint32_t hash = 5381;
+		for (std::size_t i = 0; i < length; ++i) {
+			hash = hash * 33u + std::uint32_t(str[i]);
+		}
+		return hash;
+	}
+	template<typename Char, std::size_t N>
+	constexpr std::uint32_t djb2_32(const Char(&str)[N]) noexcept {
+		// Do not include the null terminator
+		return djb2_32(str, N - 1);
+	}
+	template<typename Char>
+	constexpr std::uint32_t djb2_32(std::basic_string_view<Char> str) noexcept {
+		return djb2_32(str.data(), str.size());
+	}
+	template<typename Char>
+	std::uint32_t djb2_32(const std::basic_string<Char>& str) noexcept {
+		return djb2_32(str.data(), str.size());
+	}
+
+	template<typename Char>
+	constexpr std::uint64_t djb2_64(const Char* str, std::size_t length) noexcept {
+		std::uint64_t hash = 5381;
+		for (std::size_t i = 0; i < length; ++i) {
+			hash = hash * 33u + std::uint64_t(str[i]);
+		}
+		return hash;
+	}
+	template<typename Char, std::size_t N>
+	constexpr std::uint64_t djb2_64(const Char(&str)[N]) noexcept {
+		// Do not include the null terminator
+		return djb2_64(str, N - 1);
+	}
+	template<typename Char>
+	constexpr std::uint64_t djb2_64(std::basic_string_view<Char> str) noexcept {
+		return djb2_64(str.data(), str.size());
+	}
+	template<typename Char>
+	std::uint64_t djb2_64(const std::basic_string<Char>& str) noexcept {
+		return djb2_64(str.data(), str.size());
+	}
+
+	namespace intern {
+		// Number of independent streams stepped together by the fill functions.
+		// This is fixed rather than taken from the native vector width, so the output is the same on every platform.
+		static constexpr std::size_t fillLanes = 8;
+
+		// Full 128 bit product of a and b, returns the upper half and stores the lower half in low
+		constexpr std::uint64_t mulHigh64(std::uint64_t a, std::uint64_t b, std::uint64_t& low) noexcept {
+#if defined(__SIZEOF_INT128__)
+			// __extension__ keeps -Wpedantic quiet about the non standard type
+			__extension__ typedef unsigned __int128 uint128;
+			uint128 product = uint128(a) * b;
+			low = std::uint64_t(product);
+			return std::uint64_t(product >> 64);
+#else
+			std::uint64_t aLo = a & 0xFFFFFFFFu, aHi = a >> 32;
+			std::uint64_t bLo = b & 0xFFFFFFFFu, bHi = b >> 32;
+			std::uint64_t ll = aLo * bLo, lh = aLo * bHi, hl = aHi * bLo, hh = aHi * bHi;
+			std::uint64_t mid = (ll >> 32) + (lh & 0xFFFFFFFFu) + (hl & 0xFFFFFFFFu);
+			low = (mid << 32) | (ll & 0xFFFFFFFFu);
+			return hh + (lh >> 32) + (hl >> 32) + (mid >> 32);
+#endif
+		}
+
+		// Coefficients of the affine map x -> mult * x + inc applied delta times, in O(log delta) steps.
+		struct LcgStep {
+			std::uint64_t mult, inc;
+		};
+		constexpr LcgStep lcgPower(std::uint64_t mult, std::uint64_t inc, std::uint64_t delta) noexcept {
+			std::uint64_t accMult = 1, accInc = 0;
+			while (delta > 0) {
+				if (delta & 1) {
+					accMult *= mult;
+					accInc = accInc * mult + inc;
+				}
+				inc = (mult + 1) * inc;
+				mult *= mult;
+				delta >>= 1;
+			}
+			return LcgStep{ accMult, accInc };
+		}
+
+		// Polynomial over GF(2) with degree up to Bits, one bit per coefficient starting from x^0.
+		// The xorshift family of engines are linear over GF(2), so jumping ahead n steps is the same as
+		// evaluating x^n modulo the characteristic polynomial of the engine, at the engine's transition matrix.
+		template<std::size_t Bits>
+		struct Gf2Poly {
+			static constexpr std::size_t words = Bits / 64 + 1;
+			std::uint64_t bits[words];
+
+			constexpr bool test(std::size_t i) const noexcept {
+				return (bits[i / 64] >> (i % 64)) & 1u;
+			}
+			constexpr void flip(std::size_t i) noexcept {
+				bits[i / 64] ^= std::uint64_t(1) << (i % 64);
+			}
+		};
+
+		// a * b mod m, where a and b have degree below Bits and m has degree exactly Bits
+		template<std::size_t Bits>
+		constexpr Gf2Poly<Bits> mulMod(const Gf2Poly<Bits>& a, const Gf2Poly<Bits>& b, const Gf2Poly<Bits>& m) noexcept {
+			constexpr std::size_t W = Gf2Poly<Bits>::words;
+			Gf2Poly<Bits> result{};
+			for (std::size_t i = Bits; i-- > 0;) {
+				// result *= x
+				for (std::size_t w = W; w-- > 1;) {
+					result.bits[w] = (result.bits[w] << 1) | (result.bits[w - 1] >> 63);
+				}
+				result.bits[0] <<= 1;
+
+				std::uint64_t reduce = result.test(Bits) ? ~std::uint64_t(0) : 0;
+				std::uint64_t add = a.test(i) ? ~std::uint64_t(0) : 0;
+				for (std::size_t w = 0; w < W; ++w) {
+					result.bits[w] ^= (m.bits[w] & reduce) ^ (b.bits[w] & add);
+				}
+			}
+			return result;
+		}
+
+		template<std::size_t Bits>
+		constexpr Gf2Poly<Bits> powMod(Gf2Poly<Bits> base, std::uint64_t exponent, const Gf2Poly<Bits>& m) noexcept {
+			Gf2Poly<Bits> result{};
+			result.flip(0);
+			while (exponent > 0) {
+				if (exponent & 1) {
+					result = mulMod(result, base, m);
+				}
+				base = mulMod(base, base, m);
+				exponent >>= 1;
+			}
+			return result;
+		}
+
+		// Characteristic polynomial of a linear engine, found with Berlekamp-Massey on the lowest bit of its state.
+		// The engines here have primitive characteristic polynomials, so the minimal polynomial of any bit is the full one.
+		template<std::size_t Bits, typename Engine>
+		constexpr Gf2Poly<Bits> characteristic(Engine engine) noexcept {
+			constexpr std::size_t N = Bits * 2;
+			std::uint8_t seq[N]{};
+			for (std::size_t i = 0; i < N; ++i) {
+				engine.advance();
+				seq[i] = std::uint8_t(engine.state[0] & 1u);
+			}
+
+			std::uint8_t conn[N + 1]{}, prev[N + 1]{}, temp[N + 1]{};
+			conn[0] = prev[0] = 1;
+			std::size_t length = 0, shift = 1;
+			for (std::size_t i = 0; i < N; ++i) {
+				std::uint8_t d = seq[i];
+				for (std::size_t j = 1; j <= length; ++j) {
+					d ^= conn[j] & seq[i - j];
+				}
+
+				if (d == 0) {
+					++shift;
+				}
+				else if (2 * length <= i) {
+					std::copy(conn, conn + N + 1, temp);
+					for (std::size_t j = 0; j + shift <= N; ++j) {
+						conn[j + shift] ^= prev[j];
+					}
+					length = i + 1 - length;
+					std::copy(temp, temp + N + 1, prev);
+					shift = 1;
+				}
+				else {
+					for (std::size_t j = 0; j + shift <= N; ++j) {
+						conn[j + shift] ^= prev[j];
+					}
+					++shift;
+				}
+			}
+
+			// The characteristic polynomial is the reciprocal of the connection polynomial
+			Gf2Poly<Bits> result{};
+			for (std::size_t j = 0; j <= length && j <= Bits; ++j) {
+				if (conn[j]) {
+					result.flip(Bits - j);
+				}
+			}
+			return result;
+		}
+
+		// The polynomials needed to jump a linear engine with Bits bits of state.
+		template<std::size_t Bits>
+		struct JumpTable {
+			Gf2Poly<Bits> charpoly;
+			// x^(2^jumpLog2) and x^(2^longJumpLog2) mod charpoly
+			Gf2Poly<Bits> jump, longJump;
+		};
+
+		template<std::size_t Bits, typename Engine>
+		constexpr JumpTable<Bits> makeJumpTable(int jumpLog2, int longJumpLog2) noexcept {
+			JumpTable<Bits> table{};
+			table.charpoly = characteristic<Bits>(Engine{});
+
+			Gf2Poly<Bits> power{};
+			power.flip(1);
+			for (int i = 0; i < longJumpLog2; ++i) {
+				power = mulMod(power, power, table.charpoly);
+				if (i + 1 == jumpLog2) {
+					table.jump = power;
+				}
+			}
+			table.longJump = power;
+			return table;
+		}
+
+		// Replaces the state with poly(M) * state, where M is the transition matrix of the engine.
+		template<std::size_t Bits, typename Engine>
+		constexpr void applyJump(Engine& engine, const Gf2Poly<Bits>& poly) noexcept {
+			constexpr std::size_t W = sizeof(engine.state) / sizeof(engine.state[0]);
+			std::remove_reference_t<decltype(engine.state[0])> acc[W]{};
+
+			for (std::size_t i = 0; i < Bits; ++i) {
+				if (poly.test(i)) {
+					for (std::size_t w = 0; w < W; ++w) {
+						acc[w] ^= engine.state[w];
+					}
+				}
+				engine.advance();
+			}
+			for (std::size_t w = 0; w < W; ++w) {
+				engine.state[w] = acc[w];
+			}
+		}
+
+		// Advances a linear engine n steps, in O(log n) polynomial multiplications.
+		template<std::size_t Bits, typename Engine>
+		constexpr void discardLinear(Engine& engine, const JumpTable<Bits>& table, std::uint64_t n) noexcept {
+			if (n < Bits) {
+				for (; n > 0; --n) {
+					engine.advance();
+				}
+				return;
+			}
+
+			Gf2Poly<Bits> x{};
+			x.flip(1);
+			applyJump(engine, powMod(x, n, table.charpoly));
+		}
+
+		template<std::size_t Bits, typename Engine>
+		constexpr void jumpLinear(Engine& engine, const JumpTable<Bits>& table, std::uint64_t times) noexcept {
+			applyJump(engine, times == 1 ? table.jump : powMod(table.jump, times, table.charpoly));
+		}
+	};
+
+	// Sebastiano Vigna's SplitMix64. Mostly useful for seeding the other engines.
+	struct SplitMix64 {
+		using result_type = std::uint64_t;
+		static constexpr std::uint64_t gamma = 0x9E3779B97F4A7C15ull;
+
+		static constexpr result_type min() noexcept {
+			return 0;
+		}
+		static constexpr result_type max() noexcept {
+			return ~result_type(0);
+		}
+
+		constexpr SplitMix64() noexcept
+			: SplitMix64(0)
+		{}
+		constexpr explicit SplitMix64(std::uint64_t seed) noexcept
+			: state(seed)
+		{}
+
+		static constexpr std::uint64_t mix(std::uint64_t z) noexcept {
+			z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+			z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+			return z ^ (z >> 31);
+		}
+
+		constexpr std::uint64_t advance() noexcept {
+			state += gamma;
+			return mix(state);
+		}
+		constexpr result_type operator()() noexcept {
+			return advance();
+		}
+
+		// Same output as calling advance count times. Every output only depends on its position, so the loop vectorizes directly.
+		void fill(std::uint64_t* out, std::size_t count) noexcept {
+			const std::uint64_t base = state;
+
+			EZ_MATH_VECTORIZE
+			for (std::size_t i = 0; i < count; ++i) {
+				out[i] = mix(base + std::uint64_t(i + 1) * gamma);
+			}
+			state = base + std::uint64_t(count) * gamma;
+		}
+
+		// Equivalent to calling advance n times.
+		constexpr void discard(std::uint64_t n) noexcept {
+			state += n * gamma;
+		}
+		// Equivalent to 2^32 calls to advance, times the given count. The period is 2^64, so times has to be below 2^32.
+		constexpr void jump(std::uint64_t times = 1) noexcept {
+			assert(times < (std::uint64_t(1) << 32));
+			discard(times << 32);
+		}
+		// Equivalent to 2^48 calls to advance.
+		constexpr void longJump() noexcept {
+			discard(std::uint64_t(1) << 48);
+		}
+
+		constexpr bool operator==(const SplitMix64& other) const noexcept {
+			return state == other.state;
+		}
+		constexpr bool operator!=(const SplitMix64& other) const noexcept {
+			return state != other.state;
+		}
+
+		std::uint64_t state;
+	};
+
+	// George Marsaglia's 32 bit xorshift128
+	struct XorShift128 {
+		using result_type = std::uint32_t;
+
+		static constexpr result_type min() noexcept {
+			return 0;
+		}
+		static constexpr result_type max() noexcept {
+			return ~result_type(0);
+		}
+
+		constexpr XorShift128() noexcept
+			: XorShift128(123456789u, 362436069u, 521288629u, 88675123u)
+		{}
+		// The state must not be all zeros
+		constexpr XorShift128(std::uint32_t x, std::uint32_t y, std::uint32_t z, std::uint32_t w) noexcept
+			: state{ x, y, z, w }
+		{
+			if ((x | y | z | w) == 0) {
+				state[3] = 88675123u;
+			}
+		}
+
+		constexpr std::uint32_t advance() noexcept {
+			std::uint32_t t = state[0] ^ (state[0] << 11);
+			state[0] = state[1];
+			state[1] = state[2];
+			state[2] = state[3];
+			state[3] = state[3] ^ (state[3] >> 19) ^ t ^ (t >> 8);
+			return state[3];
+		}
+		constexpr result_type operator()() noexcept {
+			return advance();
+		}
+
+		// Same output as calling advance count times. Each step depends on the previous one, so this does not vectorize.
+		void fill(std::uint32_t* out, std::size_t count) noexcept {
+			for (std::size_t i = 0; i < count; ++i) {
+				out[i] = advance();
+			}
+		}
+
+		// Equivalent to calling advance n times.
+		void discard(std::uint64_t n) noexcept {
+			intern::discardLinear(*this, jumpTable(), n);
+		}
+		// Equivalent to 2^64 calls to advance, times the given count.
+		void jump(std::uint64_t times = 1) noexcept {
+			intern::jumpLinear(*this, jumpTable(), times);
+		}
+		// Equivalent to 2^96 calls to advance.
+		void longJump() noexcept {
+			intern::applyJump(*this, jumpTable().longJump);
+		}
+
+		static const intern::JumpTable<128>& jumpTable() noexcept {
+			static const intern::JumpTable<128> table = intern::makeJumpTable<128, XorShift128>(64, 96);
+			return table;
+		}
+
+		constexpr bool operator==(const XorShift128& other) const noexcept {
+			return state[0] == other.state[0] && state[1] == other.state[1] && state[2] == other.state[2] && state[3] == other.state[3];
+		}
+		constexpr bool operator!=(const XorShift128& other) const noexcept {
+			return !(*this == other);
+		}
+
+		std::uint32_t state[4];
+	};
+
+	// xoshiro256** by David Blackman and Sebastiano Vigna. A good default for 64 bit output.
+	struct Xoshiro256ss {
+		using result_type = std::uint64_t;
+
+		static constexpr result_type min() noexcept {
+			return 0;
+		}
+		static constexpr result_type max() noexcept {
+			return ~result_type(0);
+		}
+
+		constexpr Xoshiro256ss() noexcept
+			: Xoshiro256ss(0)
+		{}
+		// Expands the seed into the full state with SplitMix64
+		constexpr explicit Xoshiro256ss(std::uint64_t seed) noexcept
+			: state{}
+		{
+			SplitMix64 gen{ seed };
+			for (std::uint64_t& s : state) {
+				s = gen.advance();
+			}
+		}
+		// The state must not be all zeros
+		constexpr Xoshiro256ss(std::uint64_t s0, std::uint64_t s1, std::uint64_t s2, std::uint64_t s3) noexcept
+			: state{ s0, s1, s2, s3 }
+		{}
+
+		constexpr std::uint64_t advance() noexcept {
+			std::uint64_t result = rotl64(state[1] * 5, 7) * 9;
+			std::uint64_t t = state[1] << 17;
+
+			state[2] ^= state[0];
+			state[3] ^= state[1];
+			state[1] ^= state[2];
+			state[0] ^= state[3];
+			state[2] ^= t;
+			state[3] = rotl64(state[3], 45);
+
+			return result;
+		}
+		constexpr result_type operator()() noexcept {
+			return advance();
+		}
+
+		// Runs several independent streams side by side, one per vector lane, and interleaves their output.
+		// The first stream continues this engine, the others are seeded from it.
+		void fill(std::uint64_t* out, std::size_t count) noexcept {
+			constexpr std::size_t N = intern::fillLanes;
+			std::uint64_t s0[N], s1[N], s2[N], s3[N];
+
+			for (std::size_t k = 1; k < N; ++k) {
+				Xoshiro256ss lane{ advance() };
+				s0[k] = lane.state[0];
+				s1[k] = lane.state[1];
+				s2[k] = lane.state[2];
+				s3[k] = lane.state[3];
+			}
+			s0[0] = state[0];
+			s1[0] = state[1];
+			s2[0] = state[2];
+			s3[0] = state[3];
+
+			auto step = [&](std::uint64_t* block) {
+				EZ_MATH_VECTORIZE
+				for (std::size_t k = 0; k < N; ++k) {
+					block[k] = rotl64(s1[k] * 5, 7) * 9;
+					std::uint64_t t = s1[k] << 17;
+
+					s2[k] ^= s0[k];
+					s3[k] ^= s1[k];
+					s1[k] ^= s2[k];
+					s0[k] ^= s3[k];
+					s2[k] ^= t;
+					s3[k] = rotl64(s3[k], 45);
+				}
+			};
+
+			std::size_t i = 0;
+			for (; i + N <= count; i += N) {
+				step(out + i);
+			}
+			if (i < count) {
+				std::uint64_t block[N];
+				step(block);
+				std::copy(block, block + (count - i), out + i);
+			}
+
+			state[0] = s0[0];
+			state[1] = s1[0];
+			state[2] = s2[0];
+			state[3] = s3[0];
+		}
+
+		// Equivalent to calling advance n times.
+		void discard(std::uint64_t n) noexcept {
+			intern::discardLinear(*this, jumpTable(), n);
+		}
+		// Equivalent to 2^128 calls to advance, times the given count.
+		void jump(std::uint64_t times = 1) noexcept {
+			intern::jumpLinear(*this, jumpTable(), times);
+		}
+		// Equivalent to 2^192 calls to advance.
+		void longJump() noexcept {
+			intern::applyJump(*this, jumpTable().longJump);
+		}
+
+		static const intern::JumpTable<256>& jumpTable() noexcept {
+			static const intern::JumpTable<256> table = intern::makeJumpTable<256, Xoshiro256ss>(128, 192);
+			return table;
+		}
+
+		constexpr bool operator==(const Xoshiro256ss& other) const noexcept {
+			return state[0] == other.state[0] && state[1] == other.state[1] && state[2] == other.state[2] && state[3] == other.state[3];
+		}
+		constexpr bool operator!=(const Xoshiro256ss& other) const noexcept {
+			return !(*this == other);
+		}
+
+		std::uint64_t state[4];
+	};
+
+	// xoroshiro128+ by David Blackman and Sebastiano Vigna. Very fast, but the lowest bits are weak, so prefer the upper bits.
+	struct Xoroshiro128p {
+		using result_type = std::uint64_t;
+
+		static constexpr result_type min() noexcept {
+			return 0;
+		}
+		static constexpr result_type max() noexcept {
+			return ~result_type(0);
+		}
+
+		constexpr Xoroshiro128p() noexcept
+			: Xoroshiro128p(0)
+		{}
+		// Expands the seed into the full state with SplitMix64
+		constexpr explicit Xoroshiro128p(std::uint64_t seed) noexcept
+			: state{}
+		{
+			SplitMix64 gen{ seed };
+			state[0] = gen.advance();
+			state[1] = gen.advance();
+		}
+		// The state must not be all zeros
+		constexpr Xoroshiro128p(std::uint64_t s0, std::uint64_t s1) noexcept
+			: state{ s0, s1 }
+		{}
+
+		constexpr std::uint64_t advance() noexcept {
+			std::uint64_t s0 = state[0];
+			std::uint64_t s1 = state[1];
+			std::uint64_t result = s0 + s1;
+
+			s1 ^= s0;
+			state[0] = rotl64(s0, 24) ^ s1 ^ (s1 << 16);
+			state[1] = rotl64(s1, 37);
+
+			return result;
+		}
+		constexpr result_type operator()() noexcept {
+			return advance();
+		}
+
+		// Runs several independent streams side by side, one per vector lane, and interleaves their output.
+		// The first stream continues this engine, the others are seeded from it.
+		void fill(std::uint64_t* out, std::size_t count) noexcept {
+			constexpr std::size_t N = intern::fillLanes;
+			std::uint64_t s0[N], s1[N];
+
+			for (std::size_t k = 1; k < N; ++k) {
+				Xoroshiro128p lane{ advance() };
+				s0[k] = lane.state[0];
+				s1[k] = lane.state[1];
+			}
+			s0[0] = state[0];
+			s1[0] = state[1];
+
+			auto step = [&](std::uint64_t* block) {
+				EZ_MATH_VECTORIZE
+				for (std::size_t k = 0; k < N; ++k) {
+					std::uint64_t a = s0[k];
+					std::uint64_t b = s1[k];
+					block[k] = a + b;
+
+					b ^= a;
+					s0[k] = rotl64(a, 24) ^ b ^ (b << 16);
+					s1[k] = rotl64(b, 37);
+				}
+			};
+
+			std::size_t i = 0;
+			for (; i + N <= count; i += N) {
+				step(out + i);
+			}
+			if (i < count) {
+				std::uint64_t block[N];
+				step(block);
+				std::copy(block, block + (count - i), out + i);
+			}
+
+			state[0] = s0[0];
+			state[1] = s1[0];
+		}
+
+		// Equivalent to calling advance n times.
+		void discard(std::uint64_t n) noexcept {
+			intern::discardLinear(*this, jumpTable(), n);
+		}
+		// Equivalent to 2^64 calls to advance, times the given count.
+		void jump(std::uint64_t times = 1) noexcept {
+			intern::jumpLinear(*this, jumpTable(), times);
+		}
+		// Equivalent to 2^96 calls to advance.
+		void longJump() noexcept {
+			intern::applyJump(*this, jumpTable().longJump);
+		}
+
+		static const intern::JumpTable<128>& jumpTable() noexcept {
+			static const intern::JumpTable<128> table = intern::makeJumpTable<128, Xoroshiro128p>(64, 96);
+			return table;
+		}
+
+		constexpr bool operator==(const Xoroshiro128p& other) const noexcept {
+			return state[0] == other.state[0] && state[1] == other.state[1];
+		}
+		constexpr bool operator!=(const Xoroshiro128p& other) const noexcept {
+			return !(*this == other);
+		}
+
+		std::uint64_t state[2];
+	};
+
+	namespace intern {
+		// Shared state handling for the PCG engines, which are a 64 bit LCG followed by an output permutation.
+		template<typename Derived, typename Result>
+		struct PcgBase {
+			using result_type = Result;
+			static constexpr std::uint64_t multiplier = 6364136223846793005ull;
+
+			static constexpr result_type min() noexcept {
+				return 0;
+			}
+			static constexpr result_type max() noexcept {
+				return ~result_type(0);
+			}
+
+			// Seeding as in the reference implementation, any stream number selects a distinct sequence.
+			constexpr PcgBase(std::uint64_t seed, std::uint64_t stream) noexcept
+				: state(0)
+				, increment((stream << 1) | 1u)
+			{
+				state = state * multiplier + increment;
+				state += seed;
+				state = state * multiplier + increment;
+			}
+
+			constexpr result_type advance() noexcept {
+				std::uint64_t old = state;
+				state = old * multiplier + increment;
+				return Derived::output(old);
+			}
+			constexpr result_type operator()() noexcept {
+				return advance();
+			}
+
+			// Same output as calling advance count times. Each lane starts a step further along the sequence,
+			// and all of them jump ahead by the number of lanes each iteration.
+			void fill(result_type* out, std::size_t count) noexcept {
+				constexpr std::size_t N = fillLanes;
+				constexpr LcgStep jump = lcgPower(multiplier, 1, N);
+
+				const std::uint64_t jumpInc = jump.inc * increment;
+				std::uint64_t lanes[N];
+				lanes[0] = state;
+				for (std::size_t k = 1; k < N; ++k) {
+					lanes[k] = lanes[k - 1] * multiplier + increment;
+				}
+
+				std::size_t i = 0;
+				for (; i + N <= count; i += N) {
+					EZ_MATH_VECTORIZE
+					for (std::size_t k = 0; k < N; ++k) {
+						out[i + k] = Derived::output(lanes[k]);
+						lanes[k] = lanes[k] * jump.mult + jumpInc;
+					}
+				}
+
+				state = lanes[0];
+				for (; i < count; ++i) {
+					out[i] = advance();
+				}
+			}
+
+			// Equivalent to calling advance n times.
+			constexpr void discard(std::uint64_t n) noexcept {
+				LcgStep step = lcgPower(multiplier, increment, n);
+				state = state * step.mult + step.inc;
+			}
+			// Equivalent to 2^32 calls to advance, times the given count. The period is 2^64, so times has to be below 2^32.
+			constexpr void jump(std::uint64_t times = 1) noexcept {
+				assert(times < (std::uint64_t(1) << 32));
+				discard(times << 32);
+			}
+			// Equivalent to 2^48 calls to advance.
+			constexpr void longJump() noexcept {
+				discard(std::uint64_t(1) << 48);
+			}
+
+			// Moves to the count-th stream after this one, a different increment and so an entirely different sequence.
+			// The increment steps by an odd multiple of the golden ratio, so the first 2^63 streams are all distinct,
+			// and neighbouring streams do not differ in just a few low bits. The state is offset as well,
+			// otherwise every stream would start with the same output.
+			constexpr void skipStreams(std::uint64_t count) noexcept {
+				increment += count * (0x9E3779B97F4A7C15ull << 1);
+				state += count * 0xDA942042E4DD58B5ull;
+			}
+
+			constexpr bool operator==(const PcgBase& other) const noexcept {
+				return state == other.state && increment == other.increment;
+			}
+			constexpr bool operator!=(const PcgBase& other) const noexcept {
+				return !(*this == other);
+			}
+
+			std::uint64_t state;
+			std::uint64_t increment;
+		};
+	};
+
+	// Melissa O'Neill's PCG32, the XSH RR output function on 64 bits of state.
+	struct Pcg32: intern::PcgBase<Pcg32, std::uint32_t> {
+		constexpr Pcg32() noexcept
+			: Pcg32(0x853C49E6748FEA9Bull, 0xDA3E39CB94B95BDBull >> 1)
+		{}
+		constexpr explicit Pcg32(std::uint64_t seed, std::uint64_t stream = 0) noexcept
+			: PcgBase(seed, stream)
+		{}
+
+		static constexpr std::uint32_t output(std::uint64_t state) noexcept {
+			std::uint32_t xorshifted = std::uint32_t(((state >> 18) ^ state) >> 27);
+			return rotr32(xorshifted, int(state >> 59));
+		}
+	};
+
+	// PCG with 64 bits of state and the RXS M XS output function.
+	// Every 64 bit value appears exactly once per period, so prefer Pcg32 or xoshiro when that matters.
+	struct Pcg64: intern::PcgBase<Pcg64, std::uint64_t> {
+		constexpr Pcg64() noexcept
+			: Pcg64(0x853C49E6748FEA9Bull, 0xDA3E39CB94B95BDBull >> 1)
+		{}
+		constexpr explicit Pcg64(std::uint64_t seed, std::uint64_t stream = 0) noexcept
+			: PcgBase(seed, stream)
+		{}
+
+		static constexpr std::uint64_t output(std::uint64_t state) noexcept {
+			std::uint64_t word = ((state >> ((state >> 59) + 5)) ^ state) * 12605985483714917081ull;
+			return (word >> 43) ^ word;
+		}
+	};
+
+	// The index-th of a series of streams that start at engine, where stream 0 is engine itself.
+	// Any worker can create its own stream from a shared base engine, without stepping through the others.
+	// For the xorshift family each stream is one jump() long, 2^64 or more draws, and they never overlap as long as none of them is advanced further.
+	// PCG and SplitMix64 have other overloads below.
+	template<typename Engine>
+	Engine substream(Engine engine, std::uint64_t index) noexcept {
+		engine.jump(index);
+		return engine;
+	}
+
+	// SplitMix64 streams are one longJump() apart, so there are 2^16 of them with 2^48 draws each.
+	// A single jump() would only leave 2^32 draws before a stream runs into the next one.
+	inline SplitMix64 substream(SplitMix64 engine, std::uint64_t index) noexcept {
+		assert(index < (std::uint64_t(1) << 16));
+		engine.discard(index << 48);
+		return engine;
+	}
+
+	// PCG streams each get their own increment instead of a window of the same sequence, so every stream has the full 2^64 period.
+	inline Pcg32 substream(Pcg32 engine, std::uint64_t index) noexcept {
+		engine.skipStreams(index);
+		return engine;
+	}
+	inline Pcg64 substream(Pcg64 engine, std::uint64_t index) noexcept {
+		engine.skipStreams(index);
+		return engine;
+	}
+
+	// Splits off count consecutive streams as given by substream, leaving engine at the start of the next one.
+	template<typename Engine>
+	void split(Engine& engine, Engine* streams, std::size_t count) noexcept {
+		for (std::size_t i = 0; i < count; ++i) {
+			streams[i] = engine;
+			engine = substream(engine, 1);
+		}
+	}
+
+	namespace intern {
+		// One lane of Philox4x32-10, all the work happens on the counter in place
+		constexpr void philoxRounds(std::uint32_t& c0, std::uint32_t& c1, std::uint32_t& c2, std::uint32_t& c3, std::uint32_t k0, std::uint32_t k1) noexcept {
+			for (int round = 0; round < 10; ++round) {
+				std::uint64_t p0 = std::uint64_t(0xD2511F53u) * c0;
+				std::uint64_t p1 = std::uint64_t(0xCD9E8D57u) * c2;
+
+				std::uint32_t n0 = std::uint32_t(p1 >> 32) ^ c1 ^ k0;
+				std::uint32_t n2 = std::uint32_t(p0 >> 32) ^ c3 ^ k1;
+				c1 = std::uint32_t(p1);
+				c3 = std::uint32_t(p0);
+				c0 = n0;
+				c2 = n2;
+
+				k0 += 0x9E3779B9u;
+				k1 += 0xBB67AE85u;
+			}
+		}
+	};
+
+	/*
+		Counter based generators, which map a key and a counter to random bits without any state.
+		Any sample can be regenerated on demand from its index, so parallel work needs neither stored states nor stream splitting.
+		The fill functions evaluate a run of consecutive counters, several counters per vector.
+	*/
+
+	// Philox4x32-10 by Salmon et al., 128 random bits per counter.
+	struct Philox4x32 {
+		using Counter = std::array<std::uint32_t, 4>;
+
+		constexpr Philox4x32() noexcept
+			: Philox4x32(0)
+		{}
+		constexpr explicit Philox4x32(std::uint64_t seed) noexcept
+			: key{ std::uint32_t(seed), std::uint32_t(seed >> 32) }
+		{}
+		constexpr Philox4x32(std::uint32_t k0, std::uint32_t k1) noexcept
+			: key{ k0, k1 }
+		{}
+
+		// The four words for a full 128 bit counter
+		constexpr Counter operator()(Counter counter) const noexcept {
+			intern::philoxRounds(counter[0], counter[1], counter[2], counter[3], key[0], key[1]);
+			return counter;
+		}
+
+		// The four words for the counter { index, index >> 32, 0, 0 }
+		constexpr Counter operator()(std::uint64_t index) const noexcept {
+			return (*this)(Counter{ std::uint32_t(index), std::uint32_t(index >> 32), 0u, 0u });
+		}
+
+		// Writes count words, the output of the counters first, first + 1, and so on, four words each.
+		void fill(std::uint32_t* out, std::size_t count, std::uint64_t first = 0) const noexcept {
+			constexpr std::size_t N = simd::lanes<std::uint32_t>() < 8 ? 8 : simd::lanes<std::uint32_t>();
+			std::uint32_t c0[N], c1[N], c2[N], c3[N];
+
+			auto block = [&](std::uint64_t index) {
+				EZ_MATH_VECTORIZE
+				for (std::size_t k = 0; k < N; ++k) {
+					std::uint64_t counter = index + k;
+					c0[k] = std::uint32_t(counter);
+					c1[k] = std::uint32_t(counter >> 32);
+					c2[k] = 0;
+					c3[k] = 0;
+					intern::philoxRounds(c0[k], c1[k], c2[k], c3[k], key[0], key[1]);
+				}
+			};
+
+			std::size_t i = 0;
+			for (; i + N * 4 <= count; i += N * 4, first += N) {
+				block(first);
+				for (std::size_t k = 0; k < N; ++k) {
+					out[i + k * 4 + 0] = c0[k];
+					out[i + k * 4 + 1] = c1[k];
+					out[i + k * 4 + 2] = c2[k];
+					out[i + k * 4 + 3] = c3[k];
+				}
+			}
+			if (i < count) {
+				block(first);
+				for (std::size_t k = 0; i < count; ++k) {
+					const std::uint32_t words[4] = { c0[k], c1[k], c2[k], c3[k] };
+					for (int w = 0; w < 4 && i < count; ++w) {
+						out[i++] = words[w];
+					}
+				}
+			}
+		}
+
+		std::uint32_t key[2];
+	};
+
+	// Bernard Widynski's Squares, a counter based generator built from the middle square method.
+	// Four rounds give 32 bits per counter, five rounds give 64 bits.
+	struct Squares {
+		constexpr Squares() noexcept
+			: Squares(makeKey(0))
+		{}
+		// The key should come from makeKey, arbitrary keys can give poor output.
+		constexpr explicit Squares(std::uint64_t _key) noexcept
+			: key(_key)
+		{}
+
+		// A key in the form recommended by the author: the upper and lower eight hex digits are each distinct and nonzero, and the key is odd.
+		static constexpr std::uint64_t makeKey(std::uint64_t seed) noexcept {
+			SplitMix64 gen{ seed };
+			std::uint64_t result = 0;
+			for (int half = 0; half < 2; ++half) {
+				bool used[16] = {};
+				for (int digit = 0; digit < 8; ++digit) {
+					// Pick among the remaining nonzero digits, the lowest digit of the key must also be odd
+					bool odd = half == 1 && digit == 7;
+					int remaining = 0;
+					for (int value = 1; value < 16; ++value) {
+						remaining += !used[value] && (!odd || (value & 1)) ? 1 : 0;
+					}
+
+					int pick = int((gen.advance() >> 32) % std::uint64_t(remaining));
+					int value = 1;
+					for (;; ++value) {
+						if (!used[value] && (!odd || (value & 1)) && pick-- == 0) {
+							break;
+						}
+					}
+					used[value] = true;
+					result = (result << 4) | std::uint64_t(value);
+				}
+			}
+			return result;
+		}
+
+		static constexpr std::uint32_t generate32(std::uint64_t counter, std::uint64_t key) noexcept {
+			std::uint64_t x = counter * key;
+			std::uint64_t y = x;
+			std::uint64_t z = y + key;
+
+			x = rotr64(x * x + y, 32);
+			x = rotr64(x * x + z, 32);
+			x = rotr64(x * x + y, 32);
+			return std::uint32_t((x * x + z) >> 32);
+		}
+
+		static constexpr std::uint64_t generate64(std::uint64_t counter, std::uint64_t key) noexcept {
+			std::uint64_t x = counter * key;
+			std::uint64_t y = x;
+			std::uint64_t z = y + key;
+
+			x = rotr64(x * x + y, 32);
+			x = rotr64(x * x + z, 32);
+			x = rotr64(x * x + y, 32);
+			std::uint64_t t = x * x + z;
+			x = rotr64(t, 32);
+			return t ^ ((x * x + y) >> 32);
+		}
+
+		constexpr std::uint32_t operator()(std::uint64_t counter) const noexcept {
+			return generate32(counter, key);
+		}
+		constexpr std::uint64_t at64(std::uint64_t counter) const noexcept {
+			return generate64(counter, key);
+		}
+
+		// Writes the outputs of the counters first, first + 1, and so on.
+		void fill(std::uint32_t* out, std::size_t count, std::uint64_t first = 0) const noexcept {
+			const std::uint64_t k = key;
+
+			EZ_MATH_VECTORIZE
+			for (std::size_t i = 0; i < count; ++i) {
+				out[i] = generate32(first + i, k);
+			}
+		}
+		void fill(std::uint64_t* out, std::size_t count, std::uint64_t first = 0) const noexcept {
+			const std::uint64_t k = key;
+
+			EZ_MATH_VECTORIZE
+			for (std::size_t i = 0; i < count; ++i) {
+				out[i] = generate64(first + i, k);
+			}
+		}
+
+		std::uint64_t key;
+	};
+};
\ No newline at end of file
@@ -0,0 +1,314 @@
+#pragma once
+#include <cinttypes>
+#include <cstddef>
+#include <cmath>
+#include <vector>
+#include <atomic>
+#include <thread>
+#include <algorithm>
+#include <glm/vec2.hpp>
+#include <glm/vec4.hpp>
+#include "color.hpp"
+#include "simd.hpp"
+
+namespace ez {
+	struct RasterVertex {
+		// Position in pixels, the center of pixel (x, y) is at (x + 0.5, y + 0.5)
+		glm::vec2 position;
+		ColorF color;
+	};
+
+	/*
+		Tiled edge function rasterizer, drawing gouraud shaded triangles into a ColorU image.
+
+		Triangles are snapped to 1/16 of a pixel and tested at pixel centers with integer edge functions,
+		using the top-left fill rule, so triangles that share an edge never leave gaps or cover a pixel twice.
+		Both windings are drawn. Later triangles overwrite earlier ones, there is no blending or depth test.
+
+		The image is split into bins of binSize pixels. Each added triangle is appended to the bins its bounds touch,
+		and each bin is then drawn independently, 8x8 tiles at a time. Tiles entirely outside an edge are skipped,
+		and edges that cover the whole tile are not tested per pixel. Bins write disjoint pixels,
+		so renderBin can be called from several threads at once, as long as each bin is drawn by only one of them.
+
+		Vertices must lie within guardBand pixels of the origin, triangles that do not are skipped.
+	*/
+	class Rasterizer {
+	public:
+		static constexpr int tileSize = 8;
+		static constexpr int binSize = 64;
+		static constexpr int subpixelBits = 4;
+		static constexpr float guardBand = 16384.f;
+
+		// stride is the distance between rows in pixels, zero meaning the same as width
+		Rasterizer(ColorU* target, int width, int height, std::ptrdiff_t stride = 0)
+			: target_(target)
+			, width_(std::max(width, 0))
+			, height_(std::max(height, 0))
+			, stride_(stride == 0 ? std::ptrdiff_t(width) : stride)
+			, binsX_((width_ + binSize - 1) / binSize)
+			, binsY_((height_ + binSize - 1) / binSize)
+			, bins_(std::size_t(binsX_) * std::size_t(binsY_))
+		{}
+
+		int width() const noexcept {
+			return width_;
+		}
+		int height() const noexcept {
+			return height_;
+		}
+
+		// The number of triangles queued
+		std::size_t size() const noexcept {
+			return triangles_.size();
+		}
+
+		// Drop all queued triangles
+		void clear() noexcept {
+			triangles_.clear();
+			for (std::vector<std::uint32_t>& bin : bins_) {
+				bin.clear();
+			}
+		}
+
+		// Queue a triangle. Returns false if it was skipped, for having no area, not touching the image or being outside the guard band.
+		bool add(const RasterVertex& v0, const RasterVertex& v1, const RasterVertex& v2) {
+			const RasterVertex* verts[3] = { &v0, &v1, &v2 };
+			std::int64_t x[3], y[3];
+			for (int i = 0; i < 3; ++i) {
+				glm::vec2 p = verts[i]->position;
+				if (!(std::abs(p.x) <= guardBand && std::abs(p.y) <= guardBand)) {
+					return false;
+				}
+				x[i] = std::int64_t(std::lround(p.x * float(1 << subpixelBits)));
+				y[i] = std::int64_t(std::lround(p.y * float(1 << subpixelBits)));
+			}
+
+			std::int64_t area = (x[1] - x[0]) * (y[2] - y[0]) - (y[1] - y[0]) * (x[2] - x[0]);
+			if (area == 0) {
+				return false;
+			}
+			// Make the winding positive, so the inside is where every edge function is positive
+			if (area < 0) {
+				std::swap(x[1], x[2]);
+				std::swap(y[1], y[2]);
+				std::swap(verts[1], verts[2]);
+				area = -area;
+			}
+
+			// Pixels whose centers fall within the snapped bounds
+			constexpr std::int64_t one = 1 << subpixelBits;
+			constexpr std::int64_t half = one / 2;
+			std::int64_t minX = std::min({ x[0], x[1], x[2] }), maxX = std::max({ x[0], x[1], x[2] });
+			std::int64_t minY = std::min({ y[0], y[1], y[2] }), maxY = std::max({ y[0], y[1], y[2] });
+
+			Triangle tri;
+			tri.minX = int(std::max<std::int64_t>(floorDiv(minX - half + one - 1, one), 0));
+			tri.minY = int(std::max<std::int64_t>(floorDiv(minY - half + one - 1, one), 0));
+			tri.maxX = int(std::min<std::int64_t>(floorDiv(maxX - half, one), width_ - 1));
+			tri.maxY = int(std::min<std::int64_t>(floorDiv(maxY - half, one), height_ - 1));
+			if (tri.minX > tri.maxX || tri.minY > tri.maxY) {
+				return false;
+			}
+
+			// Edge k is opposite vertex k, so its function divided by the area is the barycentric weight of vertex k
+			for (int k = 0; k < 3; ++k) {
+				int i = (k + 1) % 3, j = (k + 2) % 3;
+				Edge& edge = tri.edges[k];
+				edge.x = x[i];
+				edge.y = y[i];
+				edge.a = y[i] - y[j];
+				edge.b = x[j] - x[i];
+				// Top-left rule, pixels exactly on an edge belong to the triangle only for top and left edges
+				edge.bias = (edge.a > 0 || (edge.a == 0 && edge.b > 0)) ? 0 : -1;
+			}
+
+			tri.invArea = 1.0 / double(area);
+			for (int k = 0; k < 3; ++k) {
+				const ColorF& c = verts[k]->color;
+				tri.colors[k] = glm::vec4(c.r, c.g, c.b, c.a);
+			}
+
+			std::uint32_t index = std::uint32_t(triangles_.size());
+			triangles_.push_back(tri);
+			for (int by = tri.minY / binSize; by <= tri.maxY / binSize; ++by) {
+				for (int bx = tri.minX / binSize; bx <= tri.maxX / binSize; ++bx) {
+					bins_[std::size_t(by) * binsX_ + bx].push_back(index);
+				}
+			}
+			return true;
+		}
+
+		// Queue a list of triangles, three vertices each
+		void add(const RasterVertex* vertices, std::size_t count) {
+			for (std::size_t i = 0; i + 2 < count; i += 3) {
+				add(vertices[i], vertices[i + 1], vertices[i + 2]);
+			}
+		}
+
+		std::size_t binCount() const noexcept {
+			return bins_.size();
+		}
+
+		// Draw the queued triangles that touch a single bin, in the order they were added
+		void renderBin(std::size_t index) const noexcept {
+			int binX0 = int(index % binsX_) * binSize;
+			int binY0 = int(index / binsX_) * binSize;
+			int binX1 = std::min(binX0 + binSize, width_) - 1;
+			int binY1 = std::min(binY0 + binSize, height_) - 1;
+
+			for (std::uint32_t triIndex : bins_[index]) {
+				const Triangle& tri = triangles_[triIndex];
+				int x0 = std::max(tri.minX, binX0), x1 = std::min(tri.maxX, binX1);
+				int y0 = std::max(tri.minY, binY0), y1 = std::min(tri.maxY, binY1);
+
+				// Tiles are aligned to the image, so neighbouring bins never share one
+				for (int ty = y0 & ~(tileSize - 1); ty <= y1; ty += tileSize) {
+					for (int tx = x0 & ~(tileSize - 1); tx <= x1; tx += tileSize) {
+						renderTile(tri, tx, ty, std::min(tileSize, width_ - tx), std::min(tileSize, height_ - ty));
+					}
+				}
+			}
+		}
+
+		// Draw every bin on the calling thread
+		void render() const noexcept {
+			for (std::size_t i = 0; i < bins_.size(); ++i) {
+				renderBin(i);
+			}
+		}
+
+		// Draw the bins using up to threads threads, including the calling one
+		void render(unsigned threads) const {
+			threads = std::min<unsigned>(threads, unsigned(bins_.size()));
+			if (threads <= 1) {
+				render();
+				return;
+			}
+
+			std::atomic<std::size_t> next{ 0 };
+			auto work = [this, &next]() {
+				for (std::size_t i = next++; i < bins_.size(); i = next++) {
+					renderBin(i);
+				}
+			};
+
+			std::vector<std::thread> workers;
+			workers.reserve(threads - 1);
+			for (unsigned i = 1; i < threads; ++i) {
+				workers.emplace_back(work);
+			}
+			work();
+			for (std::thread& worker : workers) {
+				worker.join();
+			}
+		}
+	private:
+		struct Edge {
+			// A point on the edge, and the steps of the edge function per subpixel in x and y
+			std::int64_t x, y, a, b;
+			std::int32_t bias;
+
+			std::int64_t at(std::int64_t px, std::int64_t py) const noexcept {
+				return a * (px - x) + b * (py - y);
+			}
+		};
+		struct Triangle {
+			Edge edges[3];
+			double invArea;
+			glm::vec4 colors[3];
+			int minX, minY, maxX, maxY;
+		};
+
+		static std::int64_t floorDiv(std::int64_t a, std::int64_t b) noexcept {
+			std::int64_t q = a / b;
+			return q - ((a % b != 0) && ((a < 0) != (b < 0)));
+		}
+
+		void renderTile(const Triangle& tri, int tx, int ty, int tileWidth, int tileHeight) const noexcept {
+			constexpr std::int64_t one = 1 << subpixelBits;
+			constexpr int last = tileSize - 1;
+			std::int64_t px = std::int64_t(tx) * one + one / 2;
+			std::int64_t py = std::int64_t(ty) * one + one / 2;
+
+			// Per edge value at the first pixel center of the tile, biased for the fill rule, and steps per pixel.
+			// Edges that cover the whole tile are replaced by a constant, so the lane loop is the same for every tile.
+			std::int32_t start[3], stepX[3], stepY[3];
+			float weight[3], weightX[3], weightY[3];
+			for (int k = 0; k < 3; ++k) {
+				const Edge& edge = tri.edges[k];
+				std::int64_t e = edge.at(px, py);
+				std::int64_t dx = edge.a * one, dy = edge.b * one;
+
+				std::int64_t low = e + edge.bias + std::min<std::int64_t>(dx * last, 0) + std::min<std::int64_t>(dy * last, 0);
+				std::int64_t high = e + edge.bias + std::max<std::int64_t>(dx * last, 0) + std::max<std::int64_t>(dy * last, 0);
+				if (high < 0) {
+					return;
+				}
+				if (low >= 0) {
+					start[k] = 0;
+					stepX[k] = 0;
+					stepY[k] = 0;
+				}
+				else {
+					// The edge crosses the tile, so its values here are small enough for 32 bits
+					start[k] = std::int32_t(e + edge.bias);
+					stepX[k] = std::int32_t(dx);
+					stepY[k] = std::int32_t(dy);
+				}
+
+				weight[k] = float(double(e) * tri.invArea);
+				weightX[k] = float(double(dx) * tri.invArea);
+				weightY[k] = float(double(dy) * tri.invArea);
+			}
+
+			float colors[4][3];
+			for (int c = 0; c < 4; ++c) {
+				for (int k = 0; k < 3; ++k) {
+					colors[c][k] = tri.colors[k][c];
+				}
+			}
+
+			// The whole tile as a single lane loop, row by row
+			constexpr int pixels = tileSize * tileSize;
+			std::uint8_t covered[pixels];
+			std::uint8_t channels[4][pixels];
+
+			EZ_MATH_VECTORIZE
+			for (int p = 0; p < pixels; ++p) {
+				int i = p % tileSize, j = p / tileSize;
+				std::int32_t e0 = start[0] + stepX[0] * i + stepY[0] * j;
+				std::int32_t e1 = start[1] + stepX[1] * i + stepY[1] * j;
+				std::int32_t e2 = start[2] + stepX[2] * i + stepY[2] * j;
+				covered[p] = std::uint8_t((e0 | e1 | e2) >= 0);
+
+				float fi = float(i), fj = float(j);
+				float w0 = weight[0] + weightX[0] * fi + weightY[0] * fj;
+				float w1 = weight[1] + weightX[1] * fi + weightY[1] * fj;
+				float w2 = weight[2] + weightX[2] * fi + weightY[2] * fj;
+				for (int c = 0; c < 4; ++c) {
+					float value = colors[c][0] * w0 + colors[c][1] * w1 + colors[c][2] * w2;
+					// Clamped as an integer, float min and max would keep the loop from vectorizing
+					std::int32_t quantized = std::int32_t(value * 255.f + 0.5f);
+					channels[c][p] = std::uint8_t(std::min(std::max(quantized, 0), 255));
+				}
+			}
+
+			for (int j = 0; j < tileHeight; ++j) {
+				ColorU* row = target_ + (std::ptrdiff_t(ty) + j) * stride_ + tx;
+				for (int i = 0; i < tileWidth; ++i) {
+					int p = j * tileSize + i;
+					if (covered[p]) {
+						row[i] = ColorU{ channels[0][p], channels[1][p], channels[2][p], channels[3][p] };
+					}
+				}
+			}
+		}
+
+		ColorU* target_;
+		int width_, height_;
+		std::ptrdiff_t stride_;
+		int binsX_, binsY_;
+		std::vector<Triangle> triangles_;
+		std::vector<std::vector<std::uint32_t>> bins_;
+	};
+};
\ No newline at end of file
@@ -0,0 +1,148 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <cmath>
+#include <type_traits>
+
+/*
+	Compile time selection of the native vector width.
+	The batch kernels in this library are written as fixed width lane loops over plain arrays,
+	sized from EZ_MATH_SIMD_BYTES, so that the compiler can map them directly onto the widest
+	instruction set enabled for the translation unit (SSE, AVX2, AVX-512, NEON).
+
+	Define EZ_MATH_SIMD_BYTES before including any ez-math header to override the detected width.
+*/
+
+#ifndef EZ_MATH_SIMD_BYTES
+	#if defined(__AVX512F__)
+		#define EZ_MATH_SIMD_BYTES 64
+	#elif defined(__AVX__)
+		#define EZ_MATH_SIMD_BYTES 32
+	#else
+		// SSE2, NEON, or no vector unit at all. 16 bytes is still a reasonable unroll factor for scalar code.
+		#define EZ_MATH_SIMD_BYTES 16
+	#endif
+#endif
+
+// Instruction sets used by the kernels that need explicit intrinsics, such as byte shuffles.
+// Every kernel has a portable fallback, so none of these are required.
+#if defined(__AVX512BW__)
+	#define EZ_MATH_AVX512BW 1
+#endif
+#if defined(__AVX2__)
+	#define EZ_MATH_AVX2 1
+#endif
+#if defined(__SSSE3__) || defined(__AVX__)
+	#define EZ_MATH_SSSE3 1
+#endif
+#if defined(EZ_MATH_AVX512BW) || defined(EZ_MATH_AVX2) || defined(EZ_MATH_SSSE3)
+	#include <immintrin.h>
+#endif
+
+// Hint to the compiler that the following loop has no loop carried dependencies, and should be vectorized.
+#if defined(__clang__)
+	#define EZ_MATH_VECTORIZE _Pragma("clang loop vectorize(enable) interleave(enable)")
+#elif defined(__GNUC__)
+	#define EZ_MATH_VECTORIZE _Pragma("GCC ivdep")
+#elif defined(_MSC_VER)
+	#define EZ_MATH_VECTORIZE __pragma(loop(ivdep))
+#else
+	#define EZ_MATH_VECTORIZE
+#endif
+
+// Forces inlining of the scalar kernels that lane loops are built from. Without it compilers
+// sometimes keep a larger kernel out of line, and the loop calling it cannot be vectorized.
+#if defined(__GNUC__) || defined(__clang__)
+	#define EZ_MATH_INLINE inline __attribute__((always_inline))
+#elif defined(_MSC_VER)
+	#define EZ_MATH_INLINE __forceinline
+#else
+	#define EZ_MATH_INLINE inline
+#endif
+
+namespace ez::simd {
+	// The number of bytes in the native vector register.
+	static constexpr std::size_t width = EZ_MATH_SIMD_BYTES;
+
+	// The number of elements of type T that fit into a single native vector register.
+	template<typename T>
+	constexpr std::size_t lanes() noexcept {
+		return width / sizeof(T) > 0 ? width / sizeof(T) : 1;
+	}
+
+	// Unsigned integer the same size as T, lane masks of this type vectorize alongside T
+	template<typename T>
+	using Mask = std::conditional_t<sizeof(T) == 8, std::uint64_t, std::uint32_t>;
+
+	// Bitwise select, for values that the compiler would otherwise only compute inside a branch
+	template<typename T>
+	EZ_MATH_INLINE T select(bool condition, T a, T b) noexcept {
+		using Uint = Mask<T>;
+		Uint mask = Uint(0) - Uint(condition);
+		Uint ua, ub;
+		std::memcpy(&ua, &a, sizeof(T));
+		std::memcpy(&ub, &b, sizeof(T));
+		Uint bits = (ua & mask) | (ub & ~mask);
+		T result;
+		std::memcpy(&result, &bits, sizeof(T));
+		return result;
+	}
+
+	// Rounds to the nearest integer for |x| below 2^22 for float, and 2^51 for double.
+	// Only uses adds, so it vectorizes without the SSE4.1 round instructions.
+	template<typename T>
+	EZ_MATH_INLINE constexpr T roundMagic(T x) noexcept {
+#if defined(__FAST_MATH__)
+		// Fast math cancels the two adds, so use the round instruction at run time
+		if (!__builtin_is_constant_evaluated()) {
+			return std::nearbyint(x);
+		}
+#endif
+		constexpr T magic = std::is_same_v<T, float> ? T(12582912.0) : T(6755399441055744.0);
+		return (x + magic) - magic;
+	}
+
+	// x - k * (parts[0] + parts[1] + ...), for range reduction by a constant that is split into parts short enough
+	// that their products with k are exact, so the remainder keeps the full precision of the constant.
+	template<typename T, std::size_t N>
+	EZ_MATH_INLINE constexpr T subtractSplit(T x, T k, const T(&parts)[N]) noexcept {
+#if defined(__FAST_MATH__)
+		// Fast math would merge the products into one rounded product of the whole constant, fused operations keep them apart
+		if (!__builtin_is_constant_evaluated()) {
+			for (std::size_t i = 0; i < N; ++i) {
+				x = std::fma(-k, parts[i], x);
+			}
+			return x;
+		}
+#endif
+		for (std::size_t i = 0; i < N; ++i) {
+			x -= k * parts[i];
+		}
+		return x;
+	}
+
+	// In place square root of an array. The default -fmath-errno keeps gcc from vectorizing std::sqrt,
+	// since a negative input has to set errno, so use the vector instruction directly where we can.
+	template<typename T>
+	void sqrt(T* values, std::size_t count) noexcept {
+		std::size_t i = 0;
+#if defined(EZ_MATH_AVX2)
+		if constexpr (std::is_same_v<T, float>) {
+			for (; i + 8 <= count; i += 8) {
+				_mm256_storeu_ps(values + i, _mm256_sqrt_ps(_mm256_loadu_ps(values + i)));
+			}
+		}
+		else if constexpr (std::is_same_v<T, double>) {
+			for (; i + 4 <= count; i += 4) {
+				_mm256_storeu_pd(values + i, _mm256_sqrt_pd(_mm256_loadu_pd(values + i)));
+			}
+		}
+#endif
+		// The rest is counted from zero, with a constant count gcc warns about overflow in the form i < count
+		EZ_MATH_VECTORIZE
+		for (std::size_t j = 0; j < count - i; ++j) {
+			values[i + j] = std::sqrt(values[i + j]);
+		}
+	}
+};
@@ -6,6 +6,10 @@
 #include <glm/vec4.hpp>
 #include <glm/geometric.hpp>
 #include <cmath>
+#include <cstddef>
+#include <cinttypes>
+#include <algorithm>
+#include "simd.hpp"
 
 namespace ez {
 	template<typename T>
@@ -105,51 +109,263 @@ namespace ez::trig {
 		return a * coords.x + b * coords.y + c * coords.z;
 	}
 
-	// Puts the angle into standard position, ie in the range [0, 2 * pi]
+	// Precomputed setup for converting many points to and from barycentric coordinates of a single triangle.
+	// The constant parts of toBarycentric are folded into two dual edge vectors, so each point costs two dot products.
+	// For L > 2 points are projected onto the plane of the triangle, same as the free function.
+	template<typename T, glm::length_t L>
+	class BarycentricSetup {
+	public:
+		static_assert(std::is_floating_point_v<T>, "ez::trig::BarycentricSetup only accepts floating point types as input!");
+		using vec_t = glm::vec<L, T>;
+		using coords_t = glm::vec<3, T>;
+
+		BarycentricSetup() noexcept
+			: BarycentricSetup(vec_t(T(0)), vec_t(T(0)), vec_t(T(0)))
+		{}
+		BarycentricSetup(const vec_t& a, const vec_t& b, const vec_t& c) noexcept
+			: a(a)
+			, b(b)
+			, c(c)
+		{
+			vec_t v0 = b - a, v1 = c - a;
+			T d00 = glm::dot(v0, v0);
+			T d01 = glm::dot(v0, v1);
+			T d11 = glm::dot(v1, v1);
+			denom = d00 * d11 - d01 * d01;
+
+			T inv = T(1) / denom;
+			dual0 = (v0 * d11 - v1 * d01) * inv;
+			dual1 = (v1 * d00 - v0 * d01) * inv;
+		}
+
+		// Zero area triangles have no barycentric coordinates, every conversion gives nan.
+		bool degenerate() const noexcept {
+			return denom == T(0);
+		}
+
+		coords_t toBarycentric(const vec_t& p) const noexcept {
+			vec_t v2 = p - a;
+			coords_t result;
+			result.y = glm::dot(v2, dual0);
+			result.z = glm::dot(v2, dual1);
+			result.x = T(1) - result.y - result.z;
+			return result;
+		}
+		vec_t fromBarycentric(const coords_t& coords) const noexcept {
+			return a * coords.x + b * coords.y + c * coords.z;
+		}
+
+		// Batch conversion of an array of points
+		void toBarycentric(const vec_t* points, coords_t* out, std::size_t count) const noexcept {
+			for (std::size_t i = 0; i < count; ++i) {
+				out[i] = toBarycentric(points[i]);
+			}
+		}
+		void fromBarycentric(const coords_t* coords, vec_t* out, std::size_t count) const noexcept {
+			for (std::size_t i = 0; i < count; ++i) {
+				out[i] = fromBarycentric(coords[i]);
+			}
+		}
+
+		// Batch conversion of points stored as separate coordinate arrays, points[0] holding every x, points[1] every y, and so on.
+		// The coordinates are written to u, v and w, the weights of a, b and c respectively.
+		void toBarycentric(const T* const (&points)[L], T* u, T* v, T* w, std::size_t count) const noexcept {
+			EZ_MATH_VECTORIZE
+			for (std::size_t i = 0; i < count; ++i) {
+				T y = T(0), z = T(0);
+				for (glm::length_t k = 0; k < L; ++k) {
+					T d = points[k][i] - a[k];
+					y += d * dual0[k];
+					z += d * dual1[k];
+				}
+				u[i] = T(1) - y - z;
+				v[i] = y;
+				w[i] = z;
+			}
+		}
+
+		// Same as above, also setting inside[i] to one when the point lies within the triangle (edges included), and zero otherwise.
+		void toBarycentric(const T* const (&points)[L], T* u, T* v, T* w, std::uint8_t* inside, std::size_t count) const noexcept {
+			toBarycentric(points, u, v, w, count);
+
+			EZ_MATH_VECTORIZE
+			for (std::size_t i = 0; i < count; ++i) {
+				inside[i] = std::uint8_t((u[i] >= T(0)) & (v[i] >= T(0)) & (w[i] >= T(0)));
+			}
+		}
+
+		void fromBarycentric(const T* u, const T* v, const T* w, T* const (&points)[L], std::size_t count) const noexcept {
+			for (glm::length_t k = 0; k < L; ++k) {
+				T* out = points[k];
+				T ak = a[k], bk = b[k], ck = c[k];
+
+				EZ_MATH_VECTORIZE
+				for (std::size_t i = 0; i < count; ++i) {
+					out[i] = ak * u[i] + bk * v[i] + ck * w[i];
+				}
+			}
+		}
+
+		const vec_t& vertex(int index) const noexcept {
+			return index == 0 ? a : (index == 1 ? b : c);
+		}
+	private:
+		vec_t a, b, c;
+		vec_t dual0, dual1;
+		T denom;
+	};
+
+	namespace intern {
+		using ez::simd::roundMagic;
+
+		// One when x is negative, zero otherwise (including for +0). This stands in for a select on a comparison,
+		// since gcc will not if-convert floating point selects while trapping math is enabled.
+		template<typename T>
+		T negativeStep(T x) noexcept {
+			return T(0.5) - std::copysign(T(0.5), x);
+		}
+
+		// Moves an angle that is at most one turn out of range back into it.
+		template<bool Centered, typename T>
+		T wrapAngle(T r) noexcept {
+			constexpr T tau = ez::tau<T>();
+			constexpr T low = Centered ? -tau / T(2) : T(0);
+			constexpr T high = low + tau;
+
+			r += tau * negativeStep(r - low);
+			r -= tau * (T(1) - negativeStep(r - high));
+			return r;
+		}
+
+		// Reduces an angle modulo ez::tau<T>(), into [0, tau) or [-pi, pi) when centered.
+		// Rather than dividing, the quotient is found with a multiply by 1 / tau, and the remainder is computed exactly
+		// from it. The result is within an ulp of the one from std::fmod, as long as ok is set. For larger angles,
+		// where the quotient does not fit, ok is false and the result should be discarded.
+		template<bool Centered, typename T>
+		T reduceAngle(T value, bool& ok) noexcept {
+			constexpr T tau = ez::tau<T>();
+			T r;
+
+			if constexpr (std::is_same_v<T, float>) {
+				// The product of a quotient below 2^29 and the 24 bit constant is exact in double
+				constexpr double inv = 1.0 / double(tau);
+				double y = double(value) * inv;
+				double k = roundMagic(y);
+				if constexpr (!Centered) {
+					k -= negativeStep(y - k);
+				}
+				r = float(double(value) - k * double(tau));
+				ok = std::abs(y) < 536870912.0;
+			}
+			else {
+				static_assert(std::is_same_v<T, double>, "ez::trig angle reduction only supports float and double!");
+
+				// Split the constant into 26 and 27 bit halves, so both products are exact for quotients below 2^26
+				constexpr double split = 134217729.0;
+				constexpr double head = tau * split - (tau * split - tau);
+				constexpr double tail = tau - head;
+
+				constexpr double inv = 1.0 / tau;
+				double y = value * inv;
+				double k = roundMagic(y);
+				if constexpr (!Centered) {
+					k -= negativeStep(y - k);
+				}
+#if defined(__FAST_MATH__) && !defined(__FMA__)
+				// Fast math needs fused operations to keep the remainder exact, and without the instruction they are too slow, so leave it to std::fmod
+				r = value;
+				ok = false;
+#else
+				constexpr double parts[] = { head, tail };
+				r = ez::simd::subtractSplit(value, k, parts);
+				ok = std::abs(y) < 67108864.0;
+#endif
+			}
+
+			// The quotient can be off by one right at the boundaries
+			return wrapAngle<Centered>(r);
+		}
+
+		// Reference reduction, used for the angles that are too large for reduceAngle
+		template<bool Centered, typename T>
+		T reduceAngleSlow(T value) noexcept {
+			return wrapAngle<Centered>(std::fmod(value, ez::tau<T>()));
+		}
+
+		template<bool Centered, typename T>
+		T reduceAngle(T value) noexcept {
+			bool ok = true;
+			T r = reduceAngle<Centered>(value, ok);
+			return ok ? r : reduceAngleSlow<Centered>(value);
+		}
+
+		template<bool Centered, typename T>
+		void reduceAngles(const T* angles, T* out, std::size_t count) noexcept {
+			constexpr std::size_t block = 256;
+			bool ok[block];
+
+			for (std::size_t first = 0; first < count; first += block) {
+				std::size_t n = std::min(block, count - first);
+
+				EZ_MATH_VECTORIZE
+				for (std::size_t i = 0; i < n; ++i) {
+					out[first + i] = reduceAngle<Centered>(angles[first + i], ok[i]);
+				}
+
+				for (std::size_t i = 0; i < n; ++i) {
+					if (!ok[i]) {
+						out[first + i] = reduceAngleSlow<Centered>(angles[first + i]);
+					}
+				}
+			}
+		}
+	};
+
+	// Puts the angle into standard position, ie in the range [0, 2 * pi)
 	template<typename T>
 	T standardPosition(const T& value) noexcept {
 		static_assert(std::is_floating_point_v<T>, "ez::trig::standardPosition only accepts floating point types as input!");
+		return intern::reduceAngle<false>(value);
+	};
 
-		T angle = std::fmod(value, ez::tau<T>());
-		if (angle < ez::zero<T>()) {
-			angle += ez::tau<T>();
-		}
-		return angle;
+	// Puts count angles into standard position, ie in the range [0, 2 * pi). angles and out may be the same array.
+	template<typename T>
+	void standardPosition(const T* angles, T* out, std::size_t count) noexcept {
+		static_assert(std::is_floating_point_v<T>, "ez::trig::standardPosition only accepts floating point types as input!");
+		intern::reduceAngles<false>(angles, out, count);
 	};
 	
-	// Puts the angle into standard position, ie in the range [0, 2 * pi]
+	// Puts the angle into standard position, ie in the range [0, 2 * pi)
 	template<typename T, glm::length_t L>
 	glm::vec<L, T> standardPosition(const glm::vec<L, T>& value) noexcept {
 		static_assert(std::is_floating_point_v<T>, "ez::trig::standardPosition only accepts floating point types as input!");
 
 		glm::vec<L, T> res;
-		for (int i = 0; i < L; ++i) {
-			res[i] = standardPosition<T>(value[i]);
-		}
+		intern::reduceAngles<false>(&value[0], &res[0], std::size_t(L));
 		return res;
 	};
 
-	// Normalizes the angle to the range [-pi/2, pi/2] 
+	// Normalizes the angle to the range [-pi, pi)
 	template<typename T>
 	T normalizeAngle(const T& value) noexcept {
 		static_assert(std::is_floating_point_v<T>, "ez::trig::normalizeAngle only accepts floating point types as input!");
+		return intern::reduceAngle<true>(value);
+	};
 
-		T angle = std::fmod(value + ez::pi<T>(), ez::tau<T>());
-		if (angle < ez::zero<T>()) {
-			angle += ez::tau<T>();
-		}
-		return angle - ez::pi<T>();
+	// Normalizes count angles to the range [-pi, pi). angles and out may be the same array.
+	template<typename T>
+	void normalizeAngle(const T* angles, T* out, std::size_t count) noexcept {
+		static_assert(std::is_floating_point_v<T>, "ez::trig::normalizeAngle only accepts floating point types as input!");
+		intern::reduceAngles<true>(angles, out, count);
 	};
 
-	// Normalizes the angle to the range [-pi/2, pi/2]
+	// Normalizes the angle to the range [-pi, pi)
 	template<typename T, glm::length_t L>
 	glm::vec<L, T> normalizeAngle(const glm::vec<L, T>& value) noexcept {
 		static_assert(std::is_floating_point_v<T>, "ez::trig::normalizeAngle only accepts floating point types as input!");
 
 		glm::vec<L, T> res;
-		for (int i = 0; i < L; ++i) {
-			res[i] = normalizeAngle<T>(value[i]);
-		}
+		intern::reduceAngles<true>(&value[0], &res[0], std::size_t(L));
 		return res;
 	};
 };
\ No newline at end of file
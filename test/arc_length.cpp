@@ -0,0 +1,107 @@
+#include <catch2/catch_all.hpp>
+
+#include <vector>
+#include <random>
+
+#include <ez/math/arc_length.hpp>
+#include <ez/math/bezier.hpp>
+
+using Approx = Catch::Approx;
+
+using dvec2 = glm::dvec2;
+using Cubic = ez::bezier::Cubic<2, double>;
+
+// The length of the curve from 0 to t, by simpson's rule with many steps
+static double referenceLength(const Cubic& curve, double t, int steps = 20000) {
+	double h = t / steps, sum = 0.0;
+	for (int i = 0; i <= steps; ++i) {
+		double weight = (i == 0 || i == steps) ? 1.0 : (i % 2 == 1 ? 4.0 : 2.0);
+		sum += weight * glm::length(curve.derivativeAt(i * h));
+	}
+	return sum * h / 3.0;
+}
+
+TEST_CASE("arc length table") {
+	// Evenly spaced control points on a line move at constant speed
+	Cubic line{ { dvec2{ 0, 0 }, dvec2{ 1, 2 }, dvec2{ 2, 4 }, dvec2{ 3, 6 } } };
+	ez::ArcLengthTable<double> straight{ &line, 1 };
+	double total = std::sqrt(45.0);
+	REQUIRE(straight.length() == Approx(total));
+	for (double d : { 0.0, 0.1, 2.5, 6.0, total }) {
+		ez::ArcLengthTable<double>::Location at = straight.locate(d);
+		REQUIRE(at.segment == 0);
+		REQUIRE(at.t == Approx(d / total).margin(1e-12));
+	}
+
+	// A bend, against simpson's rule
+	Cubic curve{ { dvec2{ 0, 0 }, dvec2{ 1, 3 }, dvec2{ 4, -2 }, dvec2{ 5, 1 } } };
+	ez::ArcLengthTable<double> table;
+	table.build(curve);
+	REQUIRE(table.segments() == 1);
+	REQUIRE(table.length() == Approx(referenceLength(curve, 1.0)).epsilon(1e-9));
+
+	// The interpolation error falls with the fourth power of the step
+	ez::ArcLengthTable<double> fine{ &curve, 1, 64 };
+	for (int i = 0; i <= 100; ++i) {
+		double d = table.length() * i / 100.0;
+		ez::ArcLengthTable<double>::Location at = table.locate(d), fineAt = fine.locate(d);
+		REQUIRE(referenceLength(curve, at.t, 2000) == Approx(d).margin(table.length() * 1e-4));
+		REQUIRE(referenceLength(curve, fineAt.t, 2000) == Approx(d).margin(table.length() * 1e-6));
+		REQUIRE(table.distance(0, at.t) == Approx(d).margin(table.length() * 1e-4));
+	}
+
+	// Past the ends
+	REQUIRE(table.locate(-1.0).t == 0.0);
+	REQUIRE(table.locate(table.length() + 1.0).t == 1.0);
+}
+
+TEST_CASE("arc length cusp") {
+	// The speed drops to zero halfway along, the parameter must still increase with distance
+	Cubic cusp{ { dvec2{ 0, 0 }, dvec2{ 1, 1 }, dvec2{ 0, 1 }, dvec2{ 1, 0 } } };
+	ez::ArcLengthTable<double> table{ &cusp, 1, 32 };
+
+	double previous = 0.0;
+	for (int i = 0; i <= 1000; ++i) {
+		double t = table.locate(table.length() * i / 1000.0).t;
+		REQUIRE(t >= previous);
+		previous = t;
+	}
+	REQUIRE(table.locate(table.length() / 2).t == Approx(0.5).margin(1e-3));
+
+	// A polynomial works too, t^2 has zero speed at the start and the distance is the value
+	ez::poly::Polynomial<double, 2> square{ { 0.0, 0.0, 1.0 } };
+	ez::ArcLengthTable<double> easing{ &square, 1 };
+	REQUIRE(easing.length() == Approx(1.0));
+	for (double d : { 0.01, 0.25, 0.5, 0.9 }) {
+		REQUIRE(easing.locate(d).t == Approx(std::sqrt(d)).margin(1e-3));
+	}
+}
+
+TEST_CASE("arc length spline") {
+	std::vector<Cubic> spline{
+		Cubic{ { dvec2{ 0, 0 }, dvec2{ 1, 3 }, dvec2{ 4, -2 }, dvec2{ 5, 1 } } },
+		Cubic{ { dvec2{ 5, 1 }, dvec2{ 6, 4 }, dvec2{ 7, 4 }, dvec2{ 8, 1 } } },
+		Cubic{ { dvec2{ 8, 1 }, dvec2{ 9, -2 }, dvec2{ 10, 0 }, dvec2{ 12, 0 } } },
+	};
+	ez::ArcLengthTable<double> table{ spline.data(), spline.size() };
+	REQUIRE(table.segments() == 3);
+	REQUIRE(table.length() == Approx(table.length(0) + table.length(1) + table.length(2)));
+
+	// Distances past the end of one segment land in the next
+	ez::ArcLengthTable<double>::Location at = table.locate(table.length(0) + table.length(1) * 0.5);
+	REQUIRE(at.segment == 1);
+	REQUIRE(table.distance(1, at.t) == Approx(table.length(0) + table.length(1) * 0.5));
+	REQUIRE(table.locate(table.length()).segment == 2);
+
+	// Changing the middle segment gives the same table as building from scratch
+	spline[1] = Cubic{ { dvec2{ 5, 1 }, dvec2{ 6, 10 }, dvec2{ 7, -6 }, dvec2{ 8, 1 } } };
+	table.update(1, spline[1]);
+	ez::ArcLengthTable<double> rebuilt{ spline.data(), spline.size() };
+	REQUIRE(table.length() == rebuilt.length());
+	for (int i = 0; i <= 200; ++i) {
+		double d = rebuilt.length() * i / 200.0;
+		ez::ArcLengthTable<double>::Location lh = table.locate(d), rh = rebuilt.locate(d);
+		REQUIRE(lh.segment == rh.segment);
+		REQUIRE(lh.t == rh.t);
+	}
+}
\ No newline at end of file
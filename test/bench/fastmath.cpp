@@ -0,0 +1,87 @@
+#include <catch2/catch_all.hpp>
+
+#include <vector>
+#include <cmath>
+#include <chrono>
+#include <cstring>
+#include <limits>
+#include <fmt/core.h>
+
+#include <ez/math/fastmath.hpp>
+#include "../fastmath_inputs.hpp"
+
+using ez::fastmath::Precision;
+
+static std::int64_t orderedBits(float value) {
+	std::int32_t bits;
+	std::memcpy(&bits, &value, sizeof(float));
+	return bits < 0 ? std::int64_t(std::numeric_limits<std::int32_t>::min()) - bits : bits;
+}
+
+static std::int64_t ulpDistance(float a, float b) {
+	return std::abs(orderedBits(a) - orderedBits(b));
+}
+
+template<typename Fast, typename Reference>
+static void report(const char* name, const std::vector<float>& x, const std::vector<float>& y, Fast&& fast, Reference&& reference) {
+	std::vector<float> out(x.size()), expected(x.size());
+
+	using Clock = std::chrono::steady_clock;
+	auto start = Clock::now();
+	for (int rep = 0; rep < 20; ++rep) {
+		reference(x.data(), y.data(), expected.data(), x.size());
+	}
+	double libmTime = std::chrono::duration<double>(Clock::now() - start).count();
+
+	start = Clock::now();
+	for (int rep = 0; rep < 20; ++rep) {
+		fast(x.data(), y.data(), out.data(), x.size());
+	}
+	double fastTime = std::chrono::duration<double>(Clock::now() - start).count();
+
+	std::int64_t worst = 0;
+	for (std::size_t i = 0; i < x.size(); ++i) {
+		worst = std::max(worst, ulpDistance(out[i], expected[i]));
+	}
+
+	double values = 20.0 * double(x.size()) * 1e-6;
+	fmt::print("{:<16} {:>10.1f} {:>10.1f} {:>12}\n", name, values / libmTime, values / fastTime, worst);
+}
+
+template<Precision P>
+static void reportTier(const char* tier) {
+	std::vector<float> angles = uniformFloats(1 << 16, -10.f, 10.f, 12);
+	std::vector<float> y = uniformFloats(1 << 16, -10.f, 10.f, 13);
+	std::vector<float> exponents = uniformFloats(1 << 16, -80.f, 80.f, 14);
+	std::vector<float> positive = logUniformFloats(1 << 16, 1e-30f, 1e30f, 15);
+	std::vector<float> bases = logUniformFloats(1 << 16, 1e-3f, 1e3f, 16);
+	std::vector<float> powers = uniformFloats(1 << 16, -8.f, 8.f, 17);
+
+	fmt::print("\n{:<16} {:>10} {:>10} {:>12}\n", tier, "libm M/s", "fast M/s", "max ulp");
+	report("sin", angles, y,
+		[](const float* x, const float*, float* out, std::size_t n) { ez::fastmath::sin<P>(x, out, n); },
+		[](const float* x, const float*, float* out, std::size_t n) { for (std::size_t i = 0; i < n; ++i) out[i] = std::sin(x[i]); });
+	report("cos", angles, y,
+		[](const float* x, const float*, float* out, std::size_t n) { ez::fastmath::cos<P>(x, out, n); },
+		[](const float* x, const float*, float* out, std::size_t n) { for (std::size_t i = 0; i < n; ++i) out[i] = std::cos(x[i]); });
+	report("atan2", y, angles,
+		[](const float* a, const float* b, float* out, std::size_t n) { ez::fastmath::atan2<P>(a, b, out, n); },
+		[](const float* a, const float* b, float* out, std::size_t n) { for (std::size_t i = 0; i < n; ++i) out[i] = std::atan2(a[i], b[i]); });
+	report("exp", exponents, y,
+		[](const float* x, const float*, float* out, std::size_t n) { ez::fastmath::exp<P>(x, out, n); },
+		[](const float* x, const float*, float* out, std::size_t n) { for (std::size_t i = 0; i < n; ++i) out[i] = std::exp(x[i]); });
+	report("log", positive, y,
+		[](const float* x, const float*, float* out, std::size_t n) { ez::fastmath::log<P>(x, out, n); },
+		[](const float* x, const float*, float* out, std::size_t n) { for (std::size_t i = 0; i < n; ++i) out[i] = std::log(x[i]); });
+	report("pow", bases, powers,
+		[](const float* a, const float* b, float* out, std::size_t n) { ez::fastmath::pow<P>(a, b, out, n); },
+		[](const float* a, const float* b, float* out, std::size_t n) { for (std::size_t i = 0; i < n; ++i) out[i] = std::pow(a[i], b[i]); });
+}
+
+// Prints the throughput of each function next to libm, and the largest error in ulp over the sampled inputs.
+// The ulp error of sin and cos is large near their zeros by design, the tiers bound the absolute error there.
+TEST_CASE("fastmath throughput", "[benchmark]") {
+	reportTier<Precision::Low>("low");
+	reportTier<Precision::Medium>("medium");
+	reportTier<Precision::Full>("full");
+}
\ No newline at end of file
@@ -0,0 +1,56 @@
+#include <catch2/catch_all.hpp>
+
+#include <vector>
+#include <random>
+#include <algorithm>
+
+#include <ez/math/palette.hpp>
+
+static const ez::ColorU primaries[] = {
+	ez::ColorU{ 0, 0, 0 },
+	ez::ColorU{ 255, 0, 0 },
+	ez::ColorU{ 0, 255, 0 },
+	ez::ColorU{ 0, 0, 255 },
+	ez::ColorU{ 255, 255, 255 },
+};
+
+// Random pixels clustered around the primaries
+static std::vector<ez::ColorU> clusteredPixels(std::size_t count, unsigned seed) {
+	std::mt19937 gen{ seed };
+	std::vector<ez::ColorU> pixels;
+	for (std::size_t i = 0; i < count; ++i) {
+		const ez::ColorU& base = primaries[gen() % 5];
+		ez::ColorU pixel;
+		for (int c = 0; c < 3; ++c) {
+			int noise = int(gen() % 17) - 8;
+			pixel[c] = uint8_t(std::max(0, std::min(int(base[c]) + noise, 255)));
+		}
+		pixels.push_back(pixel);
+	}
+	return pixels;
+}
+
+TEST_CASE("palette throughput", "[benchmark]") {
+	std::size_t width = 512, height = 512;
+	std::vector<ez::ColorU> pixels = clusteredPixels(width * height, 5);
+	std::vector<uint8_t> indices(pixels.size());
+
+	BENCHMARK("median cut 256") {
+		return ez::ColorPalette::medianCut(pixels.data(), pixels.size(), 256).size();
+	};
+
+	ez::ColorPalette palette = ez::ColorPalette::medianCut(pixels.data(), pixels.size(), 256);
+
+	BENCHMARK("quantize 512x512") {
+		palette.quantize(pixels.data(), indices.data(), pixels.size());
+		return indices[0];
+	};
+	BENCHMARK("ordered dither 512x512") {
+		palette.quantize(pixels.data(), indices.data(), width, height, ez::Dither::Ordered);
+		return indices[0];
+	};
+	BENCHMARK("floyd steinberg 512x512") {
+		palette.quantize(pixels.data(), indices.data(), width, height, ez::Dither::FloydSteinberg);
+		return indices[0];
+	};
+}
\ No newline at end of file
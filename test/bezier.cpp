@@ -0,0 +1,206 @@
+#include <catch2/catch_all.hpp>
+
+#include <vector>
+#include <random>
+
+#include <ez/math/bezier.hpp>
+
+using Approx = Catch::Approx;
+
+using dvec2 = glm::dvec2;
+using Cubic = ez::bezier::Cubic<2, double>;
+using Quadratic = ez::bezier::Quadratic<2, double>;
+
+// The distance from p to the segment from a to b
+static double segmentDistance(dvec2 p, dvec2 a, dvec2 b) {
+	dvec2 ab = b - a;
+	double t = std::clamp(glm::dot(p - a, ab) / std::max(glm::dot(ab, ab), 1e-300), 0.0, 1.0);
+	return glm::length(p - (a + ab * t));
+}
+
+TEST_CASE("bezier basics") {
+	Cubic curve{ { dvec2{ 0, 0 }, dvec2{ 1, 3 }, dvec2{ 4, -2 }, dvec2{ 5, 1 } } };
+
+	REQUIRE(curve(0.0) == curve[0]);
+	REQUIRE(curve(1.0) == curve[3]);
+
+	// Power basis, both ways
+	auto basis = curve.powerBasis();
+	Cubic restored = Cubic::fromPowerBasis(basis);
+	ez::poly::Polynomial<double, 3> x = curve.polynomial(0), y = curve.polynomial(1);
+	for (std::size_t i = 0; i < 4; ++i) {
+		REQUIRE(restored[i].x == Approx(curve[i].x));
+		REQUIRE(restored[i].y == Approx(curve[i].y));
+	}
+
+	for (double t : { 0.0, 0.2, 0.5, 0.77, 1.0 }) {
+		dvec2 p = curve(t);
+		REQUIRE(x(t) == Approx(p.x).margin(1e-12));
+		REQUIRE(y(t) == Approx(p.y).margin(1e-12));
+
+		// The derivative against the poly functions, which take the highest power first
+		dvec2 d = curve.derivativeAt(t);
+		REQUIRE(d.x == Approx(ez::poly::derivativeAt(x[3], x[2], x[1], t)));
+		REQUIRE(d.y == Approx(ez::poly::derivativeAt(y[3], y[2], y[1], t)));
+
+		// Elevated to degree four it is the same curve
+		dvec2 e = curve.elevate()(t);
+		REQUIRE(e.x == Approx(p.x).margin(1e-12));
+		REQUIRE(e.y == Approx(p.y).margin(1e-12));
+	}
+
+	// Subdivision
+	auto [left, right] = curve.split(0.3);
+	REQUIRE(left[3] == right[0]);
+	Cubic middle = curve.segment(0.25, 0.6);
+	for (double u : { 0.0, 0.4, 1.0 }) {
+		dvec2 l = left(u), r = right(u), m = middle(u);
+		REQUIRE(glm::length(l - curve(0.3 * u)) < 1e-12);
+		REQUIRE(glm::length(r - curve(0.3 + 0.7 * u)) < 1e-12);
+		REQUIRE(glm::length(m - curve(0.25 + 0.35 * u)) < 1e-12);
+	}
+}
+
+TEST_CASE("bezier bounds") {
+	std::mt19937 gen{ 5 };
+	std::uniform_real_distribution<double> dist{ -10.0, 10.0 };
+
+	for (int n = 0; n < 100; ++n) {
+		Cubic cubic;
+		for (dvec2& p : cubic.points) {
+			p = dvec2{ dist(gen), dist(gen) };
+		}
+		Quadratic quadratic{ { cubic[0], cubic[1], cubic[3] } };
+		ez::bezier::Curve<2, double, 4> quartic = cubic.elevate();
+
+		ez::bezier::Bounds<2, double> cubicBox = cubic.bounds(), quadraticBox = quadratic.bounds(), quarticBox = quartic.bounds();
+		ez::bezier::Bounds<2, double> cubicSampled{ cubic[0], cubic[0] }, quadraticSampled{ quadratic[0], quadratic[0] };
+		for (int i = 1; i <= 4000; ++i) {
+			cubicSampled.expand(cubic(i / 4000.0));
+			quadraticSampled.expand(quadratic(i / 4000.0));
+		}
+
+		// Contains every point, and is no larger than sampling shows
+		for (int axis = 0; axis < 2; ++axis) {
+			REQUIRE(cubicBox.min[axis] <= cubicSampled.min[axis] + 1e-12);
+			REQUIRE(cubicBox.max[axis] >= cubicSampled.max[axis] - 1e-12);
+			REQUIRE(cubicBox.min[axis] == Approx(cubicSampled.min[axis]).margin(1e-4));
+			REQUIRE(cubicBox.max[axis] == Approx(cubicSampled.max[axis]).margin(1e-4));
+
+			REQUIRE(quadraticBox.min[axis] <= quadraticSampled.min[axis] + 1e-12);
+			REQUIRE(quadraticBox.max[axis] >= quadraticSampled.max[axis] - 1e-12);
+			REQUIRE(quadraticBox.min[axis] == Approx(quadraticSampled.min[axis]).margin(1e-4));
+			REQUIRE(quadraticBox.max[axis] == Approx(quadraticSampled.max[axis]).margin(1e-4));
+
+			REQUIRE(quarticBox.min[axis] == Approx(cubicBox.min[axis]).margin(1e-9));
+			REQUIRE(quarticBox.max[axis] == Approx(cubicBox.max[axis]).margin(1e-9));
+		}
+	}
+
+	// 3D, with the z axis bulging out
+	ez::bezier::Cubic3 curve{ { glm::vec3{ 0, 0, 0 }, glm::vec3{ 1, 0, 2 }, glm::vec3{ 2, 0, 2 }, glm::vec3{ 3, 0, 0 } } };
+	ez::bezier::Bounds<3, float> box = curve.bounds();
+	REQUIRE(box.max.z == Approx(1.5f));
+	REQUIRE(box.min.x == 0.f);
+	REQUIRE(box.max.x == 3.f);
+}
+
+TEST_CASE("bezier flattening") {
+	std::vector<Cubic> path{
+		Cubic{ { dvec2{ 0, 0 }, dvec2{ 10, 40 }, dvec2{ 60, -30 }, dvec2{ 80, 10 } } },
+		Cubic{ { dvec2{ 80, 10 }, dvec2{ 90, 20 }, dvec2{ 100, 30 }, dvec2{ 110, 40 } } },
+		Cubic{ { dvec2{ 110, 40 }, dvec2{ 200, 0 }, dvec2{ -100, 0 }, dvec2{ 100, 50 } } },
+	};
+
+	for (double tolerance : { 1.0, 0.1, 0.01 }) {
+		std::vector<dvec2> points;
+		std::size_t count = ez::bezier::flatten(path.data(), path.size(), tolerance, points);
+		REQUIRE(count == points.size());
+		REQUIRE(points.front() == path.front()[0]);
+		REQUIRE(points.back() == path.back()[3]);
+
+		// Every point along each curve is within tolerance of its own segment of the polyline
+		std::size_t offset = 0;
+		for (const Cubic& curve : path) {
+			std::uint32_t segments = curve.segments(tolerance);
+			for (std::uint32_t i = 0; i < segments; ++i) {
+				dvec2 a = points[offset + i], b = points[offset + i + 1];
+				for (int j = 0; j <= 16; ++j) {
+					double t = (i + j / 16.0) / segments;
+					REQUIRE(segmentDistance(curve(t), a, b) <= tolerance);
+				}
+			}
+			offset += segments;
+		}
+		REQUIRE(offset + 1 == points.size());
+	}
+
+	// A straight line needs one segment, tighter tolerances need more
+	REQUIRE(path[1].segments(0.01) == 1);
+	REQUIRE(path[0].segments(0.01) > path[0].segments(1.0));
+
+	std::vector<glm::vec2> single;
+	ez::bezier::Quadratic2 quadratic{ { glm::vec2{ 0, 0 }, glm::vec2{ 1, 2 }, glm::vec2{ 2, 0 } } };
+	std::uint32_t written = quadratic.flatten(0.05f, std::back_inserter(single));
+	REQUIRE(written == single.size());
+	REQUIRE(single.back() == quadratic[2]);
+}
+
+TEST_CASE("bezier intersection") {
+	Cubic curve{ { dvec2{ 0, 0 }, dvec2{ 1, 3 }, dvec2{ 2, -3 }, dvec2{ 3, 0 } } };
+
+	// Against a line, the curve is symmetric about (1.5, 0)
+	std::vector<double> ts;
+	int count = ez::bezier::intersect(curve, dvec2{ -1, 0 }, dvec2{ 4, 0 }, std::back_inserter(ts));
+	REQUIRE(count == 3);
+	REQUIRE(ts[0] == Approx(0.0).margin(1e-12));
+	REQUIRE(ts[1] == Approx(0.5));
+	REQUIRE(ts[2] == Approx(1.0));
+
+	ts.clear();
+	REQUIRE(ez::bezier::intersect(curve, dvec2{ 0, 5 }, dvec2{ 1, 5 }, std::back_inserter(ts)) == 0);
+
+	Quadratic arch{ { dvec2{ 0, 0 }, dvec2{ 1, 2 }, dvec2{ 2, 0 } } };
+	ts.clear();
+	REQUIRE(ez::bezier::intersect(arch, dvec2{ 0, 0.5 }, dvec2{ 1, 0.5 }, std::back_inserter(ts)) == 2);
+	REQUIRE(arch(ts[0]).y == Approx(0.5));
+	REQUIRE(arch(ts[1]).y == Approx(0.5));
+
+	// Degree four goes through Polynomial, and the line passes through both ends
+	ez::bezier::Curve<2, double, 4> quartic{ { dvec2{ 0, 0 }, dvec2{ 1, 2 }, dvec2{ 2, -1 }, dvec2{ 3, 2 }, dvec2{ 4, 0 } } };
+	ts.clear();
+	REQUIRE(ez::bezier::intersect(quartic, dvec2{ -1, 0 }, dvec2{ 5, 0 }, std::back_inserter(ts)) == 2);
+	REQUIRE(ts[0] == 0.0);
+	REQUIRE(ts[1] == 1.0);
+	ez::bezier::Bounds<2, double> box = quartic.bounds();
+	REQUIRE(box.min.x == 0.0);
+	REQUIRE(box.max.x == 4.0);
+
+	// Against another curve, a horizontal s shape crossing it three times
+	Cubic other{ { dvec2{ -0.5, 0.5 }, dvec2{ 1, -1 }, dvec2{ 2, 1 }, dvec2{ 3.5, -0.5 } } };
+	std::vector<dvec2> hits;
+	count = ez::bezier::intersect(curve, other, std::back_inserter(hits));
+	REQUIRE(count == int(hits.size()));
+	REQUIRE(count == 3);
+	REQUIRE(hits[1].x == Approx(0.5));
+	REQUIRE(hits[1].y == Approx(0.5));
+	for (std::size_t i = 0; i < hits.size(); ++i) {
+		REQUIRE(glm::length(curve(hits[i].x) - other(hits[i].y)) < 1e-10);
+		if (i > 0) {
+			REQUIRE(hits[i].x > hits[i - 1].x);
+		}
+	}
+
+	// Tangent crossing, reported once
+	Quadratic cap{ { dvec2{ 0, 1 }, dvec2{ 1, -1 }, dvec2{ 2, 1 } } };
+	ez::bezier::Linear<2, double> floor{ { dvec2{ -1, 0 }, dvec2{ 3, 0 } } };
+	hits.clear();
+	REQUIRE(ez::bezier::intersect(cap, floor, std::back_inserter(hits)) == 1);
+	REQUIRE(hits[0].x == Approx(0.5).margin(1e-6));
+	REQUIRE(hits[0].y == Approx(0.5).margin(1e-6));
+
+	// Apart
+	Cubic far{ { dvec2{ 10, 10 }, dvec2{ 11, 12 }, dvec2{ 12, 12 }, dvec2{ 13, 10 } } };
+	hits.clear();
+	REQUIRE(ez::bezier::intersect(curve, far, std::back_inserter(hits)) == 0);
+}
\ No newline at end of file
@@ -0,0 +1,115 @@
+#include <catch2/catch_all.hpp>
+
+#include <vector>
+#include <random>
+#include <fmt/core.h>
+
+#include <ez/math/blend.hpp>
+
+using Approx = Catch::Approx;
+using ez::color::BlendMode;
+
+static std::vector<ez::ColorU> randomPremultiplied(std::size_t count, unsigned seed) {
+	std::mt19937 gen{ seed };
+	std::vector<ez::ColorU> colors;
+	for (std::size_t i = 0; i < count; ++i) {
+		uint8_t a = uint8_t(gen() % 256);
+		colors.push_back(ez::ColorU{ uint8_t(gen() % (a + 1)), uint8_t(gen() % (a + 1)), uint8_t(gen() % (a + 1)), a });
+	}
+	return colors;
+}
+
+TEST_CASE("premultiply") {
+	std::vector<ez::ColorU> colors;
+	for (int a = 0; a < 256; ++a) {
+		for (int c = 0; c < 256; ++c) {
+			colors.push_back(ez::ColorU{ uint8_t(c), uint8_t(255 - c), uint8_t(c / 2), uint8_t(a) });
+		}
+	}
+
+	std::vector<ez::ColorU> premul(colors.size());
+	ez::color::premultiply(colors.data(), premul.data(), colors.size());
+	for (std::size_t i = 0; i < colors.size(); ++i) {
+		int expected = (colors[i].r * colors[i].a * 2 + 255) / 510;
+		REQUIRE(int(premul[i].r) == expected);
+		REQUIRE(premul[i].a == colors[i].a);
+	}
+
+	// Exact rounded division, in place
+	ez::color::unpremultiply(premul.data(), premul.size());
+	for (std::size_t i = 0; i < colors.size(); ++i) {
+		const ez::ColorU& color = premul[i];
+		int a = colors[i].a;
+		int c = int(ez::ColorU{ colors[i] }.r * a * 2 + 255) / 510;
+		int expected = a == 0 ? 0 : std::min((c * 255 + a / 2) / a, 255);
+		REQUIRE(int(color.r) == expected);
+
+		// Opaque colors survive the round trip
+		if (a == 255) {
+			REQUIRE(color == colors[i]);
+		}
+	}
+
+	ez::ColorF color{ 0.5f, 0.25f, 1.f, 0.5f };
+	ez::color::premultiply(&color, 1);
+	REQUIRE(color == ez::ColorF{ 0.25f, 0.125f, 0.5f, 0.5f });
+	ez::color::unpremultiply(&color, 1);
+	REQUIRE(color == ez::ColorF{ 0.5f, 0.25f, 1.f, 0.5f });
+}
+
+TEST_CASE("blend modes") {
+	BlendMode modes[] = {
+		BlendMode::Clear, BlendMode::Source, BlendMode::Destination, BlendMode::Over,
+		BlendMode::DestinationOver, BlendMode::In, BlendMode::DestinationIn, BlendMode::Out,
+		BlendMode::DestinationOut, BlendMode::Atop, BlendMode::DestinationAtop, BlendMode::Xor,
+		BlendMode::Multiply, BlendMode::Screen, BlendMode::Overlay, BlendMode::Add,
+	};
+
+	auto src = randomPremultiplied(1001, 1);
+	auto dst = randomPremultiplied(1001, 2);
+
+	std::vector<ez::ColorF> srcf(src.begin(), src.end());
+	std::vector<ez::ColorF> dstf(dst.begin(), dst.end());
+
+	for (BlendMode mode : modes) {
+		auto result = dst;
+		ez::color::blend(src.data(), result.data(), result.size(), mode);
+
+		auto resultf = dstf;
+		ez::color::blend(srcf.data(), resultf.data(), resultf.size(), mode);
+
+		// The integer path is the rounded floating point result
+		for (std::size_t i = 0; i < result.size(); ++i) {
+			for (int k = 0; k < 4; ++k) {
+				float expected = std::max(0.f, std::min(resultf[i][k], 1.f)) * 255.f;
+				REQUIRE(std::abs(float(result[i][k]) - expected) <= 0.5f);
+			}
+		}
+	}
+
+	// A few exact values
+	ez::ColorU red{ 255, 0, 0, 255 };
+	ez::ColorU halfBlue{ 0, 0, 128, 128 };
+
+	ez::ColorU over = red;
+	ez::color::blend(&halfBlue, &over, 1);
+	REQUIRE(over == ez::ColorU{ 127, 0, 128, 255 });
+
+	ez::ColorU cleared = red;
+	ez::color::blend(&halfBlue, &cleared, 1, BlendMode::Clear);
+	REQUIRE(cleared == ez::ColorU{ 0, 0, 0, 0 });
+
+	ez::ColorU added{ 200, 100, 0, 200 };
+	ez::color::blend(&added, &added, 1, BlendMode::Add);
+	REQUIRE(added == ez::ColorU{ 255, 200, 0, 255 });
+
+	ez::ColorF white{ 1.f, 1.f, 1.f, 1.f };
+	ez::ColorF gray{ 0.5f, 0.5f, 0.5f, 1.f };
+	ez::ColorF multiplied = gray;
+	ez::color::blend(&white, &multiplied, 1, BlendMode::Multiply);
+	REQUIRE(multiplied == gray);
+
+	ez::ColorF screened = gray;
+	ez::color::blend(&gray, &screened, 1, BlendMode::Screen);
+	REQUIRE(screened == ez::ColorF{ 0.75f, 0.75f, 0.75f, 1.f });
+}
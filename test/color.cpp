@@ -1,5 +1,10 @@
 #include <catch2/catch_all.hpp>
 
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <unordered_set>
+#include <tuple>
 #include <fmt/core.h>
 #include <fmt/ostream.h>
 #include <fmt/format.h>
@@ -49,4 +54,57 @@ TEST_CASE("float color") {
 	REQUIRE(ColorU{ Color::fromHSV(235, 0.82, 0.35) } == ColorU{ 16, 22, 89 });
 	REQUIRE(ColorU{ Color::fromHSV(262, 0.92, 0.63) } == ColorU{ 67, 13, 161 });
 	REQUIRE(ColorU{ Color::fromHSV(329, 0.65, 0.91) } == ColorU{ 232, 81, 159 });
+}
+
+TEST_CASE("color ordering") {
+	using Color = ez::ColorU;
+
+	// Lexicographical, r first
+	REQUIRE(Color{ 1, 0, 0, 0 } > Color{ 0, 255, 255, 255 });
+	REQUIRE(Color{ 0, 1, 0, 0 } > Color{ 0, 0, 255, 255 });
+	REQUIRE(Color{ 0, 0, 1, 0 } > Color{ 0, 0, 0, 255 });
+	REQUIRE(Color{ 0, 0, 0, 0 } < Color{ 0, 0, 0, 1 });
+	REQUIRE(!(Color{ 5, 6, 7, 8 } < Color{ 5, 6, 7, 8 }));
+	REQUIRE(Color{ 5, 6, 7, 8 } <= Color{ 5, 6, 7, 8 });
+	REQUIRE(Color{ 5, 6, 7, 8 } >= Color{ 5, 6, 7, 8 });
+	REQUIRE(Color{ 5, 6, 7, 8 } != Color{ 5, 6, 7, 9 });
+
+	REQUIRE(ez::ColorF{ 0.5f, 0.f, 0.f } > ez::ColorF{ 0.25f, 1.f, 1.f });
+	REQUIRE(ez::ColorF{ 0.5f, 0.f, 0.f } < ez::ColorF{ 0.5f, 0.f, 0.5f });
+	REQUIRE(ez::ColorF{ 0.5f }.isNear(ez::ColorF{ 0.5f + 1e-7f }));
+	REQUIRE(!ez::ColorF{ 0.5f }.isNear(ez::ColorF{ 0.51f }));
+
+	// Matches the ordering of the channels as a tuple
+	std::mt19937 gen{ 13 };
+	std::vector<Color> colors;
+	for (int i = 0; i < 4096; ++i) {
+		colors.push_back(Color{ uint8_t(gen() % 4), uint8_t(gen() % 4), uint8_t(gen() % 4), uint8_t(gen() % 4) });
+	}
+	std::vector<Color> sorted = colors;
+	std::sort(sorted.begin(), sorted.end());
+	std::sort(colors.begin(), colors.end(), [](const Color& lh, const Color& rh) {
+		return std::tie(lh.r, lh.g, lh.b, lh.a) < std::tie(rh.r, rh.g, rh.b, rh.a);
+	});
+	REQUIRE(sorted == colors);
+
+	sorted.erase(std::unique(sorted.begin(), sorted.end()), sorted.end());
+	REQUIRE(sorted.size() == 256);
+}
+
+TEST_CASE("color hash") {
+	std::unordered_set<ez::ColorU> set;
+	for (int i = 0; i < 4; ++i) {
+		for (int c = 0; c < 256; ++c) {
+			set.insert(ez::ColorU{ uint8_t(c), uint8_t(255 - c), uint8_t(c / 2), 255 });
+		}
+	}
+	REQUIRE(set.size() == 256);
+	REQUIRE(set.count(ez::ColorU{ 10, 245, 5, 255 }) == 1);
+	REQUIRE(set.count(ez::ColorU{ 10, 245, 5, 254 }) == 0);
+
+	std::hash<ez::ColorF> hashF;
+	REQUIRE(hashF(ez::ColorF{ 0.f, 0.5f, 1.f }) == hashF(ez::ColorF{ -0.f, 0.5f, 1.f }));
+
+	std::unordered_set<ez::ColorF> setF{ ez::ColorF{ 0.25f }, ez::ColorF{ 0.25f }, ez::ColorF{ 0.5f } };
+	REQUIRE(setF.size() == 2);
 }
\ No newline at end of file
@@ -0,0 +1,80 @@
+#include <catch2/catch_all.hpp>
+
+#include <string>
+#include <vector>
+#include <fmt/core.h>
+
+#include <ez/math/color_hex.hpp>
+
+using ez::color::HexError;
+
+// Compile time palettes
+static constexpr ez::ColorU orange = ez::ColorU::fromHex("#FF8000");
+static_assert(orange.r == 255 && orange.g == 128 && orange.b == 0 && orange.a == 255);
+
+static constexpr ez::ColorU parsed = [] {
+	ez::ColorU color;
+	ez::color::parseHex("0x80'10'20'30", color);
+	return color;
+}();
+static_assert(parsed.r == 0x10 && parsed.g == 0x20 && parsed.b == 0x30 && parsed.a == 0x80);
+
+TEST_CASE("hex token") {
+	const char* tokens[] = {
+		"F", "a", "FF", "7f", "FFF", "0FFF", "F0F", "#FF00FF", "0xFF00'00FF", "12345678", "deadbeef", "#C0FFEE"
+	};
+
+	// Same results as Color::fromHex for every valid token
+	for (const char* token : tokens) {
+		ez::ColorU color;
+		REQUIRE(ez::color::parseHex(token, color) == HexError::None);
+		REQUIRE(color == ez::ColorU::fromHex(token));
+	}
+
+	ez::ColorU color;
+	REQUIRE(ez::color::parseHex("", color) == HexError::InvalidLength);
+	REQUIRE(ez::color::parseHex("#12345", color) == HexError::InvalidLength);
+	REQUIRE(ez::color::parseHex("1234567", color) == HexError::InvalidLength);
+	REQUIRE(ez::color::parseHex("123456789", color) == HexError::InvalidLength);
+	REQUIRE(ez::color::parseHex("#GG0000", color) == HexError::InvalidCharacter);
+	REQUIRE(ez::color::parseHex("12:456", color) == HexError::InvalidCharacter);
+	REQUIRE(ez::color::parseHex("\xC6\xB6", color) == HexError::InvalidCharacter);
+	REQUIRE(color == ez::ColorU{});
+}
+
+TEST_CASE("bulk hex parsing") {
+	std::string text = "[\"#FF0000\", \"#00ff00\";0x0000FF\n\tFFF  bag,  80FFFFFF,#12345,";
+
+	// Long enough for the vector scan
+	std::vector<ez::ColorU> expected;
+	for (int i = 0; i < 100; ++i) {
+		ez::ColorU color{ uint8_t(i), uint8_t(i * 2), uint8_t(i * 3), uint8_t(255 - i) };
+		text += fmt::format("  #{:02X}{:02X}{:02X}{:02X},", color.a, color.r, color.g, color.b);
+		expected.push_back(color);
+	}
+
+	std::vector<ez::ColorU> colors(200);
+	std::vector<HexError> errors(200);
+	std::size_t count = ez::color::parseHex(text, colors.data(), errors.data(), colors.size());
+
+	REQUIRE(count == 108);
+	REQUIRE(errors[0] == HexError::InvalidCharacter); // The leading [
+	REQUIRE(errors[1] == HexError::None);
+	REQUIRE(colors[1] == ez::ColorU{ 255, 0, 0 });
+	REQUIRE(colors[2] == ez::ColorU{ 0, 255, 0 });
+	REQUIRE(colors[3] == ez::ColorU{ 0, 0, 255 });
+	REQUIRE(colors[4] == ez::ColorU{ 255, 255, 255 });
+	REQUIRE(errors[5] == HexError::InvalidCharacter);
+	REQUIRE(colors[5] == ez::ColorU{});
+	REQUIRE(colors[6] == ez::ColorU{ 255, 255, 255, 128 });
+	REQUIRE(errors[7] == HexError::InvalidLength);
+
+	for (std::size_t i = 0; i < expected.size(); ++i) {
+		REQUIRE(errors[i + 8] == HexError::None);
+		REQUIRE(colors[i + 8] == expected[i]);
+	}
+
+	// Stops at the capacity, errors are optional
+	REQUIRE(ez::color::parseHex(text, colors.data(), nullptr, 3) == 3);
+	REQUIRE(ez::color::parseHex("  \n ", colors.data(), nullptr, 3) == 0);
+}
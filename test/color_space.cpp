@@ -0,0 +1,186 @@
+#include <catch2/catch_all.hpp>
+
+#include <vector>
+#include <cmath>
+#include <fmt/core.h>
+
+#include <ez/math/color_space.hpp>
+
+using Approx = Catch::Approx;
+
+static double referenceEncode(double value) {
+	value = std::max(0.0, std::min(value, 1.0));
+	double encoded = value < 0.0031308 ? value * 12.92 : 1.055 * std::pow(value, 1.0 / 2.4) - 0.055;
+	return encoded * 255.0;
+}
+
+TEST_CASE("srgb decode table") {
+	// The table is usable at compile time
+	static constexpr float black = ez::color::decodeSRGB(0);
+	static constexpr float white = ez::color::decodeSRGB(255);
+	REQUIRE(black == 0.f);
+	REQUIRE(white == Approx(1.f));
+
+	for (int i = 0; i < 256; ++i) {
+		float expected = glm::convertSRGBToLinear(glm::vec3{ float(i) / 255.f }).x;
+		REQUIRE(ez::color::decodeSRGB(uint8_t(i)) == Approx(expected).epsilon(1E-5));
+	}
+}
+
+TEST_CASE("srgb encode") {
+	// Every 8 bit value survives the round trip
+	for (int i = 0; i < 256; ++i) {
+		REQUIRE(int(ez::color::encodeSRGB(ez::color::decodeSRGB(uint8_t(i)))) == i);
+	}
+
+	// Never more than one step from the correctly rounded value
+	for (int i = -100; i <= 100100; ++i) {
+		double value = double(i) / 100000.0;
+		double expected = referenceEncode(value);
+		int encoded = ez::color::encodeSRGB(float(value));
+
+		REQUIRE(std::abs(encoded - expected) < 1.0);
+	}
+
+	REQUIRE(ez::color::encodeSRGB(NAN) == 0);
+	REQUIRE(ez::color::encodeSRGB(-1.f) == 0);
+	REQUIRE(ez::color::encodeSRGB(2.f) == 255);
+}
+
+TEST_CASE("srgb bulk conversion") {
+	std::vector<ez::ColorU> source;
+	for (int i = 0; i < 256; ++i) {
+		source.push_back(ez::ColorU{ uint8_t(i), uint8_t(255 - i), uint8_t(i / 2), uint8_t(i) });
+	}
+
+	std::vector<ez::ColorF> linear(source.size());
+	ez::color::srgbToLinear(source.data(), linear.data(), source.size());
+
+	for (std::size_t i = 0; i < source.size(); ++i) {
+		REQUIRE(linear[i].r == ez::color::decodeSRGB(source[i].r));
+		REQUIRE(linear[i].g == ez::color::decodeSRGB(source[i].g));
+		REQUIRE(linear[i].b == ez::color::decodeSRGB(source[i].b));
+		REQUIRE(linear[i].a == Approx(float(source[i].a) / 255.f));
+	}
+
+	std::vector<ez::ColorU> encoded(source.size());
+	ez::color::linearToSRGB(linear.data(), encoded.data(), linear.size());
+	REQUIRE(encoded == source);
+
+	// Ignore leaves the destination alpha alone
+	std::vector<ez::ColorU> opaque(source.size(), ez::ColorU{ 0, 0, 0, 7 });
+	ez::color::linearToSRGB(linear.data(), opaque.data(), linear.size(), ez::color::AlphaMode::Ignore);
+	for (std::size_t i = 0; i < source.size(); ++i) {
+		REQUIRE(opaque[i] == ez::ColorU{ source[i].r, source[i].g, source[i].b, 7 });
+	}
+
+	std::vector<ez::ColorF> keep(source.size(), ez::ColorF{ 0.f, 0.f, 0.f, 0.5f });
+	ez::color::srgbToLinear(source.data(), keep.data(), source.size(), ez::color::AlphaMode::Ignore);
+	for (std::size_t i = 0; i < source.size(); ++i) {
+		REQUIRE(keep[i].a == 0.5f);
+	}
+
+	// Out of range values clamp the same way as encodeSRGB, the odd count leaves a partial block
+	std::vector<ez::ColorF> wild{
+		{ NAN, -1.f, 2.f, 0.5f }, { 1e-30f, 1.f, INFINITY, -INFINITY }, { -0.f, 0.5f, 0.99999994f, NAN },
+		{ 0.25f, -INFINITY, 1e30f, 1.f }, { 0.75f, 1e-4f, 1.5f, 0.f },
+	};
+	std::vector<ez::ColorU> clamped(wild.size());
+	ez::color::linearToSRGB(wild.data(), clamped.data(), wild.size());
+	for (std::size_t i = 0; i < wild.size(); ++i) {
+		REQUIRE(clamped[i].r == ez::color::encodeSRGB(wild[i].r));
+		REQUIRE(clamped[i].g == ez::color::encodeSRGB(wild[i].g));
+		REQUIRE(clamped[i].b == ez::color::encodeSRGB(wild[i].b));
+	}
+}
+
+TEST_CASE("bulk hsv conversion") {
+	std::vector<ez::ColorF> colors;
+	for (int r = 0; r < 8; ++r) {
+		for (int g = 0; g < 8; ++g) {
+			for (int b = 0; b < 8; ++b) {
+				// Skip the grays, glm produces NaN hues for them
+				if (r == g && g == b) {
+					continue;
+				}
+				colors.push_back(ez::ColorF{ r / 7.f, g / 7.f, b / 7.f, r / 14.f });
+			}
+		}
+	}
+
+	std::vector<glm::vec4> hsv(colors.size());
+	ez::color::rgbToHsv(colors.data(), hsv.data(), colors.size());
+
+	std::vector<ez::ColorF> rgb(colors.size());
+	ez::color::hsvToRgb(hsv.data(), rgb.data(), colors.size());
+
+	for (std::size_t i = 0; i < colors.size(); ++i) {
+		glm::vec4 expected = ez::ColorF::toHSVA(colors[i]);
+		REQUIRE(hsv[i].x == Approx(expected.x).margin(1E-3));
+		REQUIRE(hsv[i].y == Approx(expected.y).margin(1E-5));
+		REQUIRE(hsv[i].z == Approx(expected.z).margin(1E-5));
+		REQUIRE(hsv[i].w == colors[i].a);
+
+		ez::ColorF scalar = ez::ColorF::fromHSVA(expected);
+		REQUIRE(rgb[i].r == Approx(scalar.r).margin(1E-5));
+		REQUIRE(rgb[i].g == Approx(scalar.g).margin(1E-5));
+		REQUIRE(rgb[i].b == Approx(scalar.b).margin(1E-5));
+		REQUIRE(rgb[i].a == colors[i].a);
+	}
+
+	// Structure of arrays, in place
+	std::vector<float> r, g, b;
+	for (const ez::ColorF& color : colors) {
+		r.push_back(color.r);
+		g.push_back(color.g);
+		b.push_back(color.b);
+	}
+	ez::color::rgbToHsv(r.data(), g.data(), b.data(), r.data(), g.data(), b.data(), r.size());
+	for (std::size_t i = 0; i < colors.size(); ++i) {
+		REQUIRE(r[i] == hsv[i].x);
+		REQUIRE(g[i] == hsv[i].y);
+		REQUIRE(b[i] == hsv[i].z);
+	}
+	ez::color::hsvToRgb(r.data(), g.data(), b.data(), r.data(), g.data(), b.data(), r.size());
+	for (std::size_t i = 0; i < colors.size(); ++i) {
+		REQUIRE(r[i] == Approx(colors[i].r).margin(1E-5));
+		REQUIRE(g[i] == Approx(colors[i].g).margin(1E-5));
+		REQUIRE(b[i] == Approx(colors[i].b).margin(1E-5));
+	}
+
+	// Grays are well defined
+	ez::ColorF gray{ 0.5f };
+	glm::vec4 grayHsv;
+	ez::color::rgbToHsv(&gray, &grayHsv, 1);
+	REQUIRE(grayHsv == glm::vec4{ 0.f, 0.f, 0.5f, 1.f });
+}
+
+TEST_CASE("bulk hsl conversion") {
+	ez::ColorF colors[] = {
+		{ 1.f, 0.f, 0.f },
+		{ 0.f, 0.5f, 0.f },
+		{ 0.5f, 0.5f, 1.f },
+		{ 0.75f, 0.75f, 0.75f },
+		{ 0.2f, 0.4f, 0.3f, 0.25f },
+	};
+	glm::vec4 expected[] = {
+		{ 0.f, 1.f, 0.5f, 1.f },
+		{ 120.f, 1.f, 0.25f, 1.f },
+		{ 240.f, 1.f, 0.75f, 1.f },
+		{ 0.f, 0.f, 0.75f, 1.f },
+		{ 150.f, 1.f / 3.f, 0.3f, 0.25f },
+	};
+
+	glm::vec4 hsl[5];
+	ez::color::rgbToHsl(colors, hsl, 5);
+
+	ez::ColorF rgb[5];
+	ez::color::hslToRgb(hsl, rgb, 5);
+
+	for (int i = 0; i < 5; ++i) {
+		for (int k = 0; k < 4; ++k) {
+			REQUIRE(hsl[i][k] == Approx(expected[i][k]).margin(1E-5));
+			REQUIRE(rgb[i][k] == Approx(colors[i][k]).margin(1E-5));
+		}
+	}
+}
@@ -0,0 +1,103 @@
+#include <catch2/catch_all.hpp>
+
+#include <vector>
+#include <random>
+#include <complex>
+
+#include <ez/math/complex_array.hpp>
+
+using Approx = Catch::Approx;
+
+template<typename T>
+static std::vector<glm::tcomplex<T>> randomComplex(std::size_t count, unsigned seed) {
+	std::mt19937 gen{ seed };
+	std::uniform_real_distribution<T> dist{ T(-10), T(10) };
+
+	std::vector<glm::tcomplex<T>> values;
+	for (std::size_t i = 0; i < count; ++i) {
+		values.emplace_back(dist(gen), dist(gen));
+	}
+	return values;
+}
+
+TEMPLATE_TEST_CASE("complex array", "", float, double) {
+	using T = TestType;
+	using complex_t = glm::tcomplex<T>;
+	T eps = std::numeric_limits<T>::epsilon() * T(16);
+
+	// An odd size, so the loops have a remainder
+	std::size_t count = 1003;
+	std::vector<complex_t> lh = randomComplex<T>(count, 1), rh = randomComplex<T>(count, 2);
+	lh[0] = complex_t{ 0, 0 };
+
+	ez::ComplexArray<T> a{ lh.data(), count }, b{ rh.data(), count };
+	REQUIRE(a.size() == count);
+	REQUIRE(a[5] == lh[5]);
+
+	SECTION("interleaved round trip") {
+		std::vector<complex_t> copy(count);
+		a.copyTo(copy.data());
+		REQUIRE(copy == lh);
+	}
+	SECTION("multiply") {
+		ez::ComplexArray<T> product, correlation;
+		ez::complex::multiply(a, b, product);
+		ez::complex::multiplyConjugate(a, b, correlation);
+		REQUIRE(product.size() == count);
+
+		for (std::size_t i = 0; i < count; ++i) {
+			complex_t expected = lh[i] * rh[i];
+			REQUIRE(product[i].real() == Approx(expected.real()).margin(eps * T(100)).epsilon(0));
+			REQUIRE(product[i].imag() == Approx(expected.imag()).margin(eps * T(100)).epsilon(0));
+
+			expected = lh[i] * std::conj(rh[i]);
+			REQUIRE(correlation[i].real() == Approx(expected.real()).margin(eps * T(100)).epsilon(0));
+			REQUIRE(correlation[i].imag() == Approx(expected.imag()).margin(eps * T(100)).epsilon(0));
+		}
+
+		// In place
+		ez::complex::multiply(a, b, a);
+		REQUIRE(a[7] == product[7]);
+	}
+	SECTION("normalize, abs and arg") {
+		std::vector<T> magnitude(count), angle(count);
+		ez::complex::abs(a, magnitude.data());
+		ez::complex::arg(a, angle.data());
+
+		ez::ComplexArray<T> unit;
+		ez::complex::normalize(a, unit);
+		REQUIRE(unit[0] == complex_t{ 0, 0 });
+
+		for (std::size_t i = 1; i < count; ++i) {
+			REQUIRE(magnitude[i] == Approx(std::abs(lh[i])).epsilon(eps));
+			REQUIRE(angle[i] == Approx(std::arg(lh[i])).margin(eps * T(4)).epsilon(0));
+			REQUIRE(std::abs(unit[i]) == Approx(T(1)).epsilon(eps));
+			REQUIRE(std::arg(unit[i]) == Approx(std::arg(lh[i])).margin(eps * T(4)).epsilon(0));
+		}
+
+		// Tiny magnitudes, where the squared length underflows, and huge ones, where it overflows
+		std::vector<complex_t> extreme{
+			{ T(1E-23), T(0) }, { T(0), T(-1E-30) }, { T(3E-22), T(4E-22) }, { std::numeric_limits<T>::denorm_min(), T(0) },
+			{ -std::numeric_limits<T>::denorm_min(), std::numeric_limits<T>::denorm_min() }, { std::numeric_limits<T>::max(), std::numeric_limits<T>::max() },
+		};
+		ez::ComplexArray<T> scaled{ extreme.data(), extreme.size() };
+		ez::complex::normalize(scaled, scaled);
+		for (std::size_t i = 0; i < extreme.size(); ++i) {
+			// The magnitude of the subnormal values rounds, so the expected direction comes from the angle
+			complex_t expected = std::polar(T(1), std::arg(extreme[i]));
+			REQUIRE(scaled[i].real() == Approx(expected.real()).margin(eps).epsilon(0));
+			REQUIRE(scaled[i].imag() == Approx(expected.imag()).margin(eps).epsilon(0));
+		}
+	}
+	SECTION("rotate") {
+		T theta = T(0.75);
+		ez::ComplexArray<T> rotated;
+		ez::complex::rotate(a, theta, rotated);
+
+		for (std::size_t i = 0; i < count; ++i) {
+			complex_t expected = lh[i] * std::polar(T(1), theta);
+			REQUIRE(rotated[i].real() == Approx(expected.real()).margin(eps * T(100)).epsilon(0));
+			REQUIRE(rotated[i].imag() == Approx(expected.imag()).margin(eps * T(100)).epsilon(0));
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,170 @@
+#include <catch2/catch_all.hpp>
+
+#include <vector>
+#include <cmath>
+#include <fmt/core.h>
+
+#include <ez/math/distribution.hpp>
+
+using Approx = Catch::Approx;
+
+template<typename T>
+static void requireMoments(const std::vector<T>& values, double mean, double variance) {
+	double sum = 0.0, squares = 0.0;
+	for (T value : values) {
+		sum += value;
+		squares += double(value) * value;
+	}
+	double m = sum / double(values.size());
+	double v = squares / double(values.size()) - m * m;
+
+	REQUIRE(m == Approx(mean).margin(0.01));
+	REQUIRE(v == Approx(variance).margin(0.02));
+}
+
+TEST_CASE("deterministic math") {
+	for (double x = -20.0; x < 20.0; x += 0.37) {
+		REQUIRE(ez::prng::intern::exactExp(x) == Approx(std::exp(x)).epsilon(1e-14));
+	}
+	for (double x = 1e-10; x < 1e10; x *= 3.7) {
+		REQUIRE(ez::prng::intern::exactLog(x) == Approx(std::log(x)).epsilon(1e-14).margin(1e-15));
+	}
+
+	// The ziggurat layers must close up at the top
+	const auto& normal = ez::prng::intern::normalZiggurat;
+	REQUIRE(normal.x[255] == Approx(0.2152418959132738).epsilon(1e-10));
+	REQUIRE(normal.x[255] * (1.0 - normal.f[255]) == Approx(0.00492867323399).epsilon(1e-6));
+
+	const auto& exponential = ez::prng::intern::exponentialZiggurat;
+	REQUIRE(exponential.x[255] == Approx(0.06385216381500157).epsilon(1e-10));
+}
+
+TEST_CASE("bounded integers") {
+	ez::prng::Xoshiro256ss gen{ 3 };
+
+	int histogram[7] = {};
+	for (int i = 0; i < 70000; ++i) {
+		std::uint32_t value = ez::prng::bounded(gen, 7);
+		REQUIRE(value < 7);
+		++histogram[value];
+	}
+	for (int count : histogram) {
+		REQUIRE(count == Approx(10000).margin(500));
+	}
+
+	REQUIRE(ez::prng::bounded(gen, 0) == 0);
+	REQUIRE(ez::prng::bounded(gen, 1) == 0);
+	for (int i = 0; i < 1000; ++i) {
+		REQUIRE(ez::prng::bounded64(gen, 0x100000001ull) < 0x100000001ull);
+	}
+
+	bool seen[5] = {};
+	for (int i = 0; i < 1000; ++i) {
+		int value = ez::prng::uniformInt(gen, -2, 2);
+		REQUIRE(value >= -2);
+		REQUIRE(value <= 2);
+		seen[value + 2] = true;
+	}
+	for (bool s : seen) {
+		REQUIRE(s);
+	}
+
+	// Full range
+	ez::prng::uniformInt(gen, std::int64_t(INT64_MIN), std::int64_t(INT64_MAX));
+	REQUIRE(ez::prng::uniformInt(gen, std::uint8_t(0), std::uint8_t(255)) <= 255);
+
+	// The batch version produces the same values, as long as no value had to be drawn again
+	ez::prng::SplitMix64 lh{ 9 }, rh{ 9 };
+	std::vector<std::uint32_t> filled(1000);
+	ez::prng::fillBounded(lh, filled.data(), filled.size(), 1000);
+	for (std::uint32_t value : filled) {
+		REQUIRE(value == ez::prng::bounded(rh, 1000));
+	}
+}
+
+TEST_CASE("uniform floats") {
+	ez::prng::Pcg32 gen{ 7 };
+
+	std::vector<float> floats(100000);
+	for (float& value : floats) {
+		value = ez::prng::uniformFloat(gen);
+		REQUIRE(value >= 0.f);
+		REQUIRE(value < 1.f);
+	}
+	requireMoments(floats, 0.5, 1.0 / 12.0);
+
+	std::vector<double> doubles(100000);
+	for (double& value : doubles) {
+		value = ez::prng::uniform(gen, -1.0, 3.0);
+		REQUIRE(value >= -1.0);
+		REQUIRE(value < 3.0);
+	}
+	requireMoments(doubles, 1.0, 16.0 / 12.0);
+
+	// Extremes of the bit patterns
+	REQUIRE(ez::prng::intern::bitsToFloat(0) == 0.f);
+	REQUIRE(ez::prng::intern::bitsToFloat(~0u) < 1.f);
+	REQUIRE(ez::prng::intern::bitsToDouble(~0ull) < 1.0);
+
+	// Batch versions match the scalar ones
+	ez::prng::Pcg32 lh{ 1 }, rh{ 1 };
+	std::vector<float> batchFloats(1000);
+	std::vector<double> batchDoubles(1000);
+	ez::prng::fillUniform(lh, batchFloats.data(), batchFloats.size());
+	ez::prng::fillUniform(lh, batchDoubles.data(), batchDoubles.size());
+	for (float value : batchFloats) {
+		REQUIRE(value == ez::prng::uniformFloat(rh));
+	}
+	for (double value : batchDoubles) {
+		REQUIRE(value == ez::prng::uniformDouble(rh));
+	}
+}
+
+TEST_CASE("normal distribution") {
+	ez::prng::Xoshiro256ss gen{ 5 };
+
+	std::vector<double> values(200000);
+	int within = 0, tail = 0;
+	for (double& value : values) {
+		value = ez::prng::normal(gen);
+		within += std::abs(value) < 1.0 ? 1 : 0;
+		tail += std::abs(value) > 3.6541528853610088 ? 1 : 0;
+	}
+	requireMoments(values, 0.0, 1.0);
+	REQUIRE(double(within) / double(values.size()) == Approx(0.682689).margin(0.005));
+	// P(|x| > r) is about 2.6e-4
+	REQUIRE(tail > 20);
+	REQUIRE(tail < 100);
+
+	std::vector<float> batch(200000);
+	ez::prng::fillNormal(gen, batch.data(), batch.size());
+	requireMoments(batch, 0.0, 1.0);
+
+	ez::prng::Pcg32 narrow{ 5 };
+	std::vector<double> narrowBatch(100003);
+	ez::prng::fillNormal(narrow, narrowBatch.data(), narrowBatch.size());
+	requireMoments(narrowBatch, 0.0, 1.0);
+
+	REQUIRE(ez::prng::normal(gen, 10.0, 0.0) == 10.0);
+}
+
+TEST_CASE("exponential distribution") {
+	ez::prng::Xoroshiro128p gen{ 5 };
+
+	std::vector<double> values(200000);
+	for (double& value : values) {
+		value = ez::prng::exponential(gen);
+		REQUIRE(value >= 0.0);
+	}
+	requireMoments(values, 1.0, 1.0);
+
+	std::vector<double> batch(200000);
+	ez::prng::fillExponential(gen, batch.data(), batch.size());
+	requireMoments(batch, 1.0, 1.0);
+
+	double rate = 0.0;
+	for (int i = 0; i < 10000; ++i) {
+		rate += ez::prng::exponential(gen, 4.0);
+	}
+	REQUIRE(rate / 10000.0 == Approx(0.25).margin(0.01));
+}
\ No newline at end of file
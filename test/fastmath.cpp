@@ -0,0 +1,204 @@
+#include <catch2/catch_all.hpp>
+
+#include <vector>
+#include <cmath>
+#include <limits>
+
+#include <ez/math/fastmath.hpp>
+#include "fastmath_inputs.hpp"
+
+using Approx = Catch::Approx;
+using ez::fastmath::Precision;
+
+static double tolerance(Precision p) {
+	switch (p) {
+	case Precision::Low:
+		return 1e-3;
+	case Precision::Medium:
+		return 1e-5;
+	default:
+		return 1e-6;
+	}
+}
+
+template<Precision P>
+static void checkTier() {
+	const double tol = tolerance(P);
+	double worst = 0.0;
+
+	std::vector<float> angles = uniformFloats(20000, -100.f, 100.f, 1);
+	for (float x : angles) {
+		float s = 0.f, c = 0.f;
+		ez::fastmath::sincos<P>(x, s, c);
+		worst = std::max(worst, std::abs(double(ez::fastmath::sin<P>(x)) - std::sin(double(x))));
+		worst = std::max(worst, std::abs(double(ez::fastmath::cos<P>(x)) - std::cos(double(x))));
+		REQUIRE(s == ez::fastmath::sin<P>(x));
+		REQUIRE(c == ez::fastmath::cos<P>(x));
+	}
+	REQUIRE(worst <= tol);
+
+	worst = 0.0;
+	std::vector<float> ys = uniformFloats(20000, -10.f, 10.f, 2);
+	std::vector<float> xs = uniformFloats(20000, -10.f, 10.f, 3);
+	for (std::size_t i = 0; i < xs.size(); ++i) {
+		worst = std::max(worst, std::abs(double(ez::fastmath::atan2<P>(ys[i], xs[i])) - std::atan2(double(ys[i]), double(xs[i]))));
+	}
+	REQUIRE(worst <= tol * 2.0);
+
+	worst = 0.0;
+	for (float x : uniformFloats(20000, -87.f, 88.f, 4)) {
+		double expected = std::exp(double(x));
+		worst = std::max(worst, std::abs(double(ez::fastmath::exp<P>(x)) - expected) / expected);
+	}
+	REQUIRE(worst <= tol);
+
+	worst = 0.0;
+	for (float x : logUniformFloats(20000, 1e-30f, 1e30f, 5)) {
+		double expected = std::log(double(x));
+		worst = std::max(worst, std::abs(double(ez::fastmath::log<P>(x)) - expected) / std::max(1.0, std::abs(expected)));
+	}
+	REQUIRE(worst <= tol);
+
+	worst = 0.0;
+	std::vector<float> bases = logUniformFloats(20000, 1e-3f, 1e3f, 6);
+	std::vector<float> powers = uniformFloats(20000, -8.f, 8.f, 7);
+	for (std::size_t i = 0; i < bases.size(); ++i) {
+		double expected = std::pow(double(bases[i]), double(powers[i]));
+		worst = std::max(worst, std::abs(double(ez::fastmath::pow<P>(bases[i], powers[i])) - expected) / expected);
+	}
+	REQUIRE(worst <= tol * (P == Precision::Full ? 1.0 : 64.0));
+}
+
+TEST_CASE("fastmath accuracy") {
+	checkTier<Precision::Low>();
+	checkTier<Precision::Medium>();
+	checkTier<Precision::Full>();
+
+	// Double arguments get the same tiers
+	for (double x = -50.0; x < 50.0; x += 0.013) {
+		REQUIRE(ez::fastmath::sin(x) == Approx(std::sin(x)).margin(1e-7));
+		REQUIRE(ez::fastmath::exp(x) == Approx(std::exp(x)).epsilon(1e-7));
+		REQUIRE(ez::fastmath::log(x + 50.001) == Approx(std::log(x + 50.001)).epsilon(1e-7));
+	}
+}
+
+TEST_CASE("fastmath special values") {
+	constexpr float inf = std::numeric_limits<float>::infinity();
+
+	// Usable in constant expressions
+	constexpr float s = ez::fastmath::sin(0.5f);
+	constexpr float a = ez::fastmath::atan2(1.f, -1.f);
+	static_assert(ez::fastmath::sin(0.f) == 0.f);
+	static_assert(ez::fastmath::cos(0.0) == 1.0);
+	REQUIRE(s == Approx(std::sin(0.5f)).margin(1e-6));
+	REQUIRE(a == Approx(3.f * std::atan(1.f)).margin(1e-6));
+
+	REQUIRE(ez::fastmath::atan2(0.f, 0.f) == 0.f);
+	REQUIRE(ez::fastmath::atan2(0.f, -1.f) == Approx(std::acos(-1.f)));
+	REQUIRE(ez::fastmath::atan2(-1.f, 0.f) == Approx(-std::acos(0.f)));
+
+	// Huge arguments have no precision left after the reduction, and count as zero
+	static_assert(ez::fastmath::sin(1e30f) == 0.f);
+	REQUIRE(ez::fastmath::sin<Precision::Low>(-3e38f) == 0.f);
+	REQUIRE(ez::fastmath::cos(1e9f) == 1.f);
+	REQUIRE(ez::fastmath::sin(1e300) == 0.0);
+	REQUIRE(ez::fastmath::cos(-1e18) == 1.0);
+	REQUIRE(ez::fastmath::sin(1e5f) == Approx(std::sin(1e5)).margin(1e-5));
+#if !defined(__FAST_MATH__)
+	// Infinities and nan give nan, in the arrays as well
+	float special[] = { inf, -inf, std::nanf("") };
+	float sines[3], cosines[3];
+	ez::fastmath::sincos(special, sines, cosines, 3);
+	for (int i = 0; i < 3; ++i) {
+		REQUIRE(std::isnan(ez::fastmath::sin(special[i])));
+		REQUIRE(std::isnan(ez::fastmath::cos<Precision::Medium>(special[i])));
+		REQUIRE(std::isnan(sines[i]));
+		REQUIRE(std::isnan(cosines[i]));
+	}
+	REQUIRE(std::isnan(ez::fastmath::sin(std::numeric_limits<double>::infinity())));
+	REQUIRE(std::isnan(ez::fastmath::cos(std::nan(""))));
+#endif
+
+	REQUIRE(ez::fastmath::exp(0.f) == 1.f);
+	REQUIRE(ez::fastmath::exp(100.f) == inf);
+	REQUIRE(ez::fastmath::exp(inf) == inf);
+	REQUIRE(ez::fastmath::exp(-inf) == 0.f);
+	REQUIRE(ez::fastmath::exp(-100.f) == Approx(std::exp(-100.f)).epsilon(1e-5));
+#if !defined(__FAST_MATH__)
+	// Fast math assumes there is no nan input
+	REQUIRE(std::isnan(ez::fastmath::exp(std::nanf(""))));
+	REQUIRE(std::isnan(ez::fastmath::exp(std::nan(""))));
+	float exponents[] = { std::nanf(""), 1.f, inf };
+	ez::fastmath::exp(exponents, exponents, 3);
+	REQUIRE(std::isnan(exponents[0]));
+	REQUIRE(exponents[1] == Approx(std::exp(1.f)).epsilon(1e-6));
+	REQUIRE(exponents[2] == inf);
+#endif
+
+	REQUIRE(ez::fastmath::log(1.f) == 0.f);
+	REQUIRE(ez::fastmath::log(0.f) == -inf);
+	REQUIRE(ez::fastmath::log(inf) == inf);
+#if !defined(__FAST_MATH__)
+	REQUIRE(std::isnan(ez::fastmath::log(-1.f)));
+#endif
+	REQUIRE(ez::fastmath::log(1e-40f) == Approx(std::log(1e-40f)).epsilon(1e-6));
+	REQUIRE(ez::fastmath::log(std::numeric_limits<double>::denorm_min()) == Approx(std::log(std::numeric_limits<double>::denorm_min())).epsilon(1e-7));
+
+	REQUIRE(ez::fastmath::pow(0.f, 0.f) == 1.f);
+	REQUIRE(ez::fastmath::pow(0.f, 2.f) == 0.f);
+	REQUIRE(ez::fastmath::pow(2.f, 10.f) == Approx(1024.f).epsilon(1e-6));
+#if !defined(__FAST_MATH__)
+	REQUIRE(std::isnan(ez::fastmath::pow(-2.f, 2.f)));
+#endif
+}
+
+// The arrays give the same values as the scalar functions. Fast math may contract the vectorized loops differently, so allow for rounding there.
+static bool same(float lhs, float rhs) {
+#if defined(__FAST_MATH__)
+	return lhs == Approx(rhs).epsilon(1e-6);
+#else
+	return lhs == rhs;
+#endif
+}
+
+TEST_CASE("fastmath arrays") {
+	std::vector<float> x = uniformFloats(1000, -20.f, 20.f, 8);
+	std::vector<float> y = uniformFloats(1000, -20.f, 20.f, 9);
+	std::vector<float> positive = logUniformFloats(1000, 1e-20f, 1e20f, 10);
+	std::vector<float> out(x.size()), out2(x.size());
+
+	ez::fastmath::sin<Precision::Medium>(x.data(), out.data(), x.size());
+	for (std::size_t i = 0; i < x.size(); ++i) {
+		REQUIRE(same(out[i], ez::fastmath::sin<Precision::Medium>(x[i])));
+	}
+	ez::fastmath::cos(x.data(), out.data(), x.size());
+	for (std::size_t i = 0; i < x.size(); ++i) {
+		REQUIRE(same(out[i], ez::fastmath::cos(x[i])));
+	}
+	ez::fastmath::sincos<Precision::Low>(x.data(), out.data(), out2.data(), x.size());
+	for (std::size_t i = 0; i < x.size(); ++i) {
+		REQUIRE(same(out[i], ez::fastmath::sin<Precision::Low>(x[i])));
+		REQUIRE(same(out2[i], ez::fastmath::cos<Precision::Low>(x[i])));
+	}
+	ez::fastmath::atan2(y.data(), x.data(), out.data(), x.size());
+	for (std::size_t i = 0; i < x.size(); ++i) {
+		REQUIRE(same(out[i], ez::fastmath::atan2(y[i], x[i])));
+	}
+	ez::fastmath::exp(x.data(), out.data(), x.size());
+	for (std::size_t i = 0; i < x.size(); ++i) {
+		REQUIRE(same(out[i], ez::fastmath::exp(x[i])));
+	}
+	ez::fastmath::log(positive.data(), out.data(), x.size());
+	for (std::size_t i = 0; i < x.size(); ++i) {
+		REQUIRE(same(out[i], ez::fastmath::log(positive[i])));
+	}
+
+	// The array version splits the work into passes, which gives the same values
+	std::vector<float> bases = logUniformFloats(1000, 1e-2f, 1e2f, 11);
+	y[3] = 0.f;
+	ez::fastmath::pow(bases.data(), y.data(), out.data(), x.size());
+	for (std::size_t i = 0; i < x.size(); ++i) {
+		REQUIRE(same(out[i], ez::fastmath::pow(bases[i], y[i])));
+	}
+	REQUIRE(out[3] == 1.f);
+}
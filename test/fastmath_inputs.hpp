@@ -0,0 +1,25 @@
+#pragma once
+#include <vector>
+#include <cmath>
+#include <random>
+
+// Input generators shared by the fastmath tests and benchmarks
+
+inline std::vector<float> uniformFloats(std::size_t count, float lo, float hi, unsigned seed) {
+	std::mt19937 gen{ seed };
+	std::uniform_real_distribution<float> dist{ lo, hi };
+	std::vector<float> values(count);
+	for (float& value : values) {
+		value = dist(gen);
+	}
+	return values;
+}
+
+// Log uniform positive values, spanning many binades
+inline std::vector<float> logUniformFloats(std::size_t count, float lo, float hi, unsigned seed) {
+	std::vector<float> values = uniformFloats(count, std::log(lo), std::log(hi), seed);
+	for (float& value : values) {
+		value = std::exp(value);
+	}
+	return values;
+}
@@ -0,0 +1,167 @@
+#include <catch2/catch_all.hpp>
+
+#include <vector>
+#include <random>
+#include <complex>
+#include <cmath>
+
+#include <ez/math/fft.hpp>
+
+using Approx = Catch::Approx;
+
+template<typename T>
+static std::vector<glm::tcomplex<T>> randomSignal(std::size_t count, unsigned seed) {
+	std::mt19937 gen{ seed };
+	std::uniform_real_distribution<T> dist{ T(-1), T(1) };
+
+	std::vector<glm::tcomplex<T>> values;
+	for (std::size_t i = 0; i < count; ++i) {
+		values.emplace_back(dist(gen), dist(gen));
+	}
+	return values;
+}
+
+// The direct O(n^2) transform, in long double
+template<typename T>
+static std::vector<std::complex<long double>> naiveTransform(const std::vector<glm::tcomplex<T>>& in) {
+	std::size_t n = in.size();
+	std::vector<std::complex<long double>> out(n);
+	for (std::size_t k = 0; k < n; ++k) {
+		std::complex<long double> sum{ 0, 0 };
+		for (std::size_t j = 0; j < n; ++j) {
+			long double angle = -ez::tau<long double>() * (long double)((j * k) % n) / (long double)n;
+			sum += std::complex<long double>(in[j].real(), in[j].imag()) * std::polar(1.0L, angle);
+		}
+		out[k] = sum;
+	}
+	return out;
+}
+
+// The largest error relative to the largest value
+template<typename T>
+static long double relativeError(const std::vector<std::complex<long double>>& expected, const glm::tcomplex<T>* actual) {
+	long double error = 0, largest = 0;
+	for (std::size_t i = 0; i < expected.size(); ++i) {
+		std::complex<long double> value{ actual[i].real(), actual[i].imag() };
+		error = std::max(error, std::abs(value - expected[i]));
+		largest = std::max(largest, std::abs(expected[i]));
+	}
+	return error / std::max(largest, 1.0L);
+}
+
+TEMPLATE_TEST_CASE("fft complex", "", float, double) {
+	using T = TestType;
+	using complex_t = glm::tcomplex<T>;
+	long double tolerance = std::numeric_limits<T>::epsilon() * 32;
+
+	std::vector<std::size_t> sizes;
+	for (std::size_t n = 1; n <= 40; ++n) {
+		sizes.push_back(n);
+	}
+	for (std::size_t n : { 64, 100, 128, 243, 256, 512, 1000, 1024, 2048, 4096, 4099 }) {
+		sizes.push_back(n);
+	}
+
+	for (std::size_t n : sizes) {
+		INFO("size " << n);
+		std::vector<complex_t> signal = randomSignal<T>(n, unsigned(n));
+		std::vector<std::complex<long double>> expected = naiveTransform(signal);
+
+		ez::fft::Plan<T> plan{ n };
+		REQUIRE(plan.size() == n);
+
+		std::vector<complex_t> spectrum(n), restored(n);
+		plan.forward(signal.data(), spectrum.data());
+		REQUIRE(relativeError(expected, spectrum.data()) < tolerance);
+
+		plan.inverse(spectrum.data(), restored.data());
+		std::vector<std::complex<long double>> original(signal.begin(), signal.end());
+		REQUIRE(relativeError(original, restored.data()) < tolerance);
+
+		// Split arrays, in place and out of place give the same result
+		ez::ComplexArray<T> split{ signal.data(), n }, out;
+		plan.forward(split, out);
+		plan.forward(split.real(), split.imag(), split.real(), split.imag());
+		for (std::size_t i = 0; i < n; ++i) {
+			REQUIRE(out[i] == spectrum[i]);
+			REQUIRE(split[i] == spectrum[i]);
+		}
+	}
+}
+
+TEMPLATE_TEST_CASE("fft real", "", float, double) {
+	using T = TestType;
+	using complex_t = glm::tcomplex<T>;
+	long double tolerance = std::numeric_limits<T>::epsilon() * 32;
+
+	for (std::size_t n : { 1, 2, 3, 4, 6, 7, 8, 15, 16, 30, 64, 90, 256, 1000, 1024 }) {
+		INFO("size " << n);
+		std::vector<complex_t> signal = randomSignal<T>(n, unsigned(n) + 7);
+		std::vector<T> samples;
+		for (complex_t& value : signal) {
+			value.imag(T(0));
+			samples.push_back(value.real());
+		}
+		std::vector<std::complex<long double>> expected = naiveTransform(signal);
+
+		ez::fft::RealPlan<T> plan{ n };
+		REQUIRE(plan.bins() == n / 2 + 1);
+
+		std::vector<complex_t> spectrum(plan.bins());
+		plan.forward(samples.data(), spectrum.data());
+		expected.resize(plan.bins());
+		REQUIRE(relativeError(expected, spectrum.data()) < tolerance);
+
+		std::vector<T> restored(n);
+		plan.inverse(spectrum.data(), restored.data());
+		for (std::size_t i = 0; i < n; ++i) {
+			REQUIRE(restored[i] == Approx(samples[i]).margin(tolerance * 4));
+		}
+	}
+}
+
+TEST_CASE("fft 2d") {
+	using complex_t = glm::dcomplex;
+	std::size_t width = 24, height = 16;
+	std::vector<complex_t> signal = randomSignal<double>(width * height, 3);
+
+	// Separable, so transform the rows and then the columns directly
+	std::vector<std::complex<long double>> expected(signal.begin(), signal.end());
+	for (std::size_t y = 0; y < height; ++y) {
+		std::vector<complex_t> row(signal.begin() + y * width, signal.begin() + (y + 1) * width);
+		std::vector<std::complex<long double>> result = naiveTransform(row);
+		std::copy(result.begin(), result.end(), expected.begin() + y * width);
+	}
+	for (std::size_t x = 0; x < width; ++x) {
+		std::vector<complex_t> column;
+		for (std::size_t y = 0; y < height; ++y) {
+			column.push_back(complex_t(double(expected[y * width + x].real()), double(expected[y * width + x].imag())));
+		}
+		std::vector<std::complex<long double>> result = naiveTransform(column);
+		for (std::size_t y = 0; y < height; ++y) {
+			expected[y * width + x] = result[y];
+		}
+	}
+
+	ez::ComplexArray<double> data{ signal.data(), signal.size() }, threaded = data;
+	ez::fft::Plan2D<double> plan{ width, height };
+	plan.forward(data);
+
+	std::vector<complex_t> spectrum(signal.size());
+	data.copyTo(spectrum.data());
+	REQUIRE(relativeError(expected, spectrum.data()) < 1e-13);
+
+	// Threads give exactly the same result
+	ez::fft::Plan2D<double> parallel{ width, height, 3 };
+	REQUIRE(parallel.threads() == 3);
+	parallel.forward(threaded);
+	for (std::size_t i = 0; i < signal.size(); ++i) {
+		REQUIRE(threaded[i] == data[i]);
+	}
+
+	parallel.inverse(threaded);
+	for (std::size_t i = 0; i < signal.size(); ++i) {
+		REQUIRE(threaded[i].real() == Approx(signal[i].real()).margin(1e-14));
+		REQUIRE(threaded[i].imag() == Approx(signal[i].imag()).margin(1e-14));
+	}
+}
\ No newline at end of file
@@ -1,172 +1,168 @@
-#include <limits>
-#include <fmt/printf.h>
-#include <iostream>
-#include <ctime>
-
-#include <ez/math/complex.hpp>
-#include <ez/math/poly.hpp>
-#include <ez/math/constants.hpp>
-#include <ez/math/trig.hpp>
-#include <ez/math/prng.hpp>
-
-#include <ez/math/Trig.hpp>
-
-int hash_test() {
-	static constexpr char name0[] = "Ben";
-	static constexpr char name1[] = "Lenz";
-	static constexpr char name2[] = "Gachowski";
-	static constexpr char name3[] = "Jacob";
-
-	static constexpr wchar_t name4[] = L"Laura";
-	static constexpr wchar_t name5[] = L"Bryan";
-	static constexpr wchar_t name6[] = L"Helen";
-	
-	{ // 32bit Hashing
-	// Make sure the constexpr version of hash works:
-		static constexpr std::uint32_t constHash0 = ez::prng::djb2_32(name0);
-		static constexpr std::uint32_t constHash1 = ez::prng::djb2_32(name1);
-		static constexpr std::uint32_t constHash2 = ez::prng::djb2_32(name2);
-		static constexpr std::uint32_t constHash3 = ez::prng::djb2_32(name3);
-
-		std::uint32_t chash0 = constHash0;
-		std::uint32_t chash1 = constHash1;
-		std::uint32_t chash2 = constHash2;
-		std::uint32_t chash3 = constHash3;
-
-		std::uint32_t hash0 = ez::prng::djb2_32(name0, sizeof(name0)-1);
-		std::uint32_t hash1 = ez::prng::djb2_32(name1, sizeof(name1)-1);
-		std::uint32_t hash2 = ez::prng::djb2_32(name2, sizeof(name2)-1);
-		std::uint32_t hash3 = ez::prng::djb2_32(name3, sizeof(name3)-1);
-
-		if (chash0 != hash0) {
-			fmt::print("Incorrect hash value\n");
-			return -1;
-		}
-		if (chash1 != hash1) {
-			fmt::print("Incorrect hash value\n");
-			return -1;
-		}
-		if (chash2 != hash2) {
-			fmt::print("Incorrect hash value\n");
-			return -1;
-		}
-		if (chash3 != hash3) {
-			fmt::print("Incorrect hash value\n");
-			return -1;
-		}
+#include <catch2/catch_all.hpp>
 
-		std::uint32_t hash4 = ez::prng::djb2_32(name4, sizeof(name4) / sizeof(wchar_t) - 1);
-		std::uint32_t hash5 = ez::prng::djb2_32(name5, sizeof(name5) / sizeof(wchar_t) - 1);
-		std::uint32_t hash6 = ez::prng::djb2_32(name6, sizeof(name6) / sizeof(wchar_t) - 1);
+#include <string>
+#include <string_view>
+#include <vector>
+#include <random>
+#include <fmt/core.h>
 
-		static constexpr std::uint32_t hash7 = ez::prng::djb2_32(name4);
-
-		std::wstring name7 = name4;
-
-		std::uint32_t hash8 = ez::prng::djb2_32(name7);
-
-		if (hash4 != hash7) {
-			fmt::print("Incorrect hash value\n");
-			return -1;
-		}
-		if (hash4 != hash8) {
-			fmt::print("Incorrect hash value\n");
-			return -1;
-		}
-
-		if (hash4 != ez::prng::djb2_32(std::wstring_view(name4, sizeof(name4) / sizeof(wchar_t) - 1))) {
-			fmt::print("Incorrect hash value\n");
-			return -1;
-		}
-
-		// Constexpr string_view test
-		static constexpr std::wstring_view cname4(name4, sizeof(name4) / sizeof(wchar_t) - 1);
-		static constexpr std::string_view cname5(name0, sizeof(name0) - 1);
+#include <ez/math/prng.hpp>
+#include <ez/math/hash.hpp>
 
-		static constexpr std::uint32_t constHash4 = ez::prng::djb2_32(cname4);
-		static constexpr std::uint32_t constHash5 = ez::prng::djb2_32(cname5);
+static constexpr char name0[] = "Ben";
+static constexpr char name1[] = "Lenz";
+static constexpr char name2[] = "Gachowski";
+static constexpr char name3[] = "Jacob";
 
-		std::uint32_t chash4 = constHash4;
-		std::uint32_t chash5 = constHash5;
+static constexpr wchar_t name4[] = L"Laura";
+static constexpr wchar_t name5[] = L"Bryan";
+static constexpr wchar_t name6[] = L"Helen";
 
-		if (hash4 != chash4) {
-			fmt::print("Incorrect hash value\n");
-			return -1;
-		}
-		if (hash0 != chash5) {
-			fmt::print("Incorrect hash value\n");
-			return -1;
-		}
-	}
-	
-	{ // 64bit Hashing
+TEST_CASE("djb2 32 bit") {
 	// Make sure the constexpr version of hash works:
-		static constexpr std::uint64_t constHash0 = ez::prng::djb2_64(name0);
-		static constexpr std::uint64_t constHash1 = ez::prng::djb2_64(name1);
-		static constexpr std::uint64_t constHash2 = ez::prng::djb2_64(name2);
-		static constexpr std::uint64_t constHash3 = ez::prng::djb2_64(name3);
-
-		std::uint64_t hash0 = ez::prng::djb2_64(name0, sizeof(name0)-1);
-		std::uint64_t hash1 = ez::prng::djb2_64(name1, sizeof(name1)-1);
-		std::uint64_t hash2 = ez::prng::djb2_64(name2, sizeof(name2)-1);
-		std::uint64_t hash3 = ez::prng::djb2_64(name3, sizeof(name3)-1);
-		
-		if (constHash0 != hash0) {
-			fmt::print("Incorrect hash value\n");
-			return -1;
-		}
-		if (constHash1 != hash1) {
-			fmt::print("Incorrect hash value\n");
-			return -1;
-		}
-		if (constHash2 != hash2) {
-			fmt::print("Incorrect hash value\n");
-			return -1;
-		}
-		if (constHash3 != hash3) {
-			fmt::print("Incorrect hash value\n");
-			return -1;
-		}
-
-		static constexpr wchar_t name4[] = L"Laura";
-		static constexpr wchar_t name5[] = L"Bryan";
-		static constexpr wchar_t name6[] = L"Helen";
-
-		std::uint64_t hash4 = ez::prng::djb2_64(name4, sizeof(name4) / sizeof(wchar_t) - 1);
-		std::uint64_t hash5 = ez::prng::djb2_64(name5, sizeof(name5) / sizeof(wchar_t) - 1);
-		std::uint64_t hash6 = ez::prng::djb2_64(name6, sizeof(name6) / sizeof(wchar_t) - 1);
-
-		static constexpr std::uint64_t hash7 = ez::prng::djb2_64(name4);
+	static constexpr std::uint32_t constHash0 = ez::prng::djb2_32(name0);
+	static constexpr std::uint32_t constHash1 = ez::prng::djb2_32(name1);
+	static constexpr std::uint32_t constHash2 = ez::prng::djb2_32(name2);
+	static constexpr std::uint32_t constHash3 = ez::prng::djb2_32(name3);
+
+	std::uint32_t hash0 = ez::prng::djb2_32(name0, sizeof(name0) - 1);
+	std::uint32_t hash1 = ez::prng::djb2_32(name1, sizeof(name1) - 1);
+	std::uint32_t hash2 = ez::prng::djb2_32(name2, sizeof(name2) - 1);
+	std::uint32_t hash3 = ez::prng::djb2_32(name3, sizeof(name3) - 1);
+
+	REQUIRE(constHash0 == hash0);
+	REQUIRE(constHash1 == hash1);
+	REQUIRE(constHash2 == hash2);
+	REQUIRE(constHash3 == hash3);
+
+	// Reference value, ((5381 * 33 + 'B') * 33 + 'e') * 33 + 'n'
+	REQUIRE(hash0 == 193452314u);
+
+	std::uint32_t hash4 = ez::prng::djb2_32(name4, sizeof(name4) / sizeof(wchar_t) - 1);
+	std::uint32_t hash5 = ez::prng::djb2_32(name5, sizeof(name5) / sizeof(wchar_t) - 1);
+	std::uint32_t hash6 = ez::prng::djb2_32(name6, sizeof(name6) / sizeof(wchar_t) - 1);
+	REQUIRE(hash4 != hash5);
+	REQUIRE(hash5 != hash6);
+
+	static constexpr std::uint32_t hash7 = ez::prng::djb2_32(name4);
+	std::wstring name7 = name4;
+	std::uint32_t hash8 = ez::prng::djb2_32(name7);
+
+	REQUIRE(hash4 == hash7);
+	REQUIRE(hash4 == hash8);
+	REQUIRE(hash4 == ez::prng::djb2_32(std::wstring_view(name4, sizeof(name4) / sizeof(wchar_t) - 1)));
+
+	// Constexpr string_view test
+	static constexpr std::wstring_view cname4(name4, sizeof(name4) / sizeof(wchar_t) - 1);
+	static constexpr std::string_view cname5(name0, sizeof(name0) - 1);
+
+	static constexpr std::uint32_t constHash4 = ez::prng::djb2_32(cname4);
+	static constexpr std::uint32_t constHash5 = ez::prng::djb2_32(cname5);
+
+	REQUIRE(hash4 == constHash4);
+	REQUIRE(hash0 == constHash5);
+}
+
+TEST_CASE("djb2 64 bit") {
+	// Make sure the constexpr version of hash works:
+	static constexpr std::uint64_t constHash0 = ez::prng::djb2_64(name0);
+	static constexpr std::uint64_t constHash1 = ez::prng::djb2_64(name1);
+	static constexpr std::uint64_t constHash2 = ez::prng::djb2_64(name2);
+	static constexpr std::uint64_t constHash3 = ez::prng::djb2_64(name3);
+
+	std::uint64_t hash0 = ez::prng::djb2_64(name0, sizeof(name0) - 1);
+	std::uint64_t hash1 = ez::prng::djb2_64(name1, sizeof(name1) - 1);
+	std::uint64_t hash2 = ez::prng::djb2_64(name2, sizeof(name2) - 1);
+	std::uint64_t hash3 = ez::prng::djb2_64(name3, sizeof(name3) - 1);
+
+	REQUIRE(constHash0 == hash0);
+	REQUIRE(constHash1 == hash1);
+	REQUIRE(constHash2 == hash2);
+	REQUIRE(constHash3 == hash3);
+
+	std::uint64_t hash4 = ez::prng::djb2_64(name4, sizeof(name4) / sizeof(wchar_t) - 1);
+	std::uint64_t hash5 = ez::prng::djb2_64(name5, sizeof(name5) / sizeof(wchar_t) - 1);
+	std::uint64_t hash6 = ez::prng::djb2_64(name6, sizeof(name6) / sizeof(wchar_t) - 1);
+	REQUIRE(hash4 != hash5);
+	REQUIRE(hash5 != hash6);
+
+	static constexpr std::uint64_t hash7 = ez::prng::djb2_64(name4);
+	std::wstring name7 = name4;
+	std::uint64_t hash8 = ez::prng::djb2_64(name7);
+
+	REQUIRE(hash4 == hash7);
+	REQUIRE(hash4 == hash8);
+	REQUIRE(hash4 == ez::prng::djb2_64(std::wstring_view(name4, sizeof(name4) / sizeof(wchar_t) - 1)));
+
+	// Constexpr string_view test
+	static constexpr std::wstring_view cname4(name4, sizeof(name4) / sizeof(wchar_t) - 1);
+	static constexpr std::uint64_t constHash4 = ez::prng::djb2_64(cname4);
+
+	REQUIRE(hash4 == constHash4);
+}
+
+TEST_CASE("wyhash") {
+	// Reference vectors for wyhash final version 4, the seed is the index
+	const char* inputs[] = {
+		"",
+		"a",
+		"abc",
+		"message digest",
+		"abcdefghijklmnopqrstuvwxyz",
+		"ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789",
+		"12345678901234567890123456789012345678901234567890123456789012345678901234567890",
+	};
+	const std::uint64_t expected[] = {
+		0x93228a4de0eec5a2ull,
+		0xc5bac3db178713c4ull,
+		0xa97f2f7b1d9b3314ull,
+		0x786d1f1df3801df4ull,
+		0xdca5a8138ad37c87ull,
+		0xb9e734f117cfaf70ull,
+		0x6cc5eab49a92d617ull,
+	};
+	for (int i = 0; i < 7; ++i) {
+		REQUIRE(ez::prng::wyhash(std::string_view{ inputs[i] }, i) == expected[i]);
+	}
 
-		std::wstring name7 = name4;
+	// Compile time and run time agree
+	static constexpr std::uint64_t constHash0 = ez::prng::wyhash(name2);
+	static constexpr std::uint64_t constHash1 = ez::prng::wyhash(std::string_view{ "message digest" }, 3);
+	REQUIRE(constHash0 == ez::prng::wyhash(std::string{ name2 }));
+	REQUIRE(constHash0 == ez::prng::wyhash(static_cast<const void*>(name2), sizeof(name2) - 1));
+	REQUIRE(constHash1 == expected[3]);
+}
+
+TEST_CASE("incremental wyhash") {
+	std::mt19937 gen{ 17 };
+	std::vector<unsigned char> data(1000);
+	for (unsigned char& c : data) {
+		c = static_cast<unsigned char>(gen());
+	}
 
-		std::uint64_t hash8 = ez::prng::djb2_64(name7);
+	for (std::size_t length = 0; length <= data.size(); length += length < 200 ? 1 : 37) {
+		std::uint64_t expected = ez::prng::wyhash(data.data(), length, 42);
 
-		if (hash4 != hash7) {
-			fmt::print("Incorrect hash value\n");
-			return -1;
-		}
-		if (hash4 != hash8) {
-			fmt::print("Incorrect hash value\n");
-			return -1;
+		// Random chunk sizes, including empty ones
+		ez::prng::Wyhash state{ 42 };
+		std::size_t offset = 0;
+		while (offset < length) {
+			std::size_t chunk = std::min<std::size_t>(gen() % 100, length - offset);
+			state.update(data.data() + offset, chunk);
+			offset += chunk;
 		}
+		REQUIRE(state.digest() == expected);
 
-		if (hash4 != ez::prng::djb2_64(std::wstring_view(name4, sizeof(name4) / sizeof(wchar_t) - 1))) {
-			fmt::print("Incorrect hash value\n");
-			return -1;
-		}
-
-		// Constexpr string_view test
-		static constexpr std::wstring_view cname4(name4, sizeof(name4) / sizeof(wchar_t) - 1);
-		static constexpr std::uint64_t constHash4 = ez::prng::djb2_64(cname4);
-
-		std::uint64_t chash4 = constHash4;
-
-		if (hash4 != chash4) {
-			fmt::print("Incorrect hash value\n");
-			return -1;
+		// A single byte at a time
+		state.reset(42);
+		for (std::size_t i = 0; i < length; ++i) {
+			state.update(data.data() + i, 1);
 		}
+		REQUIRE(state.digest() == expected);
 	}
 
-	return 0;
+	ez::prng::Wyhash state;
+	state.update("message ");
+	state.update("digest");
+	REQUIRE(state.digest() == ez::prng::wyhash("message digest"));
 }
\ No newline at end of file
@@ -0,0 +1,149 @@
+#include <catch2/catch_all.hpp>
+
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <fmt/core.h>
+
+#include <ez/math/palette.hpp>
+
+using Approx = Catch::Approx;
+
+static const ez::ColorU primaries[] = {
+	ez::ColorU{ 0, 0, 0 },
+	ez::ColorU{ 255, 0, 0 },
+	ez::ColorU{ 0, 255, 0 },
+	ez::ColorU{ 0, 0, 255 },
+	ez::ColorU{ 255, 255, 255 },
+};
+
+// Random pixels clustered around the primaries
+static std::vector<ez::ColorU> clusteredPixels(std::size_t count, unsigned seed) {
+	std::mt19937 gen{ seed };
+	std::vector<ez::ColorU> pixels;
+	for (std::size_t i = 0; i < count; ++i) {
+		const ez::ColorU& base = primaries[gen() % 5];
+		ez::ColorU pixel;
+		for (int c = 0; c < 3; ++c) {
+			int noise = int(gen() % 17) - 8;
+			pixel[c] = uint8_t(std::max(0, std::min(int(base[c]) + noise, 255)));
+		}
+		pixels.push_back(pixel);
+	}
+	return pixels;
+}
+
+static int distanceSquared(const ez::ColorU& lh, const ez::ColorU& rh) {
+	int dist = 0;
+	for (int c = 0; c < 3; ++c) {
+		int d = int(lh[c]) - int(rh[c]);
+		dist += d * d;
+	}
+	return dist;
+}
+
+TEST_CASE("palette from colors") {
+	ez::ColorPalette palette{ primaries, 5 };
+	REQUIRE(palette.size() == 5);
+
+	for (int i = 0; i < 5; ++i) {
+		REQUIRE(palette.nearest(primaries[i]) == i);
+		REQUIRE(palette.lookup(primaries[i]) == i);
+	}
+
+	REQUIRE(palette.nearest(ez::ColorU{ 200, 30, 20 }) == 1);
+	REQUIRE(palette.nearest(ez::ColorU{ 220, 230, 210 }) == 4);
+}
+
+TEST_CASE("lookup cube agrees with nearest") {
+	std::mt19937 gen{ 7 };
+	std::vector<ez::ColorU> colors;
+	for (int i = 0; i < 64; ++i) {
+		colors.push_back(ez::ColorU{ uint8_t(gen() % 256), uint8_t(gen() % 256), uint8_t(gen() % 256) });
+	}
+	ez::ColorPalette palette{ colors.data(), colors.size() };
+
+	// The cube answers for the center of a cell, so it can only be off by the size of a cell
+	for (int i = 0; i < 10000; ++i) {
+		ez::ColorU color{ uint8_t(gen() % 256), uint8_t(gen() % 256), uint8_t(gen() % 256) };
+		int exact = distanceSquared(palette[palette.nearest(color)], color);
+		int cube = distanceSquared(palette[palette.lookup(color)], color);
+		REQUIRE(std::sqrt(float(cube)) <= std::sqrt(float(exact)) + 14.f);
+	}
+}
+
+TEST_CASE("median cut") {
+	std::vector<ez::ColorU> pixels = clusteredPixels(20000, 3);
+
+	ez::ColorPalette palette = ez::ColorPalette::medianCut(pixels.data(), pixels.size(), 5);
+	REQUIRE(palette.size() == 5);
+
+	// Each cluster should end up with its own entry, close to the center
+	for (const ez::ColorU& primary : primaries) {
+		REQUIRE(distanceSquared(palette[palette.nearest(primary)], primary) < 8 * 8);
+	}
+
+	// Refinement never makes the palette worse for these clusters
+	ez::ColorPalette refined = ez::ColorPalette::medianCut(pixels.data(), pixels.size(), 5, 4);
+	REQUIRE(refined.size() == 5);
+	for (const ez::ColorU& primary : primaries) {
+		REQUIRE(distanceSquared(refined[refined.nearest(primary)], primary) < 8 * 8);
+	}
+
+	// Fewer distinct colors than requested
+	ez::ColorPalette small = ez::ColorPalette::medianCut(primaries, 5, 256);
+	REQUIRE(small.size() == 5);
+
+	ez::ColorPalette none = ez::ColorPalette::medianCut(pixels.data(), 0, 16);
+	REQUIRE(none.empty());
+}
+
+TEST_CASE("quantize") {
+	std::vector<ez::ColorU> pixels = clusteredPixels(4096, 11);
+	ez::ColorPalette palette{ primaries, 5 };
+
+	std::vector<uint8_t> indices(pixels.size());
+	palette.quantize(pixels.data(), indices.data(), pixels.size());
+	for (std::size_t i = 0; i < pixels.size(); ++i) {
+		REQUIRE(indices[i] == palette.nearest(pixels[i]));
+	}
+
+	std::vector<uint8_t> image(pixels.size());
+	palette.quantize(pixels.data(), image.data(), 64, 64, ez::Dither::None);
+	REQUIRE(image == indices);
+}
+
+TEST_CASE("dithering") {
+	// A flat mid gray, halfway between black and white
+	std::size_t width = 64, height = 64;
+	std::vector<ez::ColorU> pixels(width * height, ez::ColorU{ 128, 128, 128 });
+
+	ez::ColorU bw[] = { ez::ColorU{ 0, 0, 0 }, ez::ColorU{ 255, 255, 255 } };
+	ez::ColorPalette palette{ bw, 2 };
+
+	for (ez::Dither dither : { ez::Dither::Ordered, ez::Dither::FloydSteinberg }) {
+		std::vector<uint8_t> indices(pixels.size());
+		palette.quantize(pixels.data(), indices.data(), width, height, dither);
+
+		// The average of the dithered image should be close to the original
+		double sum = 0.0;
+		for (uint8_t index : indices) {
+			REQUIRE(index < 2);
+			sum += palette[index].r;
+		}
+		REQUIRE(sum / double(indices.size()) == Approx(128.0).margin(8.0));
+	}
+
+	// The diffused error is rounded the same way whatever its sign, so the error diffusion keeps the average of any gray
+	for (int gray : { 64, 100, 200, 250 }) {
+		std::fill(pixels.begin(), pixels.end(), ez::ColorU{ uint8_t(gray), uint8_t(gray), uint8_t(gray) });
+		std::vector<uint8_t> indices(pixels.size());
+		palette.quantize(pixels.data(), indices.data(), width, height, ez::Dither::FloydSteinberg);
+
+		double sum = 0.0;
+		for (uint8_t index : indices) {
+			sum += palette[index].r;
+		}
+		REQUIRE(sum / double(indices.size()) == Approx(double(gray)).margin(1.5));
+	}
+}
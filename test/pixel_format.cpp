@@ -0,0 +1,140 @@
+#include <catch2/catch_all.hpp>
+
+#include <vector>
+#include <fmt/core.h>
+
+#include <ez/math/pixel_format.hpp>
+
+using PixelFormat = ez::PixelFormat;
+
+static std::vector<ez::ColorU> makePixels(std::size_t count) {
+	std::vector<ez::ColorU> pixels;
+	for (std::size_t i = 0; i < count; ++i) {
+		pixels.push_back(ez::ColorU{ uint8_t(i * 7), uint8_t(i * 13 + 1), uint8_t(i * 29 + 2), uint8_t(255 - i) });
+	}
+	return pixels;
+}
+
+TEST_CASE("byte aligned formats") {
+	// Not a multiple of any vector width, so the scalar tail is covered as well
+	auto pixels = makePixels(37);
+
+	std::vector<uint8_t> bgra(pixels.size() * 4);
+	ez::color::pack(pixels.data(), bgra.data(), PixelFormat::bgra8(), pixels.size());
+	for (std::size_t i = 0; i < pixels.size(); ++i) {
+		REQUIRE(bgra[i * 4 + 0] == pixels[i].b);
+		REQUIRE(bgra[i * 4 + 1] == pixels[i].g);
+		REQUIRE(bgra[i * 4 + 2] == pixels[i].r);
+		REQUIRE(bgra[i * 4 + 3] == pixels[i].a);
+
+		// Same layout as the ARGB words of Color::toU32, on little endian machines
+		uint32_t word = uint32_t(bgra[i * 4]) | (uint32_t(bgra[i * 4 + 1]) << 8) | (uint32_t(bgra[i * 4 + 2]) << 16) | (uint32_t(bgra[i * 4 + 3]) << 24);
+		REQUIRE(word == ez::ColorU::toU32(pixels[i]));
+	}
+
+	std::vector<uint8_t> argb(pixels.size() * 4);
+	ez::color::convertFormat(bgra.data(), PixelFormat::bgra8(), argb.data(), PixelFormat::argb8(), pixels.size());
+	for (std::size_t i = 0; i < pixels.size(); ++i) {
+		REQUIRE(argb[i * 4 + 0] == pixels[i].a);
+		REQUIRE(argb[i * 4 + 1] == pixels[i].r);
+		REQUIRE(argb[i * 4 + 2] == pixels[i].g);
+		REQUIRE(argb[i * 4 + 3] == pixels[i].b);
+	}
+
+	std::vector<ez::ColorU> unpacked(pixels.size());
+	ez::color::unpack(argb.data(), PixelFormat::argb8(), unpacked.data(), pixels.size());
+	REQUIRE(unpacked == pixels);
+}
+
+TEST_CASE("in place conversion") {
+	auto pixels = makePixels(53);
+	auto original = pixels;
+
+	ez::color::convertFormat(pixels.data(), PixelFormat::rgba8(), PixelFormat::abgr8(), pixels.size());
+	for (std::size_t i = 0; i < pixels.size(); ++i) {
+		REQUIRE(pixels[i] == ez::ColorU{ original[i].a, original[i].b, original[i].g, original[i].r });
+	}
+
+	ez::color::convertFormat(pixels.data(), PixelFormat::abgr8(), PixelFormat::rgba8(), pixels.size());
+	REQUIRE(pixels == original);
+}
+
+TEST_CASE("packed formats") {
+	ez::ColorU colors[] = {
+		{ 255, 0, 0, 255 },
+		{ 0, 255, 0, 255 },
+		{ 0, 0, 255, 0 },
+		{ 255, 255, 255, 255 },
+	};
+
+	uint16_t rgb565[4];
+	ez::color::pack(colors, rgb565, PixelFormat::rgb565(), 4);
+	REQUIRE(rgb565[0] == 0xF800);
+	REQUIRE(rgb565[1] == 0x07E0);
+	REQUIRE(rgb565[2] == 0x001F);
+	REQUIRE(rgb565[3] == 0xFFFF);
+
+	// No alpha channel, unpacks as opaque
+	ez::ColorU unpacked[4];
+	ez::color::unpack(rgb565, PixelFormat::rgb565(), unpacked, 4);
+	REQUIRE(unpacked[2] == ez::ColorU{ 0, 0, 255, 255 });
+
+	uint32_t rgb10a2[4];
+	ez::color::pack(colors, rgb10a2, PixelFormat::rgb10a2(), 4);
+	REQUIRE(rgb10a2[0] == 0xC000'03FFu);
+	REQUIRE(rgb10a2[2] == 0x3FF0'0000u);
+
+	ez::color::unpack(rgb10a2, PixelFormat::rgb10a2(), unpacked, 4);
+	for (int i = 0; i < 4; ++i) {
+		REQUIRE(unpacked[i] == colors[i]);
+	}
+
+	// Every 8 bit value survives a trip through 10 bits
+	auto pixels = makePixels(256);
+	std::vector<uint32_t> wide(pixels.size());
+	std::vector<ez::ColorU> back(pixels.size());
+	ez::color::pack(pixels.data(), wide.data(), PixelFormat::rgb10a2(), pixels.size());
+	ez::color::convertFormat(wide.data(), PixelFormat::rgb10a2(), back.data(), PixelFormat::rgba8(), pixels.size());
+	for (std::size_t i = 0; i < pixels.size(); ++i) {
+		REQUIRE(back[i].r == pixels[i].r);
+		REQUIRE(back[i].g == pixels[i].g);
+		REQUIRE(back[i].b == pixels[i].b);
+	}
+}
+
+
+TEST_CASE("packed format fast paths") {
+	// The dedicated rgba8 loops must match the general conversion for every channel value, and every packed value
+	std::vector<ez::ColorU> pixels;
+	for (int i = 0; i < 256; ++i) {
+		pixels.push_back(ez::ColorU{ uint8_t(i), uint8_t(255 - i), uint8_t(i * 7), uint8_t(i * 13) });
+	}
+	const uint8_t* bytes = reinterpret_cast<const uint8_t*>(pixels.data());
+
+	for (PixelFormat format : { PixelFormat::rgb565(), PixelFormat::rgb10a2() }) {
+		std::vector<uint8_t> fast(pixels.size() * format.size), slow(fast.size());
+		ez::color::pack(pixels.data(), fast.data(), format, pixels.size());
+		ez::color::intern::convertPixels(bytes, PixelFormat::rgba8(), slow.data(), format, pixels.size());
+		REQUIRE(fast == slow);
+	}
+
+	std::vector<uint16_t> words(1 << 16);
+	for (std::size_t i = 0; i < words.size(); ++i) {
+		words[i] = uint16_t(i);
+	}
+	std::vector<ez::ColorU> fast(words.size()), slow(words.size());
+	ez::color::unpack(words.data(), PixelFormat::rgb565(), fast.data(), words.size());
+	ez::color::intern::convertPixels(reinterpret_cast<const uint8_t*>(words.data()), PixelFormat::rgb565(), reinterpret_cast<uint8_t*>(slow.data()), PixelFormat::rgba8(), words.size());
+	REQUIRE(fast == slow);
+
+	// Covers every 10 bit value in each channel, and every alpha
+	std::vector<uint32_t> wide(1024 * 4);
+	for (uint32_t i = 0; i < wide.size(); ++i) {
+		wide[i] = (i & 1023u) | (((i * 7) & 1023u) << 10) | (((1023u - i) & 1023u) << 20) | ((i >> 10) << 30);
+	}
+	fast.resize(wide.size());
+	slow.resize(wide.size());
+	ez::color::unpack(wide.data(), PixelFormat::rgb10a2(), fast.data(), wide.size());
+	ez::color::intern::convertPixels(reinterpret_cast<const uint8_t*>(wide.data()), PixelFormat::rgb10a2(), reinterpret_cast<uint8_t*>(slow.data()), PixelFormat::rgba8(), wide.size());
+	REQUIRE(fast == slow);
+}
\ No newline at end of file
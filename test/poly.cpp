@@ -0,0 +1,98 @@
+#include <catch2/catch_all.hpp>
+
+#include <vector>
+#include <random>
+
+#include <ez/math/poly.hpp>
+
+using Approx = Catch::Approx;
+
+using Quadratic = ez::poly::Polynomial<double, 2>;
+using Cubic = ez::poly::Polynomial<double, 3>;
+
+// The arithmetic is usable at compile time
+static constexpr Quadratic square{ { 1.0, 2.0, 1.0 } };
+static constexpr ez::poly::Polynomial<double, 1> line{ { -1.0, 1.0 } };
+static_assert(square * line == Cubic{ { -1.0, -1.0, 1.0, 1.0 } });
+static_assert(square + line == Quadratic{ { 0.0, 3.0, 1.0 } });
+static_assert(square - square == ez::poly::Polynomial<double, 0>{ { 0.0 } });
+static_assert(square.derivative() == ez::poly::Polynomial<double, 1>{ { 2.0, 2.0 } });
+static_assert(square.integral(1.0).derivative() == square);
+static_assert(square(2.0) == 9.0);
+static_assert(square.evaluate(ez::poly::estrin, 2.0) == 9.0);
+
+TEST_CASE("polynomial arithmetic") {
+	Cubic p{ { 0.5, -1.0, 2.0, 3.0 } };
+	ez::poly::Polynomial<double, 2> q{ { 1.0, -2.0, 0.25 } };
+
+	for (double t : { -2.0, -0.5, 0.0, 0.75, 3.0 }) {
+		REQUIRE((p + q)(t) == Approx(p(t) + q(t)));
+		REQUIRE((p - q)(t) == Approx(p(t) - q(t)));
+		REQUIRE((p * q)(t) == Approx(p(t) * q(t)));
+		REQUIRE((p * 2.0)(t) == Approx(p(t) * 2.0));
+		REQUIRE((p / 4.0)(t) == Approx(p(t) / 4.0));
+
+		// Composition and taylor shift
+		REQUIRE(p.compose(q)(t) == Approx(p(q(t))));
+		REQUIRE(q.compose(p)(t) == Approx(q(p(t))));
+		REQUIRE(p.shift(1.5)(t) == Approx(p(t + 1.5)));
+
+		// Integral against the loose function, which takes the highest power first
+		REQUIRE(p.integral()(t) == Approx(ez::poly::evalIntegral(p[3], p[2], p[1], p[0], t)));
+		REQUIRE(p.derivative()(t) == Approx(ez::poly::derivativeAt(p[3], p[2], p[1], t)));
+		REQUIRE(p.derivativeAt(t) == Approx(p.derivative()(t)));
+	}
+}
+
+TEMPLATE_TEST_CASE("polynomial evaluation", "", float, double) {
+	using T = TestType;
+	std::mt19937 gen{ 77 };
+	std::uniform_real_distribution<T> dist{ T(-1), T(1) };
+
+	ez::poly::Polynomial<T, 9> p{};
+	for (T& c : p.coefficients) {
+		c = dist(gen);
+	}
+
+	std::vector<T> t(1001), horner(t.size()), estrin(t.size()), compensated(t.size());
+	for (std::size_t i = 0; i < t.size(); ++i) {
+		t[i] = T(-1.5) + T(3) * T(i) / T(t.size() - 1);
+	}
+	p.evaluate(t.data(), horner.data(), t.size());
+	p.evaluate(t.data(), estrin.data(), t.size(), ez::poly::estrin);
+	p.evaluate(t.data(), compensated.data(), t.size(), ez::poly::compensatedHorner);
+
+	for (std::size_t i = 0; i < t.size(); ++i) {
+		// Exact in long double, to well beyond the precision of T
+		long double exact = 0;
+		for (std::size_t k = p.coefficients.size(); k-- > 0;) {
+			exact = exact * (long double)t[i] + (long double)p[k];
+		}
+		long double scale = 0, power = 1;
+		for (std::size_t k = 0; k < p.coefficients.size(); ++k) {
+			scale += std::abs((long double)p[k]) * power;
+			power *= std::abs((long double)t[i]);
+		}
+		long double eps = std::numeric_limits<T>::epsilon();
+
+		// Not bitwise, the compiler is free to contract the vectorized loop differently
+		REQUIRE(horner[i] == Approx(p(t[i])));
+		REQUIRE(std::abs(horner[i] - exact) <= eps * scale * 10);
+		REQUIRE(std::abs(estrin[i] - exact) <= eps * scale * 10);
+#if !defined(__FAST_MATH__)
+		// Compensated is accurate to about one rounding of the result itself, no matter the cancellation
+		REQUIRE(std::abs(compensated[i] - exact) <= eps * std::abs(exact) + eps * eps * scale * 20);
+#else
+		REQUIRE(std::abs(compensated[i] - exact) <= eps * scale * 10);
+#endif
+	}
+
+	// Cancellation near a root of multiplicity 5, where horner loses most of its digits
+	ez::poly::Polynomial<T, 1> factor{ { T(-0.75), T(1) } };
+	auto root5 = factor * factor * factor * factor * factor;
+	T x = T(0.75) + (sizeof(T) == 4 ? T(0.05) : T(0.001));
+	long double exact = std::pow((long double)x - 0.75L, 5);
+#if !defined(__FAST_MATH__)
+	REQUIRE(std::abs(root5.evaluate(ez::poly::compensatedHorner, x) - exact) <= std::abs(exact) * 1E-3);
+#endif
+}
\ No newline at end of file
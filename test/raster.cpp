@@ -0,0 +1,170 @@
+#include <catch2/catch_all.hpp>
+
+#include <vector>
+#include <random>
+#include <algorithm>
+
+#include <ez/math/raster.hpp>
+#include <ez/math/trig.hpp>
+
+using Approx = Catch::Approx;
+
+// A jittered grid of quads, covering a little more than the image
+static std::vector<ez::RasterVertex> jitteredGrid(int width, int height, int cells, unsigned seed) {
+	std::mt19937 gen{ seed };
+	std::uniform_real_distribution<float> jitter{ -0.3f, 0.3f };
+
+	float cellX = float(width + 2) / float(cells), cellY = float(height + 2) / float(cells);
+	std::vector<glm::vec2> points;
+	for (int y = 0; y <= cells; ++y) {
+		for (int x = 0; x <= cells; ++x) {
+			bool border = x == 0 || y == 0 || x == cells || y == cells;
+			glm::vec2 offset = border ? glm::vec2(0.f) : glm::vec2(jitter(gen) * cellX, jitter(gen) * cellY);
+			points.push_back(glm::vec2(float(x) * cellX - 1.f, float(y) * cellY - 1.f) + offset);
+		}
+	}
+
+	std::vector<ez::RasterVertex> vertices;
+	auto vertex = [&](int x, int y) {
+		return ez::RasterVertex{ points[y * (cells + 1) + x], ez::ColorF{ 1.f, 1.f, 1.f, 1.f } };
+	};
+	for (int y = 0; y < cells; ++y) {
+		for (int x = 0; x < cells; ++x) {
+			vertices.push_back(vertex(x, y));
+			vertices.push_back(vertex(x + 1, y));
+			vertices.push_back(vertex(x + 1, y + 1));
+			// Opposite winding for the second half
+			vertices.push_back(vertex(x, y));
+			vertices.push_back(vertex(x, y + 1));
+			vertices.push_back(vertex(x + 1, y + 1));
+		}
+	}
+	return vertices;
+}
+
+TEST_CASE("raster shared edges") {
+	int width = 150, height = 110;
+	std::vector<ez::RasterVertex> vertices = jitteredGrid(width, height, 9, 1);
+
+	// Draw each triangle on its own, and count how often each pixel is hit
+	std::vector<int> hits(width * height, 0);
+	std::vector<ez::ColorU> image(width * height);
+	for (std::size_t t = 0; t < vertices.size(); t += 3) {
+		std::fill(image.begin(), image.end(), ez::ColorU{ 0, 0, 0, 0 });
+		ez::Rasterizer raster{ image.data(), width, height };
+		raster.add(vertices[t], vertices[t + 1], vertices[t + 2]);
+		raster.render();
+
+		for (std::size_t i = 0; i < image.size(); ++i) {
+			hits[i] += image[i].a == 255;
+		}
+	}
+
+	REQUIRE(std::all_of(hits.begin(), hits.end(), [](int count) { return count == 1; }));
+}
+
+TEST_CASE("raster interpolation") {
+	int width = 100, height = 80;
+	std::vector<ez::ColorU> image(width * height, ez::ColorU{ 0, 0, 0, 0 });
+
+	ez::RasterVertex a{ { 5.25f, 3.5f }, ez::ColorF{ 1.f, 0.f, 0.f, 1.f } };
+	ez::RasterVertex b{ { 90.75f, 20.f }, ez::ColorF{ 0.f, 1.f, 0.f, 1.f } };
+	ez::RasterVertex c{ { 30.f, 77.5f }, ez::ColorF{ 0.f, 0.f, 1.f, 1.f } };
+
+	ez::Rasterizer raster{ image.data(), width, height };
+	REQUIRE(raster.add(a, b, c));
+	raster.render();
+
+	for (int y = 0; y < height; ++y) {
+		for (int x = 0; x < width; ++x) {
+			glm::vec2 center{ float(x) + 0.5f, float(y) + 0.5f };
+			glm::vec3 weights = ez::trig::toBarycentric(center, a.position, b.position, c.position);
+			const ez::ColorU& pixel = image[y * width + x];
+
+			float smallest = std::min({ weights.x, weights.y, weights.z });
+			if (smallest > 1e-2f) {
+				REQUIRE(pixel.a == 255);
+				REQUIRE(std::abs(int(pixel.r) - int(weights.x * 255.f + 0.5f)) <= 1);
+				REQUIRE(std::abs(int(pixel.g) - int(weights.y * 255.f + 0.5f)) <= 1);
+				REQUIRE(std::abs(int(pixel.b) - int(weights.z * 255.f + 0.5f)) <= 1);
+			}
+			else if (smallest < -1e-2f) {
+				REQUIRE(pixel.a == 0);
+			}
+		}
+	}
+
+	// Degenerate and offscreen triangles are skipped
+	REQUIRE(!raster.add(a, b, a));
+	REQUIRE(!raster.add(
+		ez::RasterVertex{ { -50.f, -50.f }, ez::ColorF{} },
+		ez::RasterVertex{ { -10.f, -50.f }, ez::ColorF{} },
+		ez::RasterVertex{ { -10.f, -10.f }, ez::ColorF{} }));
+	REQUIRE(!raster.add(
+		ez::RasterVertex{ { 0.f, 0.f }, ez::ColorF{} },
+		ez::RasterVertex{ { 1e6f, 0.f }, ez::ColorF{} },
+		ez::RasterVertex{ { 0.f, 10.f }, ez::ColorF{} }));
+	REQUIRE(raster.size() == 1);
+}
+
+TEST_CASE("raster clipping and stride") {
+	int width = 70, height = 40, stride = 96;
+	ez::ColorU blank{ 1, 2, 3, 4 };
+	std::vector<ez::ColorU> image(stride * height, blank);
+
+	ez::Rasterizer raster{ image.data(), width, height, stride };
+	ez::ColorF white{ 1.f, 1.f, 1.f, 1.f };
+	REQUIRE(raster.add(
+		ez::RasterVertex{ { -100.f, -100.f }, white },
+		ez::RasterVertex{ { 500.f, -100.f }, white },
+		ez::RasterVertex{ { -100.f, 500.f }, white }));
+	raster.render();
+
+	for (int y = 0; y < height; ++y) {
+		for (int x = 0; x < stride; ++x) {
+			ez::ColorU expected = x < width ? ez::ColorU{ 255, 255, 255, 255 } : blank;
+			REQUIRE(image[y * stride + x] == expected);
+		}
+	}
+}
+
+static std::vector<ez::RasterVertex> triangleSoup(int width, int height, std::size_t count, float size, unsigned seed) {
+	std::mt19937 gen{ seed };
+	std::uniform_real_distribution<float> px{ -10.f, float(width) + 10.f }, py{ -10.f, float(height) + 10.f };
+	std::uniform_real_distribution<float> offset{ -size, size }, unit{ 0.f, 1.f };
+
+	std::vector<ez::RasterVertex> vertices;
+	for (std::size_t i = 0; i < count; ++i) {
+		glm::vec2 center{ px(gen), py(gen) };
+		for (int k = 0; k < 3; ++k) {
+			ez::ColorF color{ unit(gen), unit(gen), unit(gen), 1.f };
+			vertices.push_back(ez::RasterVertex{ center + glm::vec2(offset(gen), offset(gen)), color });
+		}
+	}
+	return vertices;
+}
+
+TEST_CASE("raster threads") {
+	int width = 300, height = 200;
+	std::vector<ez::RasterVertex> vertices = triangleSoup(width, height, 2000, 40.f, 5);
+
+	std::vector<ez::ColorU> single(width * height), threaded(width * height);
+	ez::Rasterizer raster{ single.data(), width, height };
+	raster.add(vertices.data(), vertices.size());
+	raster.render();
+
+	ez::Rasterizer parallel{ threaded.data(), width, height };
+	parallel.add(vertices.data(), vertices.size());
+	parallel.render(4);
+
+	REQUIRE(raster.size() > 1000);
+	REQUIRE(single == threaded);
+
+	// Later triangles overwrite earlier ones, in every bin
+	raster.clear();
+	REQUIRE(raster.size() == 0);
+	ez::ColorF red{ 1.f, 0.f, 0.f, 1.f };
+	raster.add(ez::RasterVertex{ { 0.f, 0.f }, red }, ez::RasterVertex{ { 1000.f, 0.f }, red }, ez::RasterVertex{ { 0.f, 1000.f }, red });
+	raster.render(3);
+	REQUIRE(std::all_of(single.begin(), single.end(), [](const ez::ColorU& color) { return color == ez::ColorU{ 255, 0, 0, 255 }; }));
+}
\ No newline at end of file
@@ -1,51 +1,277 @@
-#include <limits>
-#include <fmt/printf.h>
-#include <iostream>
-#include <ctime>
-
-#include <ez/math/complex.hpp>
-#include <ez/math/poly.hpp>
-#include <ez/math/constants.hpp>
-#include <ez/math/trig.hpp>
-#include <ez/math/prng.hpp>
+#include <catch2/catch_all.hpp>
 
-int rng_test() {
-	srand(static_cast<unsigned>(time(NULL)));
-	std::uint32_t rnum = rand();
+#include <vector>
+#include <fmt/core.h>
 
-	ez::prng::SplitMix64 smix{ rnum };
+#include <ez/math/prng.hpp>
 
-	ez::prng::XorShift128 xmix{
-		static_cast<std::uint32_t>(smix.advance()),
-		static_cast<std::uint32_t>(smix.advance()),
-		static_cast<std::uint32_t>(smix.advance()),
-		static_cast<std::uint32_t>(smix.advance())
-	};
+using Approx = Catch::Approx;
 
+TEST_CASE("rotations") {
 	std::uint8_t val0 = 1;
 	std::uint16_t val1 = 1;
 	std::uint32_t val2 = 0xF;
 	std::uint64_t val3 = 0xFF;
 
-	if (ez::prng::rotl8(val0, 1) != 2) {
-		fmt::print("Incorrect left rotation\n");
-		return -1;
+	REQUIRE(ez::prng::rotl8(val0, 1) == 2);
+	REQUIRE(ez::prng::rotr8(val0, 1) == 128);
+	REQUIRE(ez::prng::rotl16(val1, 15) == 0x8000);
+	REQUIRE(ez::prng::rotr16(val1, 1) == 0x8000);
+	REQUIRE(ez::prng::rotl32(val2, 8) == (0xFu << 8));
+	REQUIRE(ez::prng::rotr32(val2, 8) == (0xFu << 24));
+	REQUIRE(ez::prng::rotl64(val3, 60) == 0xF00000000000000Full);
+	REQUIRE(ez::prng::rotr64(val3, 4) == 0xF00000000000000Full);
+
+	// Rotating by zero or the full width does nothing
+	REQUIRE(ez::prng::rotl32(val2, 0) == val2);
+	REQUIRE(ez::prng::rotr64(val3, 64) == val3);
+}
+
+TEST_CASE("reference sequences") {
+	ez::prng::SplitMix64 smix{ 1234567 };
+	REQUIRE(smix.advance() == 6457827717110365317ull);
+	REQUIRE(smix.advance() == 3203168211198807973ull);
+	REQUIRE(smix.advance() == 9817491932198370423ull);
+
+	ez::prng::Xoshiro256ss xoshiro{ 1, 2, 3, 4 };
+	REQUIRE(xoshiro.advance() == 11520ull);
+	REQUIRE(xoshiro.advance() == 0ull);
+	REQUIRE(xoshiro.advance() == 1509978240ull);
+	REQUIRE(xoshiro.advance() == 1215971899390074240ull);
+
+	ez::prng::Xoroshiro128p xoroshiro{ 1, 2 };
+	REQUIRE(xoroshiro.advance() == 3ull);
+	REQUIRE(xoroshiro.advance() == 412333834243ull);
+	REQUIRE(xoroshiro.advance() == 2360170716294286339ull);
+
+	// Output of the reference pcg32-demo
+	ez::prng::Pcg32 pcg{ 42, 54 };
+	REQUIRE(pcg.advance() == 0xa15c02b7u);
+	REQUIRE(pcg.advance() == 0x7b47f409u);
+	REQUIRE(pcg.advance() == 0xba1d3330u);
+	REQUIRE(pcg.advance() == 0x83d2f293u);
+
+	ez::prng::SplitMix64 seeder{ 99 };
+	ez::prng::XorShift128 xmix{
+		static_cast<std::uint32_t>(seeder.advance()),
+		static_cast<std::uint32_t>(seeder.advance()),
+		static_cast<std::uint32_t>(seeder.advance()),
+		static_cast<std::uint32_t>(seeder.advance())
+	};
+	REQUIRE(xmix.advance() != xmix.advance());
+}
+
+template<typename Engine>
+static void requireSequentialFill(Engine engine) {
+	using T = typename Engine::result_type;
+
+	for (std::size_t count : { 0, 1, 7, 8, 9, 100, 1000 }) {
+		Engine sequential = engine;
+		std::vector<T> expected(count), filled(count);
+		for (T& value : expected) {
+			value = sequential.advance();
+		}
+		engine.fill(filled.data(), count);
+
+		REQUIRE(filled == expected);
+		REQUIRE(engine == sequential);
 	}
+}
+
+TEST_CASE("fill matches sequential output") {
+	requireSequentialFill(ez::prng::SplitMix64{ 5 });
+	requireSequentialFill(ez::prng::Pcg32{ 42, 54 });
+	requireSequentialFill(ez::prng::Pcg64{ 7 });
+}
+
+template<typename Engine>
+static void requireLaneFill(Engine engine) {
+	std::vector<std::uint64_t> values(1003);
 
-	if (ez::prng::rotr8(val0, 1) != 128) {
-		fmt::print("Incorrect right rotation\n");
-		return -1;
+	// The first lane continues the engine itself, after seeding the other lanes
+	Engine first = engine;
+	for (int k = 1; k < 8; ++k) {
+		first.advance();
 	}
+	engine.fill(values.data(), values.size());
+	for (std::size_t i = 0; i < values.size(); i += 8) {
+		REQUIRE(values[i] == first.advance());
+	}
+	REQUIRE(engine == first);
 
-	if (ez::prng::rotl32(val2, 8) != (0xFu << 8)) {
-		fmt::print("Incorrect left rotation\n");
-		return -1;
+	// The lanes are distinct streams
+	for (std::size_t k = 1; k < 8; ++k) {
+		REQUIRE(values[k] != values[0]);
+		REQUIRE(values[k + 8] != values[8]);
 	}
 
-	if (ez::prng::rotr32(val2, 8) != (0xFu << 24)) {
-		fmt::print("Incorrect right rotation\n");
-		return -1;
+	// Deterministic
+	std::vector<std::uint64_t> again(values.size());
+	Engine copy = engine;
+	engine.fill(values.data(), values.size());
+	copy.fill(again.data(), again.size());
+	REQUIRE(values == again);
+}
+
+TEST_CASE("lane fill") {
+	requireLaneFill(ez::prng::Xoshiro256ss{ 11 });
+	requireLaneFill(ez::prng::Xoroshiro128p{ 11 });
+}
+
+template<typename Engine>
+static void requireDiscard(Engine engine) {
+	for (std::uint64_t n : { 0, 1, 5, 127, 128, 300, 1000 }) {
+		Engine sequential = engine;
+		for (std::uint64_t i = 0; i < n; ++i) {
+			sequential.advance();
+		}
+		engine.discard(n);
+		REQUIRE(engine == sequential);
 	}
 
-	return 0;
+	// Large distances compose
+	Engine lh = engine, rh = engine;
+	lh.discard(0x123456789ABCull);
+	lh.discard(0xFEDCBA987654ull);
+	rh.discard(0x123456789ABCull + 0xFEDCBA987654ull);
+	REQUIRE(lh == rh);
+
+	// Jumps compose
+	lh = engine;
+	rh = engine;
+	lh.jump();
+	lh.jump();
+	lh.jump();
+	rh.jump(3);
+	REQUIRE(lh == rh);
+
+	// Substreams compose, and split hands out the same streams
+	REQUIRE(ez::prng::substream(engine, 0) == engine);
+	REQUIRE(ez::prng::substream(ez::prng::substream(engine, 1), 2) == ez::prng::substream(engine, 3));
+
+	Engine streams[4];
+	Engine base = engine;
+	ez::prng::split(base, streams, 4);
+	REQUIRE(streams[0] == engine);
+	REQUIRE(streams[3] == ez::prng::substream(engine, 3));
+	REQUIRE(base == ez::prng::substream(engine, 4));
+
+	lh = engine;
+	lh.longJump();
+	REQUIRE(lh != engine);
+}
+
+TEST_CASE("discard and jump") {
+	requireDiscard(ez::prng::SplitMix64{ 5 });
+	requireDiscard(ez::prng::XorShift128{});
+	requireDiscard(ez::prng::Xoshiro256ss{ 5 });
+	requireDiscard(ez::prng::Xoroshiro128p{ 5 });
+	requireDiscard(ez::prng::Pcg32{ 42, 54 });
+	requireDiscard(ez::prng::Pcg64{ 5 });
+
+	// SplitMix64 and PCG have a period of 2^64, and the jump is 2^32 steps
+	ez::prng::Pcg32 pcg{ 1 }, pcgJumped{ 1 };
+	pcgJumped.jump((std::uint64_t(1) << 32) - 1);
+	pcgJumped.jump();
+	REQUIRE(pcg == pcgJumped);
+
+	// The substreams of the xorshift family are one jump apart
+	ez::prng::Xoshiro256ss xoshiro{ 5 }, xoshiroJumped{ 5 };
+	xoshiroJumped.jump(3);
+	REQUIRE(ez::prng::substream(xoshiro, 3) == xoshiroJumped);
+
+	// SplitMix64 substreams are one long jump apart, far enough to not run into each other after 2^32 draws
+	ez::prng::SplitMix64 splitmix{ 5 }, splitmixJumped{ 5 };
+	splitmixJumped.longJump();
+	splitmixJumped.longJump();
+	REQUIRE(ez::prng::substream(splitmix, 2) == splitmixJumped);
+
+	// PCG substreams are separate sequences with their own increment, not windows of a single one
+	ez::prng::Pcg32 pcgStreams[3];
+	ez::prng::split(pcg, pcgStreams, 3);
+	REQUIRE(pcgStreams[0].increment != pcgStreams[1].increment);
+	REQUIRE(pcgStreams[1].increment != pcgStreams[2].increment);
+	REQUIRE(pcgStreams[0].increment % 2 == 1);
+	REQUIRE(pcgStreams[2].increment % 2 == 1);
+	REQUIRE(pcgStreams[0]() != pcgStreams[1]());
+	REQUIRE(pcgStreams[1]() != pcgStreams[2]());
+}
+
+TEST_CASE("jump polynomials") {
+	// The jump polynomials are derived from the engine, check them against the published constants
+	const auto& xoshiro = ez::prng::Xoshiro256ss::jumpTable();
+	const std::uint64_t xoshiroJump[] = { 0x180ec6d33cfd0abaull, 0xd5a61266f0c9392cull, 0xa9582618e03fc9aaull, 0x39abdc4529b1661cull };
+	const std::uint64_t xoshiroLongJump[] = { 0x76e15d3efefdcbbfull, 0xc5004e441c522fb3ull, 0x77710069854ee241ull, 0x39109bb02acbe635ull };
+	for (int i = 0; i < 4; ++i) {
+		REQUIRE(xoshiro.jump.bits[i] == xoshiroJump[i]);
+		REQUIRE(xoshiro.longJump.bits[i] == xoshiroLongJump[i]);
+	}
+
+	const auto& xoroshiro = ez::prng::Xoroshiro128p::jumpTable();
+	const std::uint64_t xoroshiroJump[] = { 0xdf900294d8f554a5ull, 0x170865df4b3201fcull };
+	const std::uint64_t xoroshiroLongJump[] = { 0xd2a98b26625eee7bull, 0xdddf9b1090aa7ac1ull };
+	for (int i = 0; i < 2; ++i) {
+		REQUIRE(xoroshiro.jump.bits[i] == xoroshiroJump[i]);
+		REQUIRE(xoroshiro.longJump.bits[i] == xoroshiroLongJump[i]);
+	}
+}
+
+TEST_CASE("philox") {
+	// Known answers from the Random123 distribution
+	using Counter = ez::prng::Philox4x32::Counter;
+	REQUIRE(ez::prng::Philox4x32{ 0u, 0u }(Counter{ 0u, 0u, 0u, 0u }) == Counter{ 0x6627e8d5u, 0xe169c58du, 0xbc57ac4cu, 0x9b00dbd8u });
+	REQUIRE(ez::prng::Philox4x32{ ~0u, ~0u }(Counter{ ~0u, ~0u, ~0u, ~0u }) == Counter{ 0x408f276du, 0x41c83b0eu, 0xa20bc7c6u, 0x6d5451fdu });
+	REQUIRE(
+		ez::prng::Philox4x32{ 0xa4093822u, 0x299f31d0u }(Counter{ 0x243f6a88u, 0x85a308d3u, 0x13198a2eu, 0x03707344u }) ==
+		Counter{ 0xd16cfe09u, 0x94fdccebu, 0x5001e420u, 0x24126ea1u });
+
+	static constexpr Counter constant = ez::prng::Philox4x32{ 7 }(std::uint64_t(3));
+	REQUIRE(constant == ez::prng::Philox4x32{ 7 }(Counter{ 3u, 0u, 0u, 0u }));
+
+	// Batch evaluation, including partial counters at the end
+	ez::prng::Philox4x32 gen{ 0x123456789ull };
+	for (std::size_t count : { 0, 1, 4, 6, 31, 32, 33, 1000 }) {
+		std::uint64_t first = 0xFFFFFFF0ull;
+		std::vector<std::uint32_t> values(count);
+		gen.fill(values.data(), count, first);
+		for (std::size_t i = 0; i < count; ++i) {
+			REQUIRE(values[i] == gen(first + i / 4)[i % 4]);
+		}
+	}
+}
+
+TEST_CASE("squares") {
+	ez::prng::Squares gen{ ez::prng::Squares::makeKey(1) };
+
+	// Keys have distinct nonzero digits in each half, and are odd
+	for (std::uint64_t seed = 0; seed < 100; ++seed) {
+		std::uint64_t key = ez::prng::Squares::makeKey(seed);
+		REQUIRE((key & 1u) == 1u);
+		for (int half = 0; half < 2; ++half) {
+			int seen = 0;
+			for (int digit = 0; digit < 8; ++digit) {
+				int value = int((key >> (half * 32 + digit * 4)) & 0xF);
+				REQUIRE(value != 0);
+				REQUIRE((seen & (1 << value)) == 0);
+				seen |= 1 << value;
+			}
+		}
+	}
+
+	std::vector<std::uint32_t> words(1003);
+	std::vector<std::uint64_t> wide(1003);
+	gen.fill(words.data(), words.size(), 500);
+	gen.fill(wide.data(), wide.size(), 500);
+
+	double bits = 0.0;
+	for (std::size_t i = 0; i < words.size(); ++i) {
+		REQUIRE(words[i] == gen(500 + i));
+		REQUIRE(wide[i] == gen.at64(500 + i));
+		REQUIRE(std::uint32_t(wide[i] >> 32) == words[i]);
+		for (int b = 0; b < 32; ++b) {
+			bits += (words[i] >> b) & 1u;
+		}
+	}
+	// Roughly half of the bits are set
+	REQUIRE(bits / double(words.size() * 32) == Approx(0.5).margin(0.01));
 }
\ No newline at end of file
@@ -4,6 +4,8 @@
 #include <fmt/core.h>
 #include <iostream>
 #include <ctime>
+#include <random>
+#include <algorithm>
 
 #include <ez/math/complex.hpp>
 #include <ez/math/poly.hpp>
@@ -137,12 +139,12 @@ TEST_CASE("second large quadratic test") {
 	REQUIRE(approxEq(roots[0], 0.5));
 }
 
-TEST_CASE("Cubic test 1") {
+TEMPLATE_TEST_CASE("Cubic test 1", "", ez::poly::Newton, ez::poly::Analytic) {
 	double co[4];
 	cubicFromRoots(-4.0, 0.0, 0.0, &co[0]);
 
 	std::array<double, 3> roots;
-	int count = ez::poly::solveCubic(co[0], co[1], co[2], co[3], roots.begin());
+	int count = ez::poly::solveCubic(TestType{}, co[0], co[1], co[2], co[3], roots.begin());
 	sort(roots, count);
 
 	int firstCount = count;
@@ -159,7 +161,7 @@ TEST_CASE("Cubic test 1") {
 		val *= 5.0;
 	}
 
-	count = ez::poly::solveCubic(co[0], co[1], co[2], co[3], roots.begin());
+	count = ez::poly::solveCubic(TestType{}, co[0], co[1], co[2], co[3], roots.begin());
 	sort(roots, count);
 
 	REQUIRE(firstCount == count);
@@ -168,12 +170,12 @@ TEST_CASE("Cubic test 1") {
 	}
 }
 
-TEST_CASE("Cubic test 2") {
+TEMPLATE_TEST_CASE("Cubic test 2", "", ez::poly::Newton, ez::poly::Analytic) {
 	double co[4];
 	cubicFromRoots(-1.863675860276, -0.01336237902, +2.677038239296, &co[0]);
 
 	std::array<double, 3> roots;
-	int count = ez::poly::solveCubic(co[0], co[1], co[2], co[3], roots.begin());
+	int count = ez::poly::solveCubic(TestType{}, co[0], co[1], co[2], co[3], roots.begin());
 
 	sort(roots, count);
 
@@ -184,16 +186,408 @@ TEST_CASE("Cubic test 2") {
 	REQUIRE(std::abs(ez::poly::evaluate(co[0], co[1], co[2], co[3], roots[2])) < 1E-12);
 }
 
-TEST_CASE("Cubic test 3") {
+TEMPLATE_TEST_CASE("Cubic test 3", "", ez::poly::Newton, ez::poly::Analytic) {
 	double co[4];
 	cubicFromRoots(1.0, 1.0, 1.0, &co[0]);
 
 	std::array<double, 3> roots;
-	int count = ez::poly::solveCubic(co[0], co[1], co[2], co[3], roots.begin());
+	int count = ez::poly::solveCubic(TestType{}, co[0], co[1], co[2], co[3], roots.begin());
 
 	sort(roots, count);
 
 	REQUIRE(count == 1);
 
 	REQUIRE(std::abs(ez::poly::evaluate(co[0], co[1], co[2], co[3], roots[0])) < 1E-12);
-}
\ No newline at end of file
+}
+
+TEMPLATE_TEST_CASE("Batch cubic roots", "", ez::poly::Newton, ez::poly::Analytic) {
+	// Enough polynomials to cover full blocks of lanes and a padded remainder
+	constexpr std::size_t count = 103;
+
+	std::array<double, count> a, b, c, d;
+	std::array<std::array<double, 3>, count> expected;
+	std::array<int, count> counts;
+	std::array<double, count * 3> roots;
+
+	std::mt19937 gen{ 1234 };
+	std::uniform_real_distribution<double> dist{ -4.0, 4.0 };
+	for (std::size_t i = 0; i < count; ++i) {
+		expected[i] = { dist(gen), dist(gen), dist(gen) };
+		std::sort(expected[i].begin(), expected[i].end());
+
+		double co[4];
+		cubicFromRoots(expected[i][0], expected[i][1], expected[i][2], &co[0]);
+		a[i] = co[0];
+		b[i] = co[1];
+		c[i] = co[2];
+		d[i] = co[3];
+	}
+	// Degenerate cases are handed off to the quadratic solver
+	a[7] = 0.0;
+	a[8] = 0.0; b[8] = 0.0;
+	// Small enough to pick the same newton starting point as solveCubic, which uses the linear solver threshold
+	b[9] = 5E-14;
+
+	ez::poly::solveCubicBatch(TestType{}, a.data(), b.data(), c.data(), d.data(), count, counts.data(), roots.data());
+
+	for (std::size_t i = 0; i < count; ++i) {
+		// The scalar newton solver is a separate implementation from the lanes of both policies
+		std::array<double, 3> reference;
+		int referenceCount = ez::poly::solveCubic(ez::poly::Newton{}, a[i], b[i], c[i], d[i], reference.begin());
+		REQUIRE(counts[i] == referenceCount);
+
+		// Newton finds the roots in no particular order
+		double* found = roots.data() + i * 3;
+		std::sort(found, found + counts[i]);
+		// Clamped so gcc can see the range stays inside the array, it warns with -Warray-bounds otherwise
+		std::sort(reference.begin(), reference.begin() + std::min<std::size_t>(referenceCount, reference.size()));
+		for (int k = 0; k < referenceCount; ++k) {
+			REQUIRE(found[k] == Approx(reference[k]).margin(1E-9));
+		}
+
+		// The roots the cubic was built from, when they are well separated and the coefficients were left alone
+		const std::array<double, 3>& r = expected[i];
+		if (i > 9 && r[1] - r[0] > 1E-2 && r[2] - r[1] > 1E-2) {
+			REQUIRE(counts[i] == 3);
+			for (int k = 0; k < 3; ++k) {
+				REQUIRE(found[k] == Approx(r[k]).margin(1E-8).epsilon(0));
+			}
+		}
+	}
+}
+
+
+TEST_CASE("Analytic cubic roots") {
+	std::mt19937 gen{ 4321 };
+	std::uniform_real_distribution<double> dist{ -10.0, 10.0 };
+
+	for (int i = 0; i < 200; ++i) {
+		std::array<double, 3> expected{ dist(gen), dist(gen), dist(gen) };
+		std::sort(expected.begin(), expected.end());
+		double r0 = expected[0], r1 = expected[1], r2 = expected[2];
+		double a = 1.0;
+		double b = -(r0 + r1 + r2);
+		double c = r0 * r1 + r0 * r2 + r1 * r2;
+		double d = -r0 * r1 * r2;
+
+		std::array<double, 3> roots;
+		int count = ez::poly::solveCubicAnalytic(a, b, c, d, roots.begin());
+
+		REQUIRE(count >= 1);
+		for (int k = 0; k < count; ++k) {
+			REQUIRE(std::abs(ez::poly::evaluate(a, b, c, d, roots[k])) < 1E-9);
+		}
+		for (int k = 1; k < count; ++k) {
+			REQUIRE(roots[k - 1] <= roots[k]);
+		}
+
+		// Well separated roots must all be found
+		if (r1 - r0 > 1E-2 && r2 - r1 > 1E-2) {
+			REQUIRE(count == 3);
+			for (int k = 0; k < 3; ++k) {
+				REQUIRE(roots[k] == Approx(expected[k]).margin(1E-8).epsilon(0));
+			}
+		}
+	}
+
+	// One real root, complex pair
+	std::array<float, 3> roots;
+	int count = ez::poly::solveCubicAnalytic(1.f, 0.f, 1.f, 2.f, roots.begin());
+	REQUIRE(count == 1);
+	REQUIRE(roots[0] == Approx(-1.f));
+}
+
+// Expands the product of (t - roots[i]) into ascending coefficients
+template<typename T, std::size_t N>
+ez::poly::Polynomial<T, N> polynomialFromRoots(const std::array<T, N>& roots) {
+	ez::poly::Polynomial<T, N> result{};
+	result[0] = T(1);
+	for (std::size_t i = 0; i < N; ++i) {
+		for (std::size_t k = i + 1; k > 0; --k) {
+			result[k] = result[k - 1] - roots[i] * result[k];
+		}
+		result[0] = -roots[i] * result[0];
+	}
+	return result;
+}
+
+// Random roots at least separation apart, with one of them doubled. They are not exactly representable,
+// so the coefficients round, and the double root is pulled apart or off the real line.
+template<typename T, std::size_t N>
+void requireRepeatedRoots(std::mt19937& gen, T separation, T margin) {
+	std::uniform_real_distribution<T> dist{ T(-3), T(3) };
+
+	for (int i = 0; i < 200; ++i) {
+		std::array<T, N - 1> expected;
+		bool separated = false;
+		while (!separated) {
+			for (T& root : expected) {
+				root = dist(gen);
+			}
+			std::sort(expected.begin(), expected.end());
+			separated = true;
+			for (std::size_t k = 1; k < expected.size(); ++k) {
+				separated = separated && expected[k] - expected[k - 1] >= separation;
+			}
+		}
+		std::array<T, N> all;
+		std::copy(expected.begin(), expected.end(), all.begin());
+		all[N - 1] = expected[gen() % expected.size()];
+		ez::poly::Polynomial<T, N> p = polynomialFromRoots(all);
+
+		std::array<T, N> roots;
+		int count = N == 4 ? ez::poly::solveQuartic(p[4], p[3], p[2], p[1], p[0], roots.begin()) : p.solve(roots.begin());
+		REQUIRE(count == int(expected.size()));
+		for (std::size_t k = 0; k < expected.size(); ++k) {
+			REQUIRE(roots[k] == Approx(expected[k]).margin(margin));
+		}
+	}
+}
+
+TEST_CASE("Quartic roots") {
+	std::mt19937 gen{ 999 };
+	std::uniform_real_distribution<double> dist{ -5.0, 5.0 };
+
+	for (int i = 0; i < 200; ++i) {
+		std::array<double, 4> expected{ dist(gen), dist(gen), dist(gen), dist(gen) };
+		std::sort(expected.begin(), expected.end());
+		ez::poly::Polynomial<double, 4> p = polynomialFromRoots(expected);
+
+		std::array<double, 4> roots;
+		int count = ez::poly::solveQuartic(p[4], p[3], p[2], p[1], p[0], roots.begin());
+
+		// Random roots closer than the duplicate tolerance are merged
+		REQUIRE(count >= 1);
+		for (int k = 0; k < count; ++k) {
+			REQUIRE(std::abs(p(roots[k])) < 1E-9);
+		}
+		for (int k = 1; k < count; ++k) {
+			REQUIRE(roots[k - 1] < roots[k]);
+		}
+
+		// Well separated roots must all be found
+		bool separated = true;
+		for (int k = 1; k < 4; ++k) {
+			separated = separated && expected[k] - expected[k - 1] > 1E-2;
+		}
+		if (separated) {
+			REQUIRE(count == 4);
+		}
+		if (count == 4) {
+			for (int k = 0; k < 4; ++k) {
+				REQUIRE(roots[k] == Approx(expected[k]).margin(1E-8).epsilon(0));
+			}
+		}
+	}
+
+	std::array<double, 4> roots;
+
+	// Double roots that rounding pulls apart
+	requireRepeatedRoots<double, 4>(gen, 5E-2, 1E-6);
+
+	// Two double roots, (t - 1)^2 (t - 2)^2
+	int count = ez::poly::solveQuartic(1.0, -6.0, 13.0, -12.0, 4.0, roots.begin());
+	REQUIRE(count == 2);
+	REQUIRE(roots[0] == Approx(1.0).margin(1E-7));
+	REQUIRE(roots[1] == Approx(2.0).margin(1E-7));
+
+	// Biquadratic, t^4 - 5t^2 + 4
+	count = ez::poly::solveQuartic(1.0, 0.0, -5.0, 0.0, 4.0, roots.begin());
+	REQUIRE(count == 4);
+	REQUIRE(roots[0] == Approx(-2.0));
+	REQUIRE(roots[1] == Approx(-1.0));
+	REQUIRE(roots[2] == Approx(1.0));
+	REQUIRE(roots[3] == Approx(2.0));
+
+	// No real roots, t^4 + 1
+	REQUIRE(ez::poly::solveQuartic(1.0, 0.0, 0.0, 0.0, 1.0, roots.begin()) == 0);
+
+	// Degenerate to a cubic
+	count = ez::poly::solveQuartic(0.0, 1.0, 0.0, -1.0, 0.0, roots.begin());
+	REQUIRE(count == 3);
+	REQUIRE(roots[0] == Approx(-1.0));
+	REQUIRE(roots[1] == Approx(0.0).margin(1E-12));
+	REQUIRE(roots[2] == Approx(1.0));
+}
+
+TEMPLATE_TEST_CASE("Polynomial roots", "", float, double) {
+	using T = TestType;
+	T tolerance = sizeof(T) == 4 ? T(1E-3) : T(1E-9);
+
+	std::mt19937 gen{ 2468 };
+	std::uniform_real_distribution<T> dist{ T(-3), T(3) };
+
+	// Degree 7, well separated roots
+	for (int i = 0; i < 100; ++i) {
+		std::array<T, 7> expected;
+		for (std::size_t k = 0; k < expected.size(); ++k) {
+			expected[k] = T(k) - T(3) + dist(gen) * T(0.1);
+		}
+		ez::poly::Polynomial<T, 7> p = polynomialFromRoots(expected);
+
+		std::array<T, 7> roots;
+		REQUIRE(p.solve(roots.begin()) == 7);
+		for (std::size_t k = 0; k < expected.size(); ++k) {
+			REQUIRE(roots[k] == Approx(expected[k]).margin(tolerance));
+		}
+
+		// Only the roots in [-1, 1]
+		int count = p.solveInRange(T(-1), T(1), roots.begin());
+		int inside = int(std::count_if(expected.begin(), expected.end(), [](T root) { return root >= T(-1) && root <= T(1); }));
+		REQUIRE(count == inside);
+		for (int k = 0; k < count; ++k) {
+			REQUIRE(roots[k] >= T(-1));
+			REQUIRE(roots[k] <= T(1));
+		}
+	}
+
+	// Repeated roots, (t - 1)^3 (t + 2)^2 (t - 0.5)
+	ez::poly::Polynomial<T, 6> repeated = polynomialFromRoots(std::array<T, 6>{ T(1), T(1), T(1), T(-2), T(-2), T(0.5) });
+	std::array<T, 6> roots;
+	REQUIRE(repeated.solve(roots.begin()) == 3);
+	REQUIRE(roots[0] == Approx(T(-2)).margin(tolerance));
+	REQUIRE(roots[1] == Approx(T(0.5)).margin(tolerance));
+	REQUIRE(roots[2] == Approx(T(1)).margin(sizeof(T) == 4 ? T(1E-2) : T(1E-5)));
+
+	// Repeated roots where the value is exactly zero, next to a simple root
+	// t^2 (t + 2)^3 (t - 2)
+	repeated = polynomialFromRoots(std::array<T, 6>{ T(0), T(0), T(-2), T(-2), T(-2), T(2) });
+	REQUIRE(repeated.solve(roots.begin()) == 3);
+	REQUIRE(roots[0] == Approx(T(-2)).margin(T(1E-3)));
+	REQUIRE(roots[1] == Approx(T(0)).margin(T(1E-6)));
+	REQUIRE(roots[2] == Approx(T(2)).margin(tolerance));
+
+	// t^2 (t - 1.5)^4
+	repeated = polynomialFromRoots(std::array<T, 6>{ T(0), T(0), T(1.5), T(1.5), T(1.5), T(1.5) });
+	REQUIRE(repeated.solve(roots.begin()) == 2);
+	REQUIRE(roots[0] == Approx(T(0)).margin(T(1E-6)));
+	REQUIRE(roots[1] == Approx(T(1.5)).margin(T(1E-2)));
+
+	// (t - 0.5)^2 (t - 2) (t + 0.25)^2 (t - 1)
+	repeated = polynomialFromRoots(std::array<T, 6>{ T(0.5), T(0.5), T(2), T(-0.25), T(-0.25), T(1) });
+	REQUIRE(repeated.solve(roots.begin()) == 4);
+	REQUIRE(roots[0] == Approx(T(-0.25)).margin(T(1E-3)));
+	REQUIRE(roots[1] == Approx(T(0.5)).margin(T(1E-3)));
+	REQUIRE(roots[2] == Approx(T(1)).margin(tolerance));
+	REQUIRE(roots[3] == Approx(T(2)).margin(tolerance));
+
+	// Double roots that rounding pulls apart, float needs them further apart to tell them from close simple roots
+	T separation = sizeof(T) == 4 ? T(0.5) : T(5E-2);
+	T margin = sizeof(T) == 4 ? T(1E-3) : T(1E-6);
+	requireRepeatedRoots<T, 5>(gen, separation, margin);
+	requireRepeatedRoots<T, 6>(gen, separation, margin);
+	requireRepeatedRoots<T, 7>(gen, separation, margin);
+	requireRepeatedRoots<T, 8>(gen, separation, margin);
+
+	// No real roots, and a zero leading coefficient
+	ez::poly::Polynomial<T, 4> none{ { T(1), T(0), T(2), T(0), T(1) } };
+	REQUIRE(none.solve(roots.begin()) == 0);
+	ez::poly::Polynomial<T, 5> lower{ { T(-2), T(1), T(0), T(0), T(0), T(0) } };
+	REQUIRE(lower.solve(roots.begin()) == 1);
+	REQUIRE(roots[0] == Approx(T(2)));
+	REQUIRE(ez::poly::Polynomial<T, 3>{}.solve(roots.begin()) == 0);
+
+	// Derivative
+	ez::poly::Polynomial<T, 2> derivative = ez::poly::Polynomial<T, 3>{ { T(1), T(2), T(3), T(4) } }.derivative();
+	REQUIRE(derivative[0] == T(2));
+	REQUIRE(derivative[1] == T(6));
+	REQUIRE(derivative[2] == T(12));
+}
+
+TEST_CASE("Roots in range") {
+	std::mt19937 gen{ 1357 };
+	std::uniform_real_distribution<double> dist{ -2.0, 2.0 };
+
+	for (int i = 0; i < 2000; ++i) {
+		double a = dist(gen), b = dist(gen), c = dist(gen), d = dist(gen);
+		double lo = dist(gen), hi = lo + std::abs(dist(gen));
+
+		// Every root in range, from the unrestricted solvers
+		std::array<double, 3> all;
+		int numAll = ez::poly::solveCubicAnalytic(a, b, c, d, all.begin());
+		std::vector<double> expected;
+		std::copy_if(all.begin(), all.begin() + numAll, std::back_inserter(expected), [&](double x) { return x >= lo && x <= hi; });
+
+		std::array<double, 3> roots;
+		int count = ez::poly::solveCubicInRange(a, b, c, d, lo, hi, roots.begin());
+		REQUIRE(count == int(expected.size()));
+		for (int k = 0; k < count; ++k) {
+			REQUIRE(roots[k] == Approx(expected[k]).margin(1E-9));
+		}
+
+		numAll = ez::poly::solveQuadratic(a, b, c, all.begin());
+		expected.clear();
+		std::copy_if(all.begin(), all.begin() + numAll, std::back_inserter(expected), [&](double x) { return x >= lo && x <= hi; });
+
+		count = ez::poly::solveQuadraticInRange(a, b, c, lo, hi, roots.begin());
+		REQUIRE(count == int(expected.size()));
+		for (int k = 0; k < count; ++k) {
+			REQUIRE(roots[k] == Approx(expected[k]).margin(1E-9));
+		}
+	}
+
+	std::array<float, 3> roots;
+
+	// Roots on the boundary are included, t (t - 0.5) (t - 1)
+	REQUIRE(ez::poly::solveCubicInRange(1.f, -1.5f, 0.5f, 0.f, 0.f, 1.f, roots.begin()) == 3);
+	REQUIRE(roots[0] == 0.f);
+	REQUIRE(roots[1] == Approx(0.5f));
+	REQUIRE(roots[2] == 1.f);
+
+	// Double root at a critical point, (t - 0.25)^2 (t + 3)
+	REQUIRE(ez::poly::solveCubicInRange(1.f, 2.5f, -1.4375f, 0.1875f, 0.f, 1.f, roots.begin()) == 1);
+	REQUIRE(roots[0] == Approx(0.25f).margin(1E-3));
+
+	// Rejected by the bound, and an empty range
+	REQUIRE(ez::poly::solveCubicInRange(1.f, 0.f, 0.f, -8.f, 0.f, 1.f, roots.begin()) == 0);
+	REQUIRE(ez::poly::solveQuadraticInRange(1.f, 0.f, -4.f, 0.f, 1.f, roots.begin()) == 0);
+	REQUIRE(ez::poly::solveCubicInRange(1.f, 0.f, 0.f, -8.f, 1.f, 0.f, roots.begin()) == 0);
+}
+
+TEMPLATE_TEST_CASE("Polynomial roots on the range ends", "", float, double) {
+	using T = TestType;
+
+	// t (t - 0.5) (t - 1), with roots on both ends of [0, 1]
+	ez::poly::Polynomial<T, 3> cubic = polynomialFromRoots(std::array<T, 3>{ T(0), T(0.5), T(1) });
+	std::array<T, 8> roots;
+	REQUIRE(cubic.solveInRange(T(0), T(1), roots.begin()) == 3);
+	REQUIRE(roots[0] == T(0));
+	REQUIRE(roots[1] == Approx(T(0.5)));
+	REQUIRE(roots[2] == T(1));
+
+	// Just past a root at either end there is nothing
+	REQUIRE(cubic.solveInRange(T(0.6), T(0.99), roots.begin()) == 0);
+	REQUIRE(cubic.solveInRange(T(-1), T(-0.01), roots.begin()) == 0);
+
+	// A distinct root close to a root on the end is kept, t (t - 1e-4) and t (t - 1e-9)
+	ez::poly::Polynomial<T, 2> close{ { T(0), T(-1E-4), T(1) } };
+	REQUIRE(close.solveInRange(T(0), T(1), roots.begin()) == 2);
+	REQUIRE(roots[0] == T(0));
+	REQUIRE(roots[1] == Approx(T(1E-4)).epsilon(1E-5));
+	REQUIRE(close.solveInRange(T(-1), T(0), roots.begin()) == 1);
+	REQUIRE(roots[0] == T(0));
+
+	if constexpr (std::is_same_v<T, double>) {
+		close = ez::poly::Polynomial<T, 2>{ { T(0), T(-1E-9), T(1) } };
+		REQUIRE(close.solveInRange(T(0), T(1), roots.begin()) == 2);
+		REQUIRE(roots[0] == T(0));
+		REQUIRE(roots[1] == Approx(T(1E-9)).epsilon(1E-9));
+	}
+
+	// Roots 1 to 8, ranges ending on them and a range of a single point
+	ez::poly::Polynomial<T, 8> wide = polynomialFromRoots(std::array<T, 8>{ T(1), T(2), T(3), T(4), T(5), T(6), T(7), T(8) });
+	REQUIRE(wide.solveInRange(T(5), T(6), roots.begin()) == 2);
+	REQUIRE(roots[0] == Approx(T(5)).margin(T(1E-5)));
+	REQUIRE(roots[1] == Approx(T(6)).margin(T(1E-5)));
+
+	REQUIRE(wide.solveInRange(T(1), T(8), roots.begin()) == 8);
+	for (int k = 0; k < 8; ++k) {
+		REQUIRE(roots[k] == Approx(T(k + 1)).margin(T(1E-3)));
+	}
+	REQUIRE(roots[0] >= T(1));
+	REQUIRE(roots[7] <= T(8));
+
+	REQUIRE(wide.solveInRange(T(3), T(3), roots.begin()) == 1);
+	REQUIRE(roots[0] == T(3));
+	REQUIRE(wide.solveInRange(T(3.5), T(3.5), roots.begin()) == 0);
+}
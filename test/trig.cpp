@@ -1,6 +1,9 @@
 #include <catch2/catch_all.hpp>
 
 #include <limits>
+#include <vector>
+#include <random>
+#include <cmath>
 #include <fmt/printf.h>
 #include <iostream>
 #include <ctime>
@@ -28,6 +31,79 @@ TEST_CASE("angles test") {
 	REQUIRE(standard == Approx(ez::pi<float>() * 1.5f));
 }
 
+template<typename T>
+static void checkAngleReduction(T limit) {
+	std::mt19937_64 gen{ 7 };
+	std::uniform_real_distribution<T> dist{ -limit, limit };
+
+	std::vector<T> angles;
+	for (int i = 0; i < 10000; ++i) {
+		angles.push_back(dist(gen));
+	}
+	for (int i = -64; i <= 64; ++i) {
+		T boundary = ez::pi<T>() * T(i);
+		angles.push_back(boundary);
+		angles.push_back(std::nextafter(boundary, T(-1e30)));
+		angles.push_back(std::nextafter(boundary, T(1e30)));
+	}
+	angles.push_back(T(0));
+	angles.push_back(T(-0.0));
+	angles.push_back(T(1e12));
+	angles.push_back(T(-1e12));
+
+	std::vector<T> standard(angles.size()), normal(angles.size());
+	ez::trig::standardPosition(angles.data(), standard.data(), angles.size());
+	ez::trig::normalizeAngle(angles.data(), normal.data(), angles.size());
+
+	constexpr T tau = ez::tau<T>();
+	for (std::size_t i = 0; i < angles.size(); ++i) {
+		T angle = angles[i];
+		T s = standard[i];
+		T n = normal[i];
+
+		REQUIRE(s == ez::trig::standardPosition(angle));
+		REQUIRE(n == ez::trig::normalizeAngle(angle));
+		REQUIRE(s >= T(0));
+		REQUIRE(s < tau);
+		REQUIRE(n >= -ez::pi<T>());
+		REQUIRE(n < ez::pi<T>());
+
+		// Within an ulp of fmod, modulo the wrap around at the ends of the range
+		T expected = std::fmod(angle, tau);
+		expected += expected < T(0) ? tau : T(0);
+		T diff = std::abs(s - expected);
+		diff = std::min(diff, std::abs(diff - tau));
+		REQUIRE(diff <= std::nextafter(tau, T(10)) - tau);
+
+		T centered = n < T(0) ? n + tau : n;
+		diff = std::abs(centered - expected);
+		diff = std::min(diff, std::abs(diff - tau));
+		REQUIRE(diff <= std::nextafter(tau, T(10)) - tau);
+	}
+}
+
+TEST_CASE("angle reduction") {
+	checkAngleReduction<float>(1e5f);
+	checkAngleReduction<double>(1e7);
+
+	// The vector overloads use the same kernel
+	glm::vec3 angles{ -ez::pi<float>() * 2.5f, ez::pi<float>() * 3.5f, 1.f };
+	glm::vec3 norm = ez::trig::normalizeAngle(angles);
+	glm::vec3 standard = ez::trig::standardPosition(angles);
+	for (int i = 0; i < 3; ++i) {
+		REQUIRE(norm[i] == ez::trig::normalizeAngle(angles[i]));
+		REQUIRE(standard[i] == ez::trig::standardPosition(angles[i]));
+	}
+	REQUIRE(norm[0] == Approx(-ez::half_pi<float>()));
+	REQUIRE(standard[1] == Approx(ez::pi<float>() * 1.5f));
+
+#if !defined(__FAST_MATH__)
+	// Non finite input gives nan, same as fmod. Fast math assumes there is no such input.
+	REQUIRE(std::isnan(ez::trig::standardPosition(std::numeric_limits<double>::infinity())));
+	REQUIRE(std::isnan(ez::trig::normalizeAngle(std::numeric_limits<float>::quiet_NaN())));
+#endif
+}
+
 TEST_CASE("Law of cosines") {
 	float a = 8.f;
 	float b = 11.f;
@@ -49,4 +125,72 @@ TEST_CASE("radians and degrees") {
 	REQUIRE(ez::degrees(ez::pi<float>()) == Approx(180));
 
 	REQUIRE(ez::degrees(ez::tau<float>()) == Approx(360));
+}
+
+TEST_CASE("barycentric setup") {
+	glm::vec2 a{ 1.f, 1.f }, b{ 5.f, 2.f }, c{ 2.f, 6.f };
+	ez::trig::BarycentricSetup<float, 2> setup{ a, b, c };
+	REQUIRE(!setup.degenerate());
+
+	std::mt19937 gen{ 3 };
+	std::uniform_real_distribution<float> dist{ -2.f, 8.f };
+
+	std::vector<glm::vec2> points;
+	std::vector<float> xs, ys;
+	for (int i = 0; i < 1000; ++i) {
+		points.emplace_back(dist(gen), dist(gen));
+		xs.push_back(points.back().x);
+		ys.push_back(points.back().y);
+	}
+	points.push_back(a);
+	xs.push_back(a.x);
+	ys.push_back(a.y);
+
+	std::vector<glm::vec3> coords(points.size());
+	setup.toBarycentric(points.data(), coords.data(), points.size());
+
+	std::vector<float> u(points.size()), v(points.size()), w(points.size());
+	std::vector<std::uint8_t> inside(points.size());
+	setup.toBarycentric({ xs.data(), ys.data() }, u.data(), v.data(), w.data(), inside.data(), points.size());
+
+	std::size_t insideCount = 0;
+	for (std::size_t i = 0; i < points.size(); ++i) {
+		glm::vec3 expected = ez::trig::toBarycentric(points[i], a, b, c);
+		REQUIRE(coords[i].x == Approx(expected.x).margin(1e-5));
+		REQUIRE(coords[i].y == Approx(expected.y).margin(1e-5));
+		REQUIRE(coords[i].z == Approx(expected.z).margin(1e-5));
+
+		REQUIRE(u[i] == Approx(coords[i].x).margin(1e-6));
+		REQUIRE(v[i] == Approx(coords[i].y).margin(1e-6));
+		REQUIRE(w[i] == Approx(coords[i].z).margin(1e-6));
+
+		bool expectInside = u[i] >= 0.f && v[i] >= 0.f && w[i] >= 0.f;
+		REQUIRE(bool(inside[i]) == expectInside);
+		insideCount += inside[i];
+	}
+	// The triangle covers 15.5 / 100 of the sampled square
+	REQUIRE(insideCount > 100);
+	REQUIRE(insideCount < 220);
+	REQUIRE(inside.back() == 1);
+
+	// Round trip, through both layouts
+	std::vector<float> rx(points.size()), ry(points.size());
+	setup.fromBarycentric(u.data(), v.data(), w.data(), { rx.data(), ry.data() }, points.size());
+	std::vector<glm::vec2> back(points.size());
+	setup.fromBarycentric(coords.data(), back.data(), points.size());
+	for (std::size_t i = 0; i < points.size(); ++i) {
+		REQUIRE(rx[i] == Approx(points[i].x).margin(1e-4));
+		REQUIRE(ry[i] == Approx(points[i].y).margin(1e-4));
+		REQUIRE(back[i].x == Approx(points[i].x).margin(1e-4));
+		REQUIRE(back[i].y == Approx(points[i].y).margin(1e-4));
+	}
+
+	// In 3d points off the plane project onto it
+	ez::trig::BarycentricSetup<double, 3> setup3{ glm::dvec3{ 0, 0, 0 }, glm::dvec3{ 1, 0, 0 }, glm::dvec3{ 0, 1, 0 } };
+	glm::dvec3 coords3 = setup3.toBarycentric(glm::dvec3{ 0.25, 0.5, 3.0 });
+	REQUIRE(coords3.x == Approx(0.25));
+	REQUIRE(coords3.y == Approx(0.25));
+	REQUIRE(coords3.z == Approx(0.5));
+
+	REQUIRE(ez::trig::BarycentricSetup<float, 2>{ a, b, a + (b - a) * 2.f }.degenerate());
 }
\ No newline at end of file